@@ -0,0 +1,4 @@
+/* autogenerated at build time */
+static const signed char g_apparmor_data[]= {
+};
+static const size_t g_apparmor_data_len = sizeof(g_apparmor_data);
@@ -0,0 +1,322 @@
+/*
+ * Copyright (C) 2026 Colin Ian King.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include "stress-ng.h"
+#include "core-baseline.h"
+#include "core-builtin.h"
+
+#include <math.h>
+
+#define BASELINE_THRESHOLD_DEFAULT	(5.0)	/* default regression threshold, % */
+
+#define BASELINE_NEUTRAL		(0)	/* metric is reported, not checked */
+#define BASELINE_HIGHER_IS_BETTER	(1)
+#define BASELINE_LOWER_IS_BETTER	(-1)
+
+/* Per stressor metric from a --baseline YAML file */
+typedef struct stress_baseline {
+	struct stress_baseline *next;	/* next metric in list */
+	char *stressor;			/* stressor name */
+	char *key;			/* YAML metric key */
+	double baseline;		/* value from baseline file */
+	double current;			/* value from this run */
+	bool matched;			/* true if found in this run */
+} stress_baseline_t;
+
+static stress_baseline_t *baseline_head;
+static stress_baseline_t *baseline_tail;
+static const char *baseline_filename;
+static double baseline_threshold = BASELINE_THRESHOLD_DEFAULT;
+
+/*
+ *  stress_baseline_direction()
+ *	determine if a larger or smaller metric value is better
+ *	from the metric key name; rates are higher-is-better and
+ *	latencies are lower-is-better, anything else such as
+ *	bogo-op counts, run times and RSS is just reported
+ */
+static int stress_baseline_direction(const char *key)
+{
+	static const char * const higher[] = {
+		"per-second", "per-sec", "bandwidth", "throughput", "-rate", "rate-",
+	};
+	static const char * const lower[] = {
+		"nsec", "nanosec", "usec", "microsec", "msec", "millisec", "latency",
+	};
+	size_t i;
+
+	for (i = 0; i < SIZEOF_ARRAY(higher); i++) {
+		if (strstr(key, higher[i]))
+			return BASELINE_HIGHER_IS_BETTER;
+	}
+	for (i = 0; i < SIZEOF_ARRAY(lower); i++) {
+		if (strstr(key, lower[i]))
+			return BASELINE_LOWER_IS_BETTER;
+	}
+	return BASELINE_NEUTRAL;
+}
+
+/*
+ *  stress_baseline_add()
+ *	add a baseline stressor metric to the end of the list
+ */
+static int stress_baseline_add(const char *stressor, const char *key, const double value)
+{
+	stress_baseline_t *b;
+
+	b = (stress_baseline_t *)calloc(1, sizeof(*b));
+	if (!b)
+		return -1;
+	b->stressor = shim_strdup(stressor);
+	b->key = shim_strdup(key);
+	if (!b->stressor || !b->key) {
+		free(b->key);
+		free(b->stressor);
+		free(b);
+		return -1;
+	}
+	b->baseline = value;
+
+	if (baseline_tail)
+		baseline_tail->next = b;
+	else
+		baseline_head = b;
+	baseline_tail = b;
+
+	return 0;
+}
+
+/*
+ *  stress_baseline_threshold()
+ *	parse --regress-threshold N or N%, returns -1 if invalid
+ */
+static int stress_baseline_threshold(const char *str)
+{
+	char *end;
+	double threshold;
+
+	errno = 0;
+	threshold = strtod(str, &end);
+	if ((errno != 0) || (end == str))
+		return -1;
+	if (*end == '%')
+		end++;
+	if ((*end != '\0') || (threshold < 0.0) || !isfinite(threshold))
+		return -1;
+	baseline_threshold = threshold;
+	return 0;
+}
+
+/*
+ *  stress_baseline_load()
+ *	load the per stressor metrics from the metrics: section of
+ *	a YAML file that stress-ng wrote with --metrics --yaml. Only
+ *	the per stressor "key: value" lines are used, the per instance
+ *	metrics are indented further and are skipped. Returns -1 on
+ *	an error.
+ */
+int stress_baseline_load(void)
+{
+	FILE *fp;
+	char *threshold_str = NULL;
+	char buf[4096];
+	char stressor[128];
+	bool in_metrics = false;
+	size_t n = 0;
+
+	if (!stress_setting_get("baseline", &baseline_filename)) {
+		if (stress_setting_get("regress-threshold", &threshold_str))
+			pr_inf("baseline: --regress-threshold ignored, no --baseline file specified\n");
+		return 0;
+	}
+	if (stress_setting_get("regress-threshold", &threshold_str) &&
+	    (stress_baseline_threshold(threshold_str) < 0)) {
+		(void)fprintf(stderr, "regress-threshold: invalid threshold '%s', "
+			"expecting a positive percentage, e.g. 5%%\n", threshold_str);
+		return -1;
+	}
+
+	fp = fopen(baseline_filename, "r");
+	if (!fp) {
+		(void)fprintf(stderr, "baseline: cannot open file '%s', errno=%d (%s)\n",
+			baseline_filename, errno, strerror(errno));
+		return -1;
+	}
+
+	*stressor = '\0';
+	while (fgets(buf, sizeof(buf), fp)) {
+		char *ptr, *colon, *end;
+		double value;
+
+		ptr = strchr(buf, '\n');
+		if (ptr)
+			*ptr = '\0';
+		if (*buf == '\0')
+			continue;
+
+		/* unindented line, start of a new YAML section */
+		if (*buf != ' ') {
+			in_metrics = !shim_strcmp(buf, "metrics:");
+			*stressor = '\0';
+			continue;
+		}
+		if (!in_metrics)
+			continue;
+
+		if (!strncmp(buf, "    - stressor: ", 16)) {
+			(void)shim_strscpy(stressor, buf + 16, sizeof(stressor));
+			continue;
+		}
+		/* per stressor metrics are indented by exactly 6 spaces */
+		if ((*stressor == '\0') || strncmp(buf, "      ", 6) || (buf[6] == ' '))
+			continue;
+		colon = strchr(buf + 6, ':');
+		if (!colon)
+			continue;
+		*colon = '\0';
+		value = strtod(colon + 1, &end);
+		if (end == colon + 1)
+			continue;
+		if (stress_baseline_add(stressor, buf + 6, value) < 0) {
+			pr_err("baseline: cannot allocate baseline metric, skipping remaining metrics\n");
+			break;
+		}
+		n++;
+	}
+	(void)fclose(fp);
+
+	if (n == 0)
+		pr_warn("baseline: no metrics found in '%s'\n", baseline_filename);
+	else
+		pr_dbg("baseline: loaded %zu metrics from '%s'\n", n, baseline_filename);
+
+	return 0;
+}
+
+/*
+ *  stress_baseline_metric()
+ *	set the metric value of the current run for a stressor
+ *	metric that may be in the baseline
+ */
+void stress_baseline_metric(const char *stressor, const char *key, const double value)
+{
+	stress_baseline_t *b;
+
+	for (b = baseline_head; b; b = b->next) {
+		if (!shim_strcmp(b->key, key) && !shim_strcmp(b->stressor, stressor)) {
+			b->current = value;
+			b->matched = true;
+			return;
+		}
+	}
+}
+
+/*
+ *  stress_baseline_report()
+ *	report the per metric deltas of the current run against
+ *	the baseline, returns false if any of the metrics regressed
+ *	by more than the regression threshold
+ */
+bool stress_baseline_report(FILE *yaml)
+{
+	stress_baseline_t *b;
+	uint32_t regressions = 0, unmatched = 0;
+	bool header = false;
+
+	if (!baseline_head)
+		return true;
+
+	pr_block_begin();
+	for (b = baseline_head; b; b = b->next) {
+		const int direction = stress_baseline_direction(b->key);
+		double delta;
+		const char *status;
+
+		if (!b->matched) {
+			unmatched++;
+			continue;
+		}
+		if (!header) {
+			pr_metrics("metrics compared to baseline %s (regression threshold %.2f%%):\n",
+				baseline_filename, baseline_threshold);
+			pr_metrics("%-13s %-39s %14s %14s %9s\n",
+				"stressor", "metric", "baseline", "current", "delta %");
+			pr_yaml(yaml, "baseline:\n");
+			pr_yaml(yaml, "    file: %s\n", baseline_filename);
+			pr_yaml(yaml, "    regress-threshold-percent: %f\n", baseline_threshold);
+			pr_yaml(yaml, "    metrics:\n");
+			header = true;
+		}
+
+		if (b->baseline != 0.0)
+			delta = 100.0 * (b->current - b->baseline) / fabs(b->baseline);
+		else
+			delta = 0.0;
+
+		if ((direction != BASELINE_NEUTRAL) && (((double)direction * delta) < -baseline_threshold)) {
+			status = "regressed";
+			regressions++;
+		} else if ((direction != BASELINE_NEUTRAL) && (((double)direction * delta) > baseline_threshold)) {
+			status = "improved";
+		} else {
+			status = "";
+		}
+
+		pr_metrics("%-13s %-39s %14.2f %14.2f %8.2f%%%s%s\n",
+			b->stressor, b->key, b->baseline, b->current, delta,
+			*status ? " " : "", status);
+		pr_yaml(yaml, "      - stressor: %s\n", b->stressor);
+		pr_yaml(yaml, "        metric: %s\n", b->key);
+		pr_yaml(yaml, "        baseline: %f\n", b->baseline);
+		pr_yaml(yaml, "        current: %f\n", b->current);
+		pr_yaml(yaml, "        delta-percent: %f\n", delta);
+		pr_yaml(yaml, "        regressed: %s\n", *status == 'r' ? "true" : "false");
+	}
+	if (header)
+		pr_yaml(yaml, "\n");
+
+	if (unmatched)
+		pr_inf("baseline: %" PRIu32 " baseline metric%s not found in this run\n",
+			unmatched, unmatched == 1 ? "" : "s");
+	if (regressions)
+		pr_warn("baseline: %" PRIu32 " metric%s regressed by more than %.2f%%\n",
+			regressions, regressions == 1 ? "" : "s", baseline_threshold);
+	pr_block_end();
+
+	return regressions == 0;
+}
+
+/*
+ *  stress_baseline_free()
+ *	free baseline metrics
+ */
+void stress_baseline_free(void)
+{
+	stress_baseline_t *b = baseline_head;
+
+	while (b) {
+		stress_baseline_t *next = b->next;
+
+		free(b->key);
+		free(b->stressor);
+		free(b);
+		b = next;
+	}
+	baseline_head = NULL;
+	baseline_tail = NULL;
+}
@@ -649,6 +649,19 @@ bool OPTIMIZE3 stress_cpu_x86_has_sse4_1(void)
 #endif
 }
 
+/*
+ *  stress_cpu_x86_has_sse4_2()
+ *	does x86 cpu support sse4.2 (and hence crc32 opcodes)?
+ */
+bool OPTIMIZE3 stress_cpu_x86_has_sse4_2(void)
+{
+#if defined(STRESS_ARCH_X86)
+	STRESS_CPU_X86_HAS(__func__, 0x1, 0, 0, 0, !!(ecx & CPUID_sse4_2_ECX));
+#else
+	return false;
+#endif
+}
+
 /*
  *  stress_cpu_x86_has_serialize()
  *	does x86 cpu support serialize opcode?
@@ -701,6 +714,32 @@ bool OPTIMIZE3 stress_cpu_x86_has_avx512_vnni(void)
 #endif
 }
 
+/*
+ *  stress_cpu_x86_has_avx2()
+ *	does x86 cpu support avx2
+ */
+bool OPTIMIZE3 stress_cpu_x86_has_avx2(void)
+{
+#if defined(STRESS_ARCH_X86)
+	STRESS_CPU_X86_HAS(__func__, 0x7, 0, 0, 0, !!(ebx & CPUID_avx2_EBX));
+#else
+	return false;
+#endif
+}
+
+/*
+ *  stress_cpu_x86_has_avx512_f()
+ *	does x86 cpu support avx512_f
+ */
+bool OPTIMIZE3 stress_cpu_x86_has_avx512_f(void)
+{
+#if defined(STRESS_ARCH_X86)
+	STRESS_CPU_X86_HAS(__func__, 0x7, 0, 0, 0, !!(ebx & CPUID_avx512_f_EBX));
+#else
+	return false;
+#endif
+}
+
 /*
  *  stress_cpu_x86_has_avx512_bw()
  *	does x86 cpu support avx512_bw
@@ -714,6 +753,32 @@ bool OPTIMIZE3 stress_cpu_x86_has_avx512_bw(void)
 #endif
 }
 
+/*
+ *  stress_cpu_x86_has_erms()
+ *	does x86 cpu support enhanced rep movsb/stosb
+ */
+bool OPTIMIZE3 stress_cpu_x86_has_erms(void)
+{
+#if defined(STRESS_ARCH_X86)
+	STRESS_CPU_X86_HAS(__func__, 0x7, 0, 0, 0, !!(ebx & CPUID_erms_EBX));
+#else
+	return false;
+#endif
+}
+
+/*
+ *  stress_cpu_x86_has_fsrm()
+ *	does x86 cpu support fast short rep movsb
+ */
+bool OPTIMIZE3 stress_cpu_x86_has_fsrm(void)
+{
+#if defined(STRESS_ARCH_X86)
+	STRESS_CPU_X86_HAS(__func__, 0x7, 0, 0, 0, !!(edx & CPUID_fsrm_EDX));
+#else
+	return false;
+#endif
+}
+
 /*
  *  stress_cpu_x86_has_movdiri()
  *	does x86 cpu support movdiri
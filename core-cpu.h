@@ -23,10 +23,14 @@
 #include "core-arch.h"
 
 extern WARN_UNUSED bool stress_cpu_is_x86(void);
+extern WARN_UNUSED bool stress_cpu_x86_has_avx2(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_avx_vnni(void);
+extern WARN_UNUSED bool stress_cpu_x86_has_avx512_f(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_avx512_vl(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_avx512_vnni(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_avx512_bw(void);
+extern WARN_UNUSED bool stress_cpu_x86_has_erms(void);
+extern WARN_UNUSED bool stress_cpu_x86_has_fsrm(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_clflushopt(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_clwb(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_cldemote(void);
@@ -42,6 +46,7 @@ extern WARN_UNUSED bool stress_cpu_x86_has_serialize(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_sse(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_sse2(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_sse4_1(void);
+extern WARN_UNUSED bool stress_cpu_x86_has_sse4_2(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_syscall(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_tsc(void);
 extern WARN_UNUSED bool stress_cpu_x86_has_waitpkg(void);
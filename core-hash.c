@@ -20,8 +20,39 @@
 #include "stress-ng.h"
 #include "core-attribute.h"
 #include "core-builtin.h"
+#include "core-cpu.h"
 #include "core-hash.h"
 #include "core-pragma.h"
+#include "core-target-clones.h"
+
+#if defined(HAVE_SYS_AUXV_H)
+#include <sys/auxv.h>
+#endif
+
+#if defined(HAVE_ARM_ACLE_CRC32C) &&	\
+    defined(STRESS_ARCH_ARM)
+#include <arm_acle.h>
+#endif
+
+#if defined(HAVE_BUILTIN_IA32_CRC32DI) &&	\
+    defined(STRESS_ARCH_X86_64)
+#define HAVE_CRC32C_X86
+#define TARGET_SSE42		__attribute__ ((target("sse4.2")))
+#endif
+
+#if defined(HAVE_ARM_ACLE_CRC32C) &&	\
+    defined(STRESS_ARCH_ARM) &&		\
+    defined(HAVE_SYS_AUXV_H) &&		\
+    defined(HAVE_GETAUXVAL) &&		\
+    defined(HWCAP_CRC32)
+#define HAVE_CRC32C_ARM
+#define TARGET_CRC		__attribute__ ((target("+crc")))
+#endif
+
+#define CRC32C_POLY		(0x82f63b78U)	/* reflected Castagnoli polynomial */
+#define CRC32C_STREAM_BLOCK	(4096)		/* bytes per stream per interleaved block */
+
+typedef uint32_t (*stress_crc32c_func_t)(uint32_t crc, const uint8_t *data, size_t len);
 
 /*
  *  stress_hash_jenkin()
@@ -198,6 +229,60 @@ uint32_t OPTIMIZE3 stress_hash_murmur3_32(
 	return h;
 }
 
+/*
+ *  stress_hash_murmur3_32_x8
+ *	32 bit murmur3 hash of STRESS_HASH_MURMUR3_LANES keys
+ *	of len bytes that are stride bytes apart. The lanes are
+ *	hashed in step so the compiler can vectorize across the
+ *	keys, results are identical to stress_hash_murmur3_32
+ */
+void TARGET_CLONES OPTIMIZE3 stress_hash_murmur3_32_x8(
+	const uint8_t *keys,
+	const size_t stride,
+	const size_t len,
+	const uint32_t seed,
+	uint32_t *hashes)
+{
+	uint32_t h[STRESS_HASH_MURMUR3_LANES];
+	register size_t i, l;
+
+	for (l = 0; l < STRESS_HASH_MURMUR3_LANES; l++)
+		h[l] = seed;
+
+	for (i = 0; i < (len & ~(size_t)3); i += sizeof(uint32_t)) {
+		for (l = 0; l < STRESS_HASH_MURMUR3_LANES; l++) {
+			uint32_t k;
+
+			(void)shim_memcpy(&k, keys + (l * stride) + i, sizeof(k));
+			k *= 0xcc9e2d51;
+			k = (k << 15) | (k >> 17);
+			k *= 0x1b873593;
+			h[l] ^= k;
+			h[l] = (h[l] << 13) | (h[l] >> 19);
+			h[l] = h[l] * 5 + 0xe6546b64;
+		}
+	}
+
+	for (l = 0; l < STRESS_HASH_MURMUR3_LANES; l++) {
+		const uint8_t *key = keys + (l * stride) + i;
+		register uint32_t k = 0;
+		register size_t j;
+
+		for (j = len & 3; j; j--) {
+			k <<= 8;
+			k |= key[j - 1];
+		}
+		h[l] ^= stress_hash_murmur_32_scramble(k);
+		h[l] ^= len;
+		h[l] ^= h[l] >> 16;
+		h[l] *= 0x85ebca6b;
+		h[l] ^= h[l] >> 13;
+		h[l] *= 0xc2b2ae35;
+		h[l] ^= h[l] >> 16;
+		hashes[l] = h[l];
+	}
+}
+
 /*
  * crc32c table generated using:
  *
@@ -300,6 +385,229 @@ PRAGMA_UNROLL_N(4)
 	return ~crc;
 }
 
+/*
+ *  stress_hash_crc32c_table()
+ *	table driven crc32c, updates the raw crc register value
+ */
+static uint32_t OPTIMIZE3 stress_hash_crc32c_table(
+	register uint32_t crc,
+	register const uint8_t *data,
+	register size_t len)
+{
+PRAGMA_UNROLL_N(4)
+	while (len--)
+		crc = (crc >> 8) ^ crc32c_table[(crc ^ *data++) & 0xff];
+
+	return crc;
+}
+
+#if defined(HAVE_CRC32C_X86) ||	\
+    defined(HAVE_CRC32C_ARM)
+static uint32_t crc32c_shift_block;	/* x^(8 * CRC32C_STREAM_BLOCK) mod P */
+static uint32_t crc32c_shift_block2;	/* x^(16 * CRC32C_STREAM_BLOCK) mod P */
+
+/*
+ *  stress_hash_crc32c_multmodp()
+ *	multiply a and b modulo the reflected crc32c polynomial
+ */
+static uint32_t OPTIMIZE3 stress_hash_crc32c_multmodp(uint32_t a, uint32_t b)
+{
+	uint32_t m = 1U << 31, p = 0;
+
+	for (;;) {
+		if (a & m) {
+			p ^= b;
+			if ((a & (m - 1)) == 0)
+				break;
+		}
+		m >>= 1;
+		b = (b & 1) ? (b >> 1) ^ CRC32C_POLY : b >> 1;
+	}
+	return p;
+}
+
+/*
+ *  stress_hash_crc32c_x8nmodp()
+ *	compute x^(8 * n) modulo the reflected crc32c polynomial,
+ *	this is the operator that appends n zero bytes to a crc
+ */
+static uint32_t stress_hash_crc32c_x8nmodp(size_t n)
+{
+	uint32_t xp = 1U << 31;		/* x^0 */
+	uint32_t x2k = 1U << 23;	/* x^8 */
+
+	while (n) {
+		if (n & 1)
+			xp = stress_hash_crc32c_multmodp(x2k, xp);
+		x2k = stress_hash_crc32c_multmodp(x2k, x2k);
+		n >>= 1;
+	}
+	return xp;
+}
+
+/*
+ *  stress_hash_crc32c_shift_init()
+ *	compute the operators to combine the crcs of the
+ *	interleaved streams
+ */
+static void stress_hash_crc32c_shift_init(void)
+{
+	crc32c_shift_block = stress_hash_crc32c_x8nmodp(CRC32C_STREAM_BLOCK);
+	crc32c_shift_block2 = stress_hash_crc32c_x8nmodp(2 * CRC32C_STREAM_BLOCK);
+}
+#endif
+
+#if defined(HAVE_CRC32C_X86)
+/*
+ *  stress_hash_crc32c_x86()
+ *	crc32c using the SSE4.2 crc32 instructions, large buffers
+ *	are hashed in three interleaved streams to hide the 3 cycle
+ *	latency of the crc32 instruction, the stream crcs are then
+ *	combined using the shift operators
+ */
+static uint32_t TARGET_SSE42 OPTIMIZE3 stress_hash_crc32c_x86(
+	uint32_t crc,
+	const uint8_t *data,
+	size_t len)
+{
+	uint64_t crc0 = crc;
+
+	while (len >= 3 * CRC32C_STREAM_BLOCK) {
+		const uint8_t *end = data + CRC32C_STREAM_BLOCK;
+		uint64_t crc1 = 0, crc2 = 0;
+
+		while (data < end) {
+			uint64_t v0, v1, v2;
+
+			(void)shim_memcpy(&v0, data, sizeof(v0));
+			(void)shim_memcpy(&v1, data + CRC32C_STREAM_BLOCK, sizeof(v1));
+			(void)shim_memcpy(&v2, data + 2 * CRC32C_STREAM_BLOCK, sizeof(v2));
+			crc0 = __builtin_ia32_crc32di(crc0, v0);
+			crc1 = __builtin_ia32_crc32di(crc1, v1);
+			crc2 = __builtin_ia32_crc32di(crc2, v2);
+			data += sizeof(uint64_t);
+		}
+		crc0 = stress_hash_crc32c_multmodp(crc32c_shift_block2, (uint32_t)crc0) ^
+		       stress_hash_crc32c_multmodp(crc32c_shift_block, (uint32_t)crc1) ^
+		       (uint32_t)crc2;
+		data += 2 * CRC32C_STREAM_BLOCK;
+		len -= 3 * CRC32C_STREAM_BLOCK;
+	}
+	while (len >= sizeof(uint64_t)) {
+		uint64_t v;
+
+		(void)shim_memcpy(&v, data, sizeof(v));
+		crc0 = __builtin_ia32_crc32di(crc0, v);
+		data += sizeof(uint64_t);
+		len -= sizeof(uint64_t);
+	}
+	while (len--)
+		crc0 = __builtin_ia32_crc32qi((uint32_t)crc0, *data++);
+
+	return (uint32_t)crc0;
+}
+#endif
+
+#if defined(HAVE_CRC32C_ARM)
+/*
+ *  stress_hash_crc32c_arm()
+ *	crc32c using the ARMv8 crc32c instructions, large buffers
+ *	are hashed in three interleaved streams that are combined
+ *	using the shift operators
+ */
+static uint32_t TARGET_CRC OPTIMIZE3 stress_hash_crc32c_arm(
+	uint32_t crc,
+	const uint8_t *data,
+	size_t len)
+{
+	while (len >= 3 * CRC32C_STREAM_BLOCK) {
+		const uint8_t *end = data + CRC32C_STREAM_BLOCK;
+		uint32_t crc1 = 0, crc2 = 0;
+
+		while (data < end) {
+			uint64_t v0, v1, v2;
+
+			(void)shim_memcpy(&v0, data, sizeof(v0));
+			(void)shim_memcpy(&v1, data + CRC32C_STREAM_BLOCK, sizeof(v1));
+			(void)shim_memcpy(&v2, data + 2 * CRC32C_STREAM_BLOCK, sizeof(v2));
+			crc = __crc32cd(crc, v0);
+			crc1 = __crc32cd(crc1, v1);
+			crc2 = __crc32cd(crc2, v2);
+			data += sizeof(uint64_t);
+		}
+		crc = stress_hash_crc32c_multmodp(crc32c_shift_block2, crc) ^
+		      stress_hash_crc32c_multmodp(crc32c_shift_block, crc1) ^
+		      crc2;
+		data += 2 * CRC32C_STREAM_BLOCK;
+		len -= 3 * CRC32C_STREAM_BLOCK;
+	}
+	while (len >= sizeof(uint64_t)) {
+		uint64_t v;
+
+		(void)shim_memcpy(&v, data, sizeof(v));
+		crc = __crc32cd(crc, v);
+		data += sizeof(uint64_t);
+		len -= sizeof(uint64_t);
+	}
+	while (len--)
+		crc = __crc32cb(crc, *data++);
+
+	return crc;
+}
+#endif
+
+static stress_crc32c_func_t crc32c_func;
+static const char *crc32c_func_name = "table";
+
+/*
+ *  stress_hash_crc32c_select()
+ *	select the fastest crc32c implementation the cpu supports
+ */
+static void stress_hash_crc32c_select(void)
+{
+#if defined(HAVE_CRC32C_X86)
+	if (stress_cpu_x86_has_sse4_2()) {
+		stress_hash_crc32c_shift_init();
+		crc32c_func_name = "sse4.2";
+		crc32c_func = stress_hash_crc32c_x86;
+		return;
+	}
+#endif
+#if defined(HAVE_CRC32C_ARM)
+	if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+		stress_hash_crc32c_shift_init();
+		crc32c_func_name = "armv8 crc32";
+		crc32c_func = stress_hash_crc32c_arm;
+		return;
+	}
+#endif
+	crc32c_func = stress_hash_crc32c_table;
+}
+
+/*
+ *  stress_hash_crc32c_len()
+ *	crc32c of len bytes of data, uses the cpu crc32
+ *	instructions when available, returns the same
+ *	result as stress_hash_crc32c() on a string
+ */
+uint32_t OPTIMIZE3 stress_hash_crc32c_len(const uint8_t *data, const size_t len)
+{
+	if (UNLIKELY(!crc32c_func))
+		stress_hash_crc32c_select();
+	return ~crc32c_func(~0U, data, len);
+}
+
+/*
+ *  stress_hash_crc32c_impl()
+ *	name of the crc32c implementation used by stress_hash_crc32c_len()
+ */
+const char *stress_hash_crc32c_impl(void)
+{
+	if (!crc32c_func)
+		stress_hash_crc32c_select();
+	return crc32c_func_name;
+}
+
 /*
  *  stress_hash_adler32()
  *	Mark Adler 32 bit hash
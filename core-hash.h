@@ -21,6 +21,8 @@
 
 #include "core-attribute.h"
 
+#define STRESS_HASH_MURMUR3_LANES	(8)	/* keys hashed by stress_hash_murmur3_32_x8 */
+
 /* hash linked list type */
 typedef struct stress_hash {
 	struct stress_hash *next; 	/* next hash item */
@@ -47,6 +49,8 @@ extern WARN_UNUSED uint32_t stress_hash_coffin(const char *str);
 extern WARN_UNUSED uint32_t stress_hash_coffin32_be(const char *str, const size_t len);
 extern WARN_UNUSED uint32_t stress_hash_coffin32_le(const char *str, const size_t len);
 extern WARN_UNUSED uint32_t stress_hash_crc32c(const char *str);
+extern WARN_UNUSED uint32_t stress_hash_crc32c_len(const uint8_t *data, const size_t len);
+extern WARN_UNUSED const char *stress_hash_crc32c_impl(void);
 extern WARN_UNUSED uint32_t stress_hash_djb2a(const char *str);
 extern WARN_UNUSED uint32_t stress_hash_fnv1a(const char *str);
 extern WARN_UNUSED uint32_t stress_hash_jenkin(const uint8_t *data, const size_t len);
@@ -61,6 +65,8 @@ extern WARN_UNUSED uint32_t stress_hash_mulxror32(const char *str, const size_t
 extern WARN_UNUSED uint32_t stress_hash_xorror64(const char *str, const size_t len);
 extern WARN_UNUSED uint32_t stress_hash_xorror32(const char *str, const size_t len);
 extern WARN_UNUSED uint32_t stress_hash_murmur3_32(const uint8_t *key, size_t len, uint32_t seed);
+extern void stress_hash_murmur3_32_x8(const uint8_t *keys, const size_t stride,
+	const size_t len, const uint32_t seed, uint32_t *hashes);
 extern WARN_UNUSED uint32_t stress_hash_nhash(const char *str);
 extern WARN_UNUSED uint32_t stress_hash_pjw(const char *str);
 extern WARN_UNUSED uint32_t stress_hash_sdbm(const char *str);
@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2026 Colin Ian King.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include "stress-ng.h"
+#include "core-builtin.h"
+#include "core-latency.h"
+
+#include <time.h>
+
+/*
+ *  stress_latency_time_ns()
+ *	monotonic time in nanoseconds, 0 if it can't be read
+ */
+static inline uint64_t OPTIMIZE3 stress_latency_time_ns(void)
+{
+#if defined(HAVE_CLOCK_GETTIME) &&	\
+    defined(CLOCK_MONOTONIC)
+	struct timespec ts;
+
+	if (UNLIKELY(clock_gettime(CLOCK_MONOTONIC, &ts) < 0))
+		return 0;
+	return ((uint64_t)ts.tv_sec * STRESS_NANOSECOND) + (uint64_t)ts.tv_nsec;
+#else
+	return (uint64_t)(stress_time_now() * (double)STRESS_NANOSECOND);
+#endif
+}
+
+/*
+ *  stress_latency_shift()
+ *	log to the base 2 of non-zero value n
+ */
+static inline size_t OPTIMIZE3 stress_latency_shift(const uint64_t n)
+{
+#if defined(HAVE_BUILTIN_CLZLL)
+	return (8 * sizeof(unsigned long long int)) - 1 -
+		(size_t)__builtin_clzll((unsigned long long int)n);
+#else
+	register size_t l2;
+	register uint64_t i = n;
+
+	for (l2 = 0; i > 1; l2++)
+		i >>= 1;
+	return l2;
+#endif
+}
+
+/*
+ *  stress_latency_index()
+ *	map a latency in nanoseconds to a histogram bucket index
+ */
+static inline size_t OPTIMIZE3 stress_latency_index(const uint64_t ns)
+{
+	size_t shift;
+
+	if (ns < STRESS_LATENCY_SUB_BUCKETS)
+		return (size_t)ns;
+	shift = stress_latency_shift(ns);
+	if (UNLIKELY(shift >= STRESS_LATENCY_MAX_SHIFT))
+		return STRESS_LATENCY_BUCKETS - 1;
+
+	return ((shift - STRESS_LATENCY_SUB_SHIFT + 1) * STRESS_LATENCY_SUB_BUCKETS) +
+		(size_t)((ns >> (shift - STRESS_LATENCY_SUB_SHIFT)) & (STRESS_LATENCY_SUB_BUCKETS - 1));
+}
+
+/*
+ *  stress_latency_value()
+ *	map a histogram bucket index to the highest latency
+ *	value in nanoseconds that is recorded into that bucket
+ */
+static double stress_latency_value(const size_t index)
+{
+	size_t shift;
+	uint64_t sub, low;
+
+	if (index < STRESS_LATENCY_SUB_BUCKETS)
+		return (double)index;
+
+	shift = (index / STRESS_LATENCY_SUB_BUCKETS) + STRESS_LATENCY_SUB_SHIFT - 1;
+	sub = (uint64_t)(index & (STRESS_LATENCY_SUB_BUCKETS - 1));
+	low = (STRESS_LATENCY_SUB_BUCKETS + sub) << (shift - STRESS_LATENCY_SUB_SHIFT);
+
+	return (double)(low + (1ULL << (shift - STRESS_LATENCY_SUB_SHIFT)) - 1);
+}
+
+/*
+ *  stress_latency_record()
+ *	record the time since the previous bogo-op update as the
+ *	latency of the ops just completed. The histogram is only ever
+ *	written to by the stressor instance that owns it, so no locking
+ *	is required, the parent only reads it once the instance has
+ *	been reaped. The first update after a reset has no previous
+ *	time stamp and is just used to prime the last time.
+ */
+void OPTIMIZE3 stress_latency_record(stress_args_t *args, const uint64_t ops)
+{
+	stress_latency_t *latency;
+	uint64_t t_now, t_last, ns;
+	size_t index;
+
+	if (UNLIKELY(!args->stats))
+		return;
+	latency = args->stats->latency;
+	if (UNLIKELY(!latency || (ops == 0)))
+		return;
+
+	t_now = stress_latency_time_ns();
+	t_last = latency->t_last;
+	latency->t_last = t_now;
+	if (UNLIKELY((t_last == 0) || (t_now < t_last) || (t_now < latency->t_warmup)))
+		return;
+
+	ns = (t_now - t_last) / ops;
+	index = stress_latency_index(ns);
+	latency->bucket[index] += ops;
+	latency->count += ops;
+	if (ns > latency->max)
+		latency->max = ns;
+}
+
+/*
+ *  stress_latency_reset()
+ *	reset last time stamp before a stressor instance starts,
+ *	the histogram accumulates over multiple runs, as
+ *	per the bogo-op counter totals
+ */
+void stress_latency_reset(stress_latency_t *latency)
+{
+	if (latency) {
+		latency->t_last = 0;
+		latency->t_warmup = 0;
+	}
+}
+
+/*
+ *  stress_latency_warmup()
+ *	do not record latencies for the next warmup seconds,
+ *	the --warmup phase is excluded from the histogram
+ */
+void stress_latency_warmup(stress_latency_t *latency, const uint32_t warmup)
+{
+	if (latency)
+		latency->t_warmup = stress_latency_time_ns() + ((uint64_t)warmup * STRESS_NANOSECOND);
+}
+
+/*
+ *  stress_latency_percentiles()
+ *	merge histograms of all instances of a stressor and
+ *	compute latency percentiles, returns false if no
+ *	latencies were recorded
+ */
+bool stress_latency_percentiles(
+	const stress_list_item_t *item,
+	stress_latency_percentiles_t *percentiles)
+{
+	static const double pcent[] = { 0.50, 0.90, 0.99, 0.999 };
+	double *const value[] = {
+		&percentiles->p50,
+		&percentiles->p90,
+		&percentiles->p99,
+		&percentiles->p99_9,
+	};
+	uint64_t *bucket;
+	uint64_t count = 0, max = 0, sum;
+	int32_t i;
+	size_t j, k;
+
+	(void)shim_memset(percentiles, 0, sizeof(*percentiles));
+	if (!item->stats)
+		return false;
+
+	bucket = (uint64_t *)calloc(STRESS_LATENCY_BUCKETS, sizeof(*bucket));
+	if (!bucket)
+		return false;
+
+	for (i = 0; i < item->instances; i++) {
+		const stress_latency_t *latency = item->stats[i]->latency;
+
+		if (!latency)
+			continue;
+		for (j = 0; j < STRESS_LATENCY_BUCKETS; j++)
+			bucket[j] += latency->bucket[j];
+		count += latency->count;
+		if (max < latency->max)
+			max = latency->max;
+	}
+	if (count == 0) {
+		free(bucket);
+		return false;
+	}
+
+	for (sum = 0, j = 0, k = 0; (j < STRESS_LATENCY_BUCKETS) && (k < SIZEOF_ARRAY(pcent)); j++) {
+		sum += bucket[j];
+		while ((k < SIZEOF_ARRAY(pcent)) && ((double)sum >= pcent[k] * (double)count)) {
+			const double v = stress_latency_value(j);
+
+			/* don't report a bucket limit greater than the actual maximum */
+			*value[k] = (v > (double)max) ? (double)max : v;
+			k++;
+		}
+	}
+	for (; k < SIZEOF_ARRAY(pcent); k++)
+		*value[k] = (double)max;
+
+	percentiles->count = count;
+	percentiles->max = (double)max;
+	free(bucket);
+
+	return true;
+}
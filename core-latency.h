@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026 Colin Ian King.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#ifndef CORE_LATENCY_H
+#define CORE_LATENCY_H
+
+/*
+ *  Log-linear histogram, values 0..15 nanoseconds are recorded
+ *  exactly, larger values are split into 16 linear sub-buckets
+ *  per power of 2, giving a worst case error of 6.25%. Values
+ *  of 2^40 nanoseconds (~18 minutes) and above are clamped into
+ *  the final bucket.
+ */
+#define STRESS_LATENCY_SUB_SHIFT	(4)
+#define STRESS_LATENCY_SUB_BUCKETS	(1U << STRESS_LATENCY_SUB_SHIFT)
+#define STRESS_LATENCY_MAX_SHIFT	(40)
+#define STRESS_LATENCY_BUCKETS		\
+	((STRESS_LATENCY_MAX_SHIFT - STRESS_LATENCY_SUB_SHIFT + 1) * STRESS_LATENCY_SUB_BUCKETS)
+
+/* Per stressor instance bogo-op latency histogram */
+typedef struct {
+	uint64_t t_last;		/* time of last bogo-op, nanoseconds */
+	uint64_t t_warmup;		/* end of --warmup phase, nanoseconds */
+	uint64_t max;			/* maximum latency, nanoseconds */
+	uint64_t count;			/* total bogo-ops recorded */
+	uint64_t bucket[STRESS_LATENCY_BUCKETS];	/* histogram buckets */
+} stress_latency_t;
+
+/* Latency percentiles computed across all instances of a stressor */
+typedef struct {
+	uint64_t count;			/* total bogo-ops recorded */
+	double p50;			/* 50th percentile, nanoseconds */
+	double p90;			/* 90th percentile, nanoseconds */
+	double p99;			/* 99th percentile, nanoseconds */
+	double p99_9;			/* 99.9th percentile, nanoseconds */
+	double max;			/* maximum, nanoseconds */
+} stress_latency_percentiles_t;
+
+extern void stress_latency_record(stress_args_t *args, const uint64_t ops);
+extern void stress_latency_reset(stress_latency_t *latency);
+extern void stress_latency_warmup(stress_latency_t *latency, const uint32_t warmup);
+extern bool stress_latency_percentiles(const stress_list_item_t *item,
+	stress_latency_percentiles_t *percentiles);
+
+#endif
@@ -110,6 +110,21 @@
 #define LOCK_METHOD_SEM_SYSV		(0)
 #endif
 
+#if defined(HAVE_ATOMIC_COMPARE_EXCHANGE) &&	\
+    defined(HAVE_ATOMIC_FETCH_ADD) &&		\
+    defined(HAVE_ATOMIC_LOAD_N) &&		\
+    defined(HAVE_ATOMIC_STORE_N)
+#define HAVE_LOCK_QUEUE
+#endif
+
+#define STRESS_LOCK_NODES	(1024)	/* shared MCS and CLH queue nodes */
+#define STRESS_LOCK_NODES_MAX	(1 + STRESS_LOCK_MAX + STRESS_LOCK_NODES)	/* 0 = no node */
+#define STRESS_LOCK_COHORTS	(8)	/* NUMA node cohorts per cohort lock */
+#define STRESS_LOCK_COHORT_LOCKS (64)	/* max cohort locks */
+#define STRESS_LOCK_COHORT_PASSES (64)	/* max local hand-overs of the global lock */
+#define STRESS_LOCK_SPINS	(1024)	/* spins before yielding */
+#define STRESS_LOCK_YIELDS	(64)	/* yields before sleeping */
+
 #define LOCK_METHOD_ALL			\
 	(LOCK_METHOD_ATOMIC_SPINLOCK |	\
 	 LOCK_METHOD_PTHREAD_SPINLOCK | \
@@ -136,11 +151,61 @@ typedef union {
 #endif
 } stress_lock_u_t;
 
+typedef struct {
+	uint32_t	next;		/* next ticket to hand out */
+	uint32_t	owner;		/* ticket being served */
+} stress_lock_ticket_t;
+
+typedef union {
+	stress_lock_ticket_t ticket;	/* ticket lock */
+	struct {
+		uint32_t tail;		/* node at tail of queue */
+		uint32_t holder;	/* node of lock holder */
+		uint32_t pred;		/* CLH predecessor node kept by spare node holder */
+		stress_lock_ticket_t spare;	/* spare node lock, used if no free nodes */
+	} queue;			/* MCS and CLH queue locks */
+	struct {
+		stress_lock_ticket_t global;	/* global lock, passed between cohorts */
+		uint32_t block;		/* per cohort local lock block */
+		uint32_t holder;	/* cohort of lock holder */
+	} cohort;			/* NUMA aware cohort lock */
+} stress_lock_q_t;
+
 typedef struct stress_lock {
 	uint32_t	magic;		/* Lock magic struct pattern, zero when not in use */
+	uint32_t	method;		/* Lock method, index into stress_lock_methods */
 	stress_lock_u_t u;		/* Lock union */
+	stress_lock_q_t q;		/* Queue lock union */
 } stress_lock_t;
 
+/* MCS and CLH queue node, one per cache line */
+typedef struct {
+	uint32_t	locked ALIGN64;	/* MCS: waiting, CLH: held or waiting */
+	uint32_t	next;		/* MCS successor node, 0 = none */
+	uint32_t	used;		/* node allocated */
+} stress_lock_node_t;
+
+/* Cohort local lock, one per cache line */
+typedef struct {
+	stress_lock_ticket_t ticket ALIGN64;	/* local lock */
+	uint32_t	global_held;	/* cohort holds the global lock */
+	uint32_t	passes;		/* consecutive local hand-overs */
+} stress_lock_cohort_local_t;
+
+typedef struct {
+	stress_lock_cohort_local_t local[STRESS_LOCK_COHORTS];
+	uint32_t	used ALIGN64;	/* block allocated */
+} stress_lock_cohort_block_t;
+
+/*
+ *  Shared queue lock nodes and cohort local locks, nodes 1..STRESS_LOCK_MAX
+ *  are the spare nodes of each lock, the rest are shared by all locks
+ */
+typedef struct {
+	stress_lock_node_t node[STRESS_LOCK_NODES_MAX];
+	stress_lock_cohort_block_t cohort[STRESS_LOCK_COHORT_LOCKS];
+} stress_lock_pool_t;
+
 typedef struct stress_lock_funcs {
 	const char *type;
 	int (*init)(stress_lock_t *lock);
@@ -152,6 +217,10 @@ typedef struct stress_lock_funcs {
 
 static stress_lock_t *stress_locks;
 static stress_lock_t *stress_lock_big_lock;
+#if defined(HAVE_LOCK_QUEUE)
+static stress_lock_pool_t *stress_lock_pool;
+#endif
+static size_t stress_lock_method_default;
 
 static stress_lock_t *stress_lock_get(void);
 static int stress_lock_put(stress_lock_t *lock);
@@ -603,10 +672,473 @@ static const stress_lock_funcs_t stress_lock_funcs = {
 #endif
 
 /*
- *  stress_lock_create()
- *	generic lock creation and initialization
+ *  Runtime selectable queue based locks, the lock state lives in the
+ *  shared locks mapping and the queue nodes and cohort local locks
+ *  in the shared lock pool so they can be used across processes
  */
-void *stress_lock_create(const char *name)
+#if defined(HAVE_LOCK_QUEUE)
+/*
+ *  stress_lock_spin()
+ *	busy wait with a cpu relax hint, then yield the cpu and then
+ *	sleep with an exponential backoff of up to ~1ms so that lower
+ *	priority lock holders can run
+ */
+static inline void stress_lock_spin(uint32_t *spins)
+{
+	register uint32_t n = *spins;
+
+	*spins = n + 1;
+	if (LIKELY(n < STRESS_LOCK_SPINS)) {
+#if defined(HAVE_ASM_X86_PAUSE)
+		stress_asm_x86_pause();
+#elif defined(HAVE_ASM_LOONG64_DBAR)
+		stress_asm_loong64_dbar();
+#elif defined(STRESS_ARCH_PPC64)
+		stress_asm_ppc64_yield();
+#elif defined(STRESS_ARCH_PPC)
+		stress_asm_ppc_yield();
+#elif defined(STRESS_ARCH_RISCV)
+		stress_asm_riscv_pause();
+#endif
+		return;
+	}
+	n -= STRESS_LOCK_SPINS;
+	if (n < STRESS_LOCK_YIELDS) {
+		(void)shim_sched_yield();
+		return;
+	}
+	n -= STRESS_LOCK_YIELDS;
+	(void)shim_nanosleep_uint64(1000ULL << ((n < 10) ? n : 10));
+}
+
+/*
+ *  stress_lock_xchg()
+ *	atomic exchange using compare and exchange
+ */
+static inline uint32_t stress_lock_xchg(uint32_t *ptr, const uint32_t val)
+{
+	uint32_t old = __atomic_load_n(ptr, __ATOMIC_RELAXED);
+
+	while (!__atomic_compare_exchange_n(ptr, &old, val, false,
+					    __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+		;
+	return old;
+}
+
+/*
+ *  stress_lock_node_get()
+ *	allocate a queue node from the shared pool, start the
+ *	search at a per thread position to reduce contention,
+ *	returns 0 if the pool is exhausted
+ */
+static uint32_t stress_lock_node_get(void)
+{
+	const uint32_t start = (uint32_t)shim_gettid() * 7;
+	register uint32_t i;
+
+	for (i = 0; i < STRESS_LOCK_NODES; i++) {
+		const uint32_t idx = 1 + STRESS_LOCK_MAX + ((start + i) % STRESS_LOCK_NODES);
+		stress_lock_node_t *node = &stress_lock_pool->node[idx];
+		uint32_t expected = 0;
+
+		if (__atomic_load_n(&node->used, __ATOMIC_RELAXED))
+			continue;
+		if (__atomic_compare_exchange_n(&node->used, &expected, 1, false,
+						__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			node->next = 0;
+			return idx;
+		}
+	}
+	return 0;
+}
+
+/*
+ *  stress_lock_node_spare()
+ *	the spare queue node of a lock
+ */
+static inline uint32_t stress_lock_node_spare(const stress_lock_t *lock)
+{
+	return 1 + (uint32_t)(lock - stress_locks);
+}
+
+/*
+ *  Ticket lock, FIFO order, waiters spin on the shared owner field
+ */
+static inline void stress_lock_ticket_acquire(stress_lock_ticket_t *ticket)
+{
+	const uint32_t t = __atomic_fetch_add(&ticket->next, 1, __ATOMIC_RELAXED);
+	uint32_t spins = 0;
+
+	while (__atomic_load_n(&ticket->owner, __ATOMIC_ACQUIRE) != t)
+		stress_lock_spin(&spins);
+}
+
+static inline void stress_lock_ticket_release(stress_lock_ticket_t *ticket)
+{
+	__atomic_store_n(&ticket->owner, ticket->owner + 1, __ATOMIC_RELEASE);
+}
+
+static inline bool stress_lock_ticket_waiters(stress_lock_ticket_t *ticket)
+{
+	return (__atomic_load_n(&ticket->next, __ATOMIC_RELAXED) - ticket->owner) > 1;
+}
+
+/*
+ *  stress_lock_node_lock_get()
+ *	allocate a queue node for lock, if the shared pool is
+ *	exhausted wait in FIFO order for the lock's spare node
+ *	so acquiring a queue lock never fails
+ */
+static uint32_t stress_lock_node_lock_get(stress_lock_t *lock)
+{
+	const uint32_t idx = stress_lock_node_get();
+
+	if (LIKELY(idx))
+		return idx;
+	stress_lock_ticket_acquire(&lock->q.queue.spare);
+	stress_lock_pool->node[stress_lock_node_spare(lock)].next = 0;
+	return stress_lock_node_spare(lock);
+}
+
+/*
+ *  stress_lock_node_put()
+ *	return a queue node to the shared pool or hand
+ *	the lock's spare node to the next waiter for it
+ */
+static inline void stress_lock_node_put(stress_lock_t *lock, const uint32_t idx)
+{
+	if (idx == stress_lock_node_spare(lock))
+		stress_lock_ticket_release(&lock->q.queue.spare);
+	else
+		__atomic_store_n(&stress_lock_pool->node[idx].used, 0, __ATOMIC_RELEASE);
+}
+
+static int stress_ticket_init(stress_lock_t *lock)
+{
+	lock->q.ticket.next = 0;
+	lock->q.ticket.owner = 0;
+
+	return 0;
+}
+
+static int CONST stress_ticket_deinit(stress_lock_t *lock)
+{
+	(void)lock;
+
+	return 0;
+}
+
+static int stress_ticket_acquire(stress_lock_t *lock)
+{
+	stress_lock_ticket_acquire(&lock->q.ticket);
+
+	return 0;
+}
+
+static int stress_ticket_release(stress_lock_t *lock)
+{
+	stress_lock_ticket_release(&lock->q.ticket);
+
+	return 0;
+}
+
+static const stress_lock_funcs_t stress_lock_funcs_ticket = {
+	"ticket",
+	stress_ticket_init,
+	stress_ticket_deinit,
+	stress_ticket_acquire,
+	stress_ticket_acquire,
+	stress_ticket_release
+};
+
+/*
+ *  MCS lock, waiters spin on their own queue node and the
+ *  holder hands the lock directly to its successor
+ */
+static int stress_mcs_init(stress_lock_t *lock)
+{
+	lock->q.queue.tail = 0;
+	lock->q.queue.holder = 0;
+	lock->q.queue.pred = 0;
+	lock->q.queue.spare.next = 0;
+	lock->q.queue.spare.owner = 0;
+
+	return 0;
+}
+
+static int CONST stress_mcs_deinit(stress_lock_t *lock)
+{
+	(void)lock;
+
+	return 0;
+}
+
+static int stress_mcs_acquire(stress_lock_t *lock)
+{
+	const uint32_t idx = stress_lock_node_lock_get(lock);
+	stress_lock_node_t *node;
+	uint32_t pred;
+
+	node = &stress_lock_pool->node[idx];
+	__atomic_store_n(&node->locked, 1, __ATOMIC_RELAXED);
+	pred = stress_lock_xchg(&lock->q.queue.tail, idx);
+	if (pred) {
+		uint32_t spins = 0;
+
+		__atomic_store_n(&stress_lock_pool->node[pred].next, idx, __ATOMIC_RELEASE);
+		while (__atomic_load_n(&node->locked, __ATOMIC_ACQUIRE))
+			stress_lock_spin(&spins);
+	}
+	lock->q.queue.holder = idx;
+
+	return 0;
+}
+
+static int stress_mcs_release(stress_lock_t *lock)
+{
+	const uint32_t idx = lock->q.queue.holder;
+	stress_lock_node_t *node = &stress_lock_pool->node[idx];
+	uint32_t next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE);
+
+	if (!next) {
+		uint32_t expected = idx;
+		uint32_t spins = 0;
+
+		/* no successor, empty the queue */
+		if (__atomic_compare_exchange_n(&lock->q.queue.tail, &expected, 0, false,
+						__ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+			stress_lock_node_put(lock, idx);
+			return 0;
+		}
+		/* successor is enqueueing, wait for it to link in */
+		while ((next = __atomic_load_n(&node->next, __ATOMIC_ACQUIRE)) == 0)
+			stress_lock_spin(&spins);
+	}
+	__atomic_store_n(&stress_lock_pool->node[next].locked, 0, __ATOMIC_RELEASE);
+	stress_lock_node_put(lock, idx);
+
+	return 0;
+}
+
+static const stress_lock_funcs_t stress_lock_funcs_mcs = {
+	"mcs",
+	stress_mcs_init,
+	stress_mcs_deinit,
+	stress_mcs_acquire,
+	stress_mcs_acquire,
+	stress_mcs_release
+};
+
+/*
+ *  CLH lock, waiters spin on their predecessor's queue node,
+ *  the released predecessor node is freed by its successor.
+ *  A holder of the lock's spare node keeps its predecessor
+ *  node and swaps it in as the tail on release if there is
+ *  no successor, so the spare node is not left in the queue
+ */
+static int stress_clh_init(stress_lock_t *lock)
+{
+	/* not the spare node, that would stay in the queue */
+	const uint32_t idx = stress_lock_node_get();
+
+	if (UNLIKELY(!idx)) {
+		errno = ENOMEM;
+		return -1;
+	}
+	lock->q.queue.holder = 0;
+	lock->q.queue.pred = 0;
+	lock->q.queue.spare.next = 0;
+	lock->q.queue.spare.owner = 0;
+	stress_lock_pool->node[idx].locked = 0;
+	lock->q.queue.tail = idx;
+
+	return 0;
+}
+
+static int stress_clh_deinit(stress_lock_t *lock)
+{
+	if (lock->q.queue.tail)
+		stress_lock_node_put(lock, lock->q.queue.tail);
+	lock->q.queue.tail = 0;
+
+	return 0;
+}
+
+static int stress_clh_acquire(stress_lock_t *lock)
+{
+	const uint32_t idx = stress_lock_node_lock_get(lock);
+	uint32_t pred, spins = 0;
+
+	__atomic_store_n(&stress_lock_pool->node[idx].locked, 1, __ATOMIC_RELAXED);
+	pred = stress_lock_xchg(&lock->q.queue.tail, idx);
+	while (__atomic_load_n(&stress_lock_pool->node[pred].locked, __ATOMIC_ACQUIRE))
+		stress_lock_spin(&spins);
+	if (idx == stress_lock_node_spare(lock))
+		lock->q.queue.pred = pred;
+	else
+		stress_lock_node_put(lock, pred);
+	lock->q.queue.holder = idx;
+
+	return 0;
+}
+
+static int stress_clh_release(stress_lock_t *lock)
+{
+	const uint32_t idx = lock->q.queue.holder;
+
+	if (idx == stress_lock_node_spare(lock)) {
+		const uint32_t pred = lock->q.queue.pred;
+		uint32_t expected = idx;
+
+		/* no successor, the unlocked predecessor node becomes the tail */
+		if (__atomic_compare_exchange_n(&lock->q.queue.tail, &expected, pred, false,
+						__ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+			stress_lock_node_put(lock, idx);
+			return 0;
+		}
+		/* successor frees the spare node */
+		stress_lock_node_put(lock, pred);
+	}
+	__atomic_store_n(&stress_lock_pool->node[idx].locked, 0, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+static const stress_lock_funcs_t stress_lock_funcs_clh = {
+	"clh",
+	stress_clh_init,
+	stress_clh_deinit,
+	stress_clh_acquire,
+	stress_clh_acquire,
+	stress_clh_release
+};
+
+/*
+ *  Cohort lock, a ticket lock per NUMA node cohort and a global
+ *  ticket lock. The global lock is handed over to waiters in the
+ *  same cohort up to STRESS_LOCK_COHORT_PASSES times before it is
+ *  released to other cohorts to reduce cross node cache line traffic
+ */
+static int stress_cohort_init(stress_lock_t *lock)
+{
+	register uint32_t i;
+
+	for (i = 0; i < STRESS_LOCK_COHORT_LOCKS; i++) {
+		stress_lock_cohort_block_t *block = &stress_lock_pool->cohort[i];
+		uint32_t expected = 0;
+
+		if (__atomic_compare_exchange_n(&block->used, &expected, 1, false,
+						__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			(void)shim_memset(block->local, 0, sizeof(block->local));
+			lock->q.cohort.global.next = 0;
+			lock->q.cohort.global.owner = 0;
+			lock->q.cohort.block = i;
+			lock->q.cohort.holder = 0;
+			return 0;
+		}
+	}
+	errno = ENOMEM;
+	return -1;
+}
+
+static int stress_cohort_deinit(stress_lock_t *lock)
+{
+	__atomic_store_n(&stress_lock_pool->cohort[lock->q.cohort.block].used, 0, __ATOMIC_RELEASE);
+
+	return 0;
+}
+
+static int stress_cohort_acquire(stress_lock_t *lock)
+{
+	stress_lock_cohort_local_t *local;
+	unsigned int cpu = 0, node = 0;
+	uint32_t cohort;
+
+	if (shim_getcpu(&cpu, &node, NULL) < 0)
+		node = 0;
+	cohort = (uint32_t)node % STRESS_LOCK_COHORTS;
+	local = &stress_lock_pool->cohort[lock->q.cohort.block].local[cohort];
+
+	stress_lock_ticket_acquire(&local->ticket);
+	if (!local->global_held) {
+		stress_lock_ticket_acquire(&lock->q.cohort.global);
+		local->global_held = 1;
+	}
+	lock->q.cohort.holder = cohort;
+
+	return 0;
+}
+
+static int stress_cohort_release(stress_lock_t *lock)
+{
+	stress_lock_cohort_local_t *local =
+		&stress_lock_pool->cohort[lock->q.cohort.block].local[lock->q.cohort.holder];
+
+	/* hand the global lock to a waiter in the same cohort */
+	if (stress_lock_ticket_waiters(&local->ticket) &&
+	    (local->passes < STRESS_LOCK_COHORT_PASSES)) {
+		local->passes++;
+	} else {
+		local->passes = 0;
+		local->global_held = 0;
+		stress_lock_ticket_release(&lock->q.cohort.global);
+	}
+	stress_lock_ticket_release(&local->ticket);
+
+	return 0;
+}
+
+static const stress_lock_funcs_t stress_lock_funcs_cohort = {
+	"cohort",
+	stress_cohort_init,
+	stress_cohort_deinit,
+	stress_cohort_acquire,
+	stress_cohort_acquire,
+	stress_cohort_release
+};
+#endif
+
+static const stress_lock_funcs_t * const stress_lock_methods[] = {
+	&stress_lock_funcs,
+#if defined(HAVE_LOCK_QUEUE)
+	&stress_lock_funcs_ticket,
+	&stress_lock_funcs_mcs,
+	&stress_lock_funcs_clh,
+	&stress_lock_funcs_cohort,
+#endif
+};
+
+/*
+ *  stress_lock_method()
+ *	return name of the i'th lock method, NULL if out of range,
+ *	method 0 is the default build time selected lock
+ */
+const char *stress_lock_method(const size_t i)
+{
+	if (i == 0)
+		return "default";
+	return (i < SIZEOF_ARRAY(stress_lock_methods)) ? stress_lock_methods[i]->type : NULL;
+}
+
+/*
+ *  stress_lock_type()
+ *	return the lock type name of a lock
+ */
+const char *stress_lock_type(void *lock_handle)
+{
+	const stress_lock_t *lock = (stress_lock_t *)lock_handle;
+
+	if (LIKELY(stress_lock_valid(lock)))
+		return stress_lock_methods[lock->method]->type;
+	return "unknown";
+}
+
+/*
+ *  stress_lock_create_method()
+ *	generic lock creation and initialization using
+ *	lock method, see stress_lock_method()
+ */
+void *stress_lock_create_method(const char *name, const size_t method)
 {
 	stress_lock_t *lock;
 
@@ -618,17 +1150,41 @@ void *stress_lock_create(const char *name)
 		return NULL;
 	}
 
+	if (UNLIKELY(method >= SIZEOF_ARRAY(stress_lock_methods))) {
+		errno = EINVAL;
+		return NULL;
+	}
+#if defined(HAVE_LOCK_QUEUE)
+	if (UNLIKELY((method != 0) && !stress_lock_pool)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+#endif
+
 	lock = stress_lock_get();
 	if (UNLIKELY(!lock))
 		return NULL;
 
-	if (LIKELY(stress_lock_funcs.init(lock) == 0))
+	lock->method = (uint32_t)method;
+	if (LIKELY(stress_lock_methods[method]->init(lock) == 0))
 		return lock;
 
-	VOID_RET(int, stress_lock_destroy(lock));
+	/* init failed, don't deinit */
+	lock->method = 0;
+	VOID_RET(int, stress_lock_put(lock));
 	return NULL;
 }
 
+/*
+ *  stress_lock_create()
+ *	generic lock creation and initialization using the
+ *	--lock-method lock method, used by the stressors
+ */
+void *stress_lock_create(const char *name)
+{
+	return stress_lock_create_method(name, stress_lock_method_default);
+}
+
 /*
  *  stress_lock_destroy()
  *	generic lock destruction
@@ -638,7 +1194,7 @@ int stress_lock_destroy(void *lock_handle)
 	stress_lock_t *lock = (stress_lock_t *)lock_handle;
 
 	if (LIKELY(stress_lock_valid(lock))) {
-		(void)stress_lock_funcs.deinit(lock);
+		(void)stress_lock_methods[lock->method]->deinit(lock);
 		return stress_lock_put(lock);
 	}
 	errno = EINVAL;
@@ -654,7 +1210,7 @@ int stress_lock_acquire(void *lock_handle)
 	stress_lock_t *lock = (stress_lock_t *)lock_handle;
 
 	if (LIKELY(stress_lock_valid(lock)))
-		return stress_lock_funcs.acquire(lock);
+		return stress_lock_methods[lock->method]->acquire(lock);
 
 	errno = EINVAL;
 	return -1;
@@ -669,7 +1225,7 @@ int stress_lock_acquire_relax(void *lock_handle)
 	stress_lock_t *lock = (stress_lock_t *)lock_handle;
 
 	if (LIKELY(stress_lock_valid(lock)))
-		return stress_lock_funcs.acquire_relax(lock);
+		return stress_lock_methods[lock->method]->acquire_relax(lock);
 
 	errno = EINVAL;
 	return -1;
@@ -684,7 +1240,7 @@ int stress_lock_release(void *lock_handle)
 	stress_lock_t *lock = (stress_lock_t *)lock_handle;
 
 	if (LIKELY(stress_lock_valid(lock)))
-		return stress_lock_funcs.release(lock);
+		return stress_lock_methods[lock->method]->release(lock);
 
 	errno = EINVAL;
 	return -1;
@@ -744,7 +1300,7 @@ static int stress_lock_put(stress_lock_t *lock)
 
 /*
  *  stress_lock_mem_map()
- *	mmap 1 page of shared locks
+ *	mmap shared locks and the shared queue lock pool
  */
 int stress_lock_mem_map(void)
 {
@@ -763,6 +1319,22 @@ int stress_lock_mem_map(void)
 	stress_lock_funcs.init(stress_lock_big_lock);
 	stress_lock_big_lock->magic = STRESS_LOCK_MAGIC;
 
+	(void)stress_setting_get("lock-method", &stress_lock_method_default);
+	if (stress_lock_method_default >= SIZEOF_ARRAY(stress_lock_methods))
+		stress_lock_method_default = 0;
+
+#if defined(HAVE_LOCK_QUEUE)
+	stress_lock_pool = (stress_lock_pool_t *)stress_mmap_anon_shared(sizeof(*stress_lock_pool), PROT_READ | PROT_WRITE);
+	if (UNLIKELY(stress_lock_pool == MAP_FAILED)) {
+		stress_lock_pool = NULL;
+		if (stress_lock_method_default != 0) {
+			pr_inf("core-lock: cannot mmap queue lock pool, using default locks\n");
+			stress_lock_method_default = 0;
+		}
+	} else {
+		stress_memory_anon_name_set(stress_lock_pool, sizeof(*stress_lock_pool), "lock-pool");
+	}
+#endif
 	return 0;
 }
 
@@ -777,5 +1349,11 @@ void stress_lock_mem_unmap(void)
 	(void)stress_munmap_anon_shared((void *)stress_locks, mmap_size);
 	stress_locks = NULL;
 	stress_lock_big_lock = NULL;
+#if defined(HAVE_LOCK_QUEUE)
+	if (stress_lock_pool) {
+		(void)stress_munmap_anon_shared((void *)stress_lock_pool, sizeof(*stress_lock_pool));
+		stress_lock_pool = NULL;
+	}
+#endif
 }
 
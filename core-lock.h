@@ -22,7 +22,10 @@
 extern int stress_lock_mem_map(void);
 extern void stress_lock_mem_unmap(void);
 
+extern const char *stress_lock_method(const size_t i);
+extern const char *stress_lock_type(void *lock_handle);
 extern void *stress_lock_create(const char *name);
+extern void *stress_lock_create_method(const char *name, const size_t method);
 extern int stress_lock_destroy(void *lock_handle);
 extern int stress_lock_acquire(void *lock_handle);
 extern int stress_lock_acquire_relax(void *lock_handle);
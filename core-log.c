@@ -142,12 +142,15 @@ void pr_block_begin(void)
  */
 void pr_block_end(void)
 {
-	if (pr_msg_buf.buf && (pr_msg_buf.pid == getpid())) {
+	if (pr_msg_buf.pid != getpid())
+		return;
+	if (pr_msg_buf.buf) {
 		pr_log_write_buf(pr_msg_buf.buf, shim_strlen(pr_msg_buf.buf));
 		free(pr_msg_buf.buf);
 		pr_msg_buf.buf = NULL;
-		pr_msg_buf.pid = -1;
 	}
+	/* an empty block must not leave later messages buffered */
+	pr_msg_buf.pid = -1;
 }
 
 /*
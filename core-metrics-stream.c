@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2026 Colin Ian King.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include "stress-ng.h"
+#include "core-builtin.h"
+#include "core-killpid.h"
+#include "core-metrics-stream.h"
+
+#include <float.h>
+
+#define METRICS_STREAM_CSV	(0)
+#define METRICS_STREAM_JSON	(1)
+
+static pid_t metrics_stream_pid = -1;
+
+/*
+ *  stress_metrics_stream_format()
+ *	select JSON lines format for .json and .jsonl files,
+ *	otherwise default to CSV
+ */
+static int stress_metrics_stream_format(const char *filename)
+{
+	const char *ext = shim_strrchr(filename, '.');
+
+	if (ext && (!shim_strcmp(ext, ".json") || !shim_strcmp(ext, ".jsonl")))
+		return METRICS_STREAM_JSON;
+	return METRICS_STREAM_CSV;
+}
+
+/*
+ *  stress_metrics_stream_json_string()
+ *	write str as a quoted JSON string, escaping quotes,
+ *	backslashes and control characters
+ */
+static void stress_metrics_stream_json_string(FILE *fp, const char *str)
+{
+	const unsigned char *ptr;
+
+	(void)fputc('"', fp);
+	for (ptr = (const unsigned char *)str; *ptr; ptr++) {
+		switch (*ptr) {
+		case '"':
+			(void)fputs("\\\"", fp);
+			break;
+		case '\\':
+			(void)fputs("\\\\", fp);
+			break;
+		case '\n':
+			(void)fputs("\\n", fp);
+			break;
+		case '\r':
+			(void)fputs("\\r", fp);
+			break;
+		case '\t':
+			(void)fputs("\\t", fp);
+			break;
+		default:
+			if (*ptr < 0x20)
+				(void)fprintf(fp, "\\u%04x", (unsigned int)*ptr);
+			else
+				(void)fputc(*ptr, fp);
+			break;
+		}
+	}
+	(void)fputc('"', fp);
+}
+
+/*
+ *  stress_metrics_stream_sample()
+ *	sample the bogo-op counters of all the instances of all
+ *	the stressors and write a record per active stressor
+ */
+static void stress_metrics_stream_sample(
+	FILE *fp,
+	const int format,
+	stress_list_item_t *stressors_list,
+	uint64_t *counters,
+	const double t_now,
+	const double t_elapsed,
+	const double t_delta)
+{
+	stress_list_item_t *item;
+	const double scale = (t_delta > 0.0) ? 1.0 / t_delta : 0.0;
+
+	for (item = stressors_list; item; item = item->next) {
+		int32_t i;
+		uint32_t running = 0;
+		uint64_t total = 0, delta_total = 0;
+		double rate_min = DBL_MAX, rate_max = 0.0;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+
+		for (i = 0; i < item->instances; i++, counters++) {
+			const stress_stats_t *stats = item->stats[i];
+			const uint64_t counter = stats->args.bogo.count.counter;
+			/* counter is reset when a stressor is re-run */
+			const uint64_t delta = (counter >= *counters) ? counter - *counters : counter;
+			const bool active = (stats->s_pid.pid > 0) && !stats->s_pid.reaped;
+
+			*counters = counter;
+			total += counter;
+			delta_total += delta;
+			if (active || delta) {
+				const double rate = (double)delta * scale;
+
+				if (rate_min > rate)
+					rate_min = rate;
+				if (rate_max < rate)
+					rate_max = rate;
+				running++;
+			}
+		}
+		if (!running)
+			continue;
+
+		if (format == METRICS_STREAM_JSON) {
+			(void)fprintf(fp, "{\"time\":%.3f,\"elapsed\":%.3f,\"stressor\":",
+				t_now, t_elapsed);
+			stress_metrics_stream_json_string(fp, item->stressor->name);
+			(void)fprintf(fp, ",\"instances\":%" PRIu32 ",\"bogo-ops\":%" PRIu64 ","
+				"\"bogo-ops-per-second\":%.3f,"
+				"\"min-instance-bogo-ops-per-second\":%.3f,"
+				"\"max-instance-bogo-ops-per-second\":%.3f}\n",
+				running, total, (double)delta_total * scale, rate_min, rate_max);
+		} else {
+			(void)fprintf(fp, "%.3f,%.3f,%s,%" PRIu32 ",%" PRIu64 ",%.3f,%.3f,%.3f\n",
+				t_now, t_elapsed, item->stressor->name, running, total,
+				(double)delta_total * scale, rate_min, rate_max);
+		}
+	}
+}
+
+/*
+ *  stress_metrics_stream_start()
+ *	start a child process that periodically samples the
+ *	bogo-op counters of all the stressor instances and
+ *	streams interval bogo-op rates to a CSV or JSON lines file
+ */
+void stress_metrics_stream_start(stress_list_item_t *stressors_list)
+{
+	FILE *fp;
+	char *filename = NULL;
+	int32_t interval = 1;
+	size_t n_instances = 0;
+	stress_list_item_t *item;
+	uint64_t *counters;
+	int format;
+	double t_start, t_next, t_last;
+
+	if (!stress_setting_get("metrics-stream", &filename)) {
+		if (stress_setting_get("metrics-interval", &interval))
+			pr_inf("metrics-stream: --metrics-interval ignored, no --metrics-stream file specified\n");
+		return;
+	}
+	(void)stress_setting_get("metrics-interval", &interval);
+	if (interval < 1)
+		interval = 1;
+
+	fp = fopen(filename, "w");
+	if (!fp) {
+		pr_err("metrics-stream: cannot open file '%s', errno=%d (%s)\n",
+			filename, errno, strerror(errno));
+		return;
+	}
+
+	for (item = stressors_list; item; item = item->next) {
+		if (!item->ignore.run && item->stats)
+			n_instances += (size_t)item->instances;
+	}
+
+	metrics_stream_pid = fork();
+	if (metrics_stream_pid < 0) {
+		pr_err("metrics-stream: fork failed, errno=%d (%s)\n",
+			errno, strerror(errno));
+		(void)fclose(fp);
+		return;
+	} else if (metrics_stream_pid > 0) {
+		(void)fclose(fp);
+		return;
+	}
+
+	stress_parent_died_alarm();
+	stress_proc_name_set("stat [metrics]");
+
+	counters = (uint64_t *)calloc(n_instances ? n_instances : 1, sizeof(*counters));
+	if (!counters) {
+		pr_err("metrics-stream: cannot allocate %zu counters, skipping metrics streaming\n",
+			n_instances);
+		(void)fclose(fp);
+		_exit(0);
+	}
+
+	format = stress_metrics_stream_format(filename);
+	if (format == METRICS_STREAM_CSV) {
+		(void)fprintf(fp, "time,elapsed,stressor,instances,bogo-ops,"
+			"bogo-ops-per-second,min-instance-bogo-ops-per-second,"
+			"max-instance-bogo-ops-per-second\n");
+		(void)fflush(fp);
+	}
+
+	t_start = stress_time_now();
+	t_next = t_start;
+	t_last = t_start;
+
+	while (stress_continue_flag()) {
+		double t_now, delta;
+
+		t_next += (double)interval;
+		delta = t_next - stress_time_now();
+		if (delta > 0.0)
+			(void)shim_nanosleep_uint64((uint64_t)(delta * STRESS_DBL_NANOSECOND));
+
+		t_now = stress_time_now();
+		stress_metrics_stream_sample(fp, format, stressors_list, counters,
+			t_now, t_now - t_start, t_now - t_last);
+		t_last = t_now;
+		(void)fflush(fp);
+	}
+	free(counters);
+	(void)fclose(fp);
+	_exit(0);
+}
+
+/*
+ *  stress_metrics_stream_stop()
+ *	stop metrics streaming child process
+ */
+void stress_metrics_stream_stop(void)
+{
+	if (metrics_stream_pid > 0) {
+		(void)stress_kill_pid_wait(metrics_stream_pid, NULL);
+		metrics_stream_pid = -1;
+	}
+}
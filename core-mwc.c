@@ -24,6 +24,7 @@
 #include "core-cpu-cache.h"
 #include "core-helper.h"
 #include "core-mwc.h"
+#include "core-target-clones.h"
 
 #if defined(HAVE_SYS_AUXV_H)
 #include <sys/auxv.h>
@@ -37,6 +38,10 @@
 #define STRESS_MWC_SEED_W	(521288629UL)
 #define STRESS_MWC_SEED_Z	(362436069UL)
 
+/* stress_mwc_fill() independent MWC lanes, and smallest fill using them */
+#define STRESS_MWC_LANES	(8)
+#define STRESS_MWC_FILL_MIN	(STRESS_MWC_LANES * sizeof(uint32_t) * 4)
+
 /* Fast random number generator state */
 typedef struct {
 	uint32_t w;
@@ -49,6 +54,11 @@ typedef struct {
 	uint32_t saved1;
 } stress_mwc_t;
 
+stress_mwc_buffer_t g_mwc_buffer = {
+	STRESS_MWC_BUFFER_SIZE,		/* empty, filled on first use */
+	{ 0 },
+};
+
 static stress_mwc_t mwc = {
 	STRESS_MWC_SEED_W,
 	STRESS_MWC_SEED_Z,
@@ -72,6 +82,7 @@ static inline void mwc_flush(void)
 	mwc.saved16 = 0;
 	mwc.saved8 = 0;
 	mwc.saved1 = 0;
+	g_mwc_buffer.index = STRESS_MWC_BUFFER_SIZE;
 }
 
 #if defined(HAVE_SYS_AUXV_H) && \
@@ -543,3 +554,110 @@ void OPTIMIZE3 stress_uint8rnd4(uint8_t *data, const size_t len)
 	while (ptr8 < ptr8end)
 		*ptr8++ = stress_mwc8();
 }
+
+/*
+ *  stress_mwc_lanes_fill()
+ *	fill n 32 bit words with STRESS_MWC_LANES interleaved
+ *	multiply-with-carry generators. The lanes do not depend
+ *	on each other so the lane updates can be vectorized.
+ */
+static void TARGET_CLONES OPTIMIZE3 stress_mwc_lanes_fill(
+	uint32_t *RESTRICT data,
+	const size_t n,
+	uint32_t *RESTRICT z,
+	uint32_t *RESTRICT w)
+{
+	uint32_t lz[STRESS_MWC_LANES] ALIGN64, lw[STRESS_MWC_LANES] ALIGN64;
+	register size_t i;
+
+	(void)shim_memcpy(lz, z, sizeof(lz));
+	(void)shim_memcpy(lw, w, sizeof(lw));
+	for (i = 0; i + STRESS_MWC_LANES <= n; i += STRESS_MWC_LANES) {
+		register size_t j;
+
+		for (j = 0; j < STRESS_MWC_LANES; j++) {
+			lz[j] = 36969 * (lz[j] & 65535) + (lz[j] >> 16);
+			lw[j] = 18000 * (lw[j] & 65535) + (lw[j] >> 16);
+			data[i + j] = (lz[j] << 16) + lw[j];
+		}
+	}
+	(void)shim_memcpy(z, lz, sizeof(lz));
+	(void)shim_memcpy(w, lw, sizeof(lw));
+}
+
+/*
+ *  stress_mwc_lanes_seed()
+ *	seed the lanes from the mwc generator, avoiding the
+ *	MWC zero and fixed point states
+ */
+static void stress_mwc_lanes_seed(uint32_t *z, uint32_t *w)
+{
+	size_t i;
+
+	for (i = 0; i < STRESS_MWC_LANES; i++) {
+		z[i] = stress_mwc32();
+		w[i] = stress_mwc32();
+		if ((z[i] == 0) || (z[i] == 0x9068ffff))
+			z[i] = STRESS_MWC_SEED_Z + (uint32_t)i;
+		if ((w[i] == 0) || (w[i] == 0x464fffff))
+			w[i] = STRESS_MWC_SEED_W + (uint32_t)i;
+	}
+}
+
+/*
+ *  stress_mwc_fill()
+ *	fast bulk fill of a buffer with pseudorandom data using
+ *	independent multi-lane MWC generators. The lanes are seeded
+ *	from the mwc generator so the data is reproducible for a
+ *	given seed, but it differs from the data generated by
+ *	stress_rndbuf() and stress_uint8rnd4(); small buffers are
+ *	filled by stress_uint8rnd4().
+ */
+void OPTIMIZE3 stress_mwc_fill(void *buf, const size_t len)
+{
+	uint32_t z[STRESS_MWC_LANES], w[STRESS_MWC_LANES];
+	register uint8_t *ptr8 = (uint8_t *)buf;
+	register const uint8_t *ptr8end = ptr8 + len;
+	uint32_t *ptr32;
+	size_t i, n;
+
+	if (UNLIKELY(!buf))
+		return;
+	if (len < STRESS_MWC_FILL_MIN) {
+		stress_uint8rnd4((uint8_t *)buf, len);
+		return;
+	}
+
+	/* fill unaligned bytes to 32 bit boundary */
+	while ((uintptr_t)ptr8 & 3)
+		*ptr8++ = stress_mwc8();
+
+	stress_mwc_lanes_seed(z, w);
+	ptr32 = (uint32_t *)shim_assume_aligned(ptr8, 4);
+	n = ((size_t)(ptr8end - ptr8) >> 2) & ~(size_t)(STRESS_MWC_LANES - 1);
+	stress_mwc_lanes_fill(ptr32, n, z, w);
+	if (!stress_little_endian()) {
+		for (i = 0; i < n; i++)
+			ptr32[i] = stress_bitops_swap32(ptr32[i]);
+	}
+
+	/* fill remaining bytes */
+	ptr8 = (uint8_t *)(ptr32 + n);
+	while (ptr8 < ptr8end)
+		*ptr8++ = stress_mwc8();
+}
+
+/*
+ *  stress_mwc_buffer_refill()
+ *	refill the per process random value buffer in one
+ *	multi-lane pass, lanes are seeded from the mwc generator
+ *	so the buffered values are reproducible for a given seed
+ */
+void OPTIMIZE3 stress_mwc_buffer_refill(void)
+{
+	uint32_t z[STRESS_MWC_LANES], w[STRESS_MWC_LANES];
+
+	stress_mwc_lanes_seed(z, w);
+	stress_mwc_lanes_fill(g_mwc_buffer.data, STRESS_MWC_BUFFER_SIZE, z, w);
+	g_mwc_buffer.index = 0;
+}
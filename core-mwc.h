@@ -32,6 +32,16 @@
  */
 #define HAVE_FAST_MODULO_REDUCTION
 
+#define STRESS_MWC_BUFFER_SIZE	(256)	/* pre-generated values per buffer refill */
+
+/* Per process buffer of pre-generated 32 bit random values */
+typedef struct {
+	uint32_t index;			/* next value, empty if STRESS_MWC_BUFFER_SIZE */
+	uint32_t data[STRESS_MWC_BUFFER_SIZE] ALIGN64;	/* random values */
+} stress_mwc_buffer_t;
+
+extern stress_mwc_buffer_t g_mwc_buffer;
+
 extern void stress_mwc_reseed(void);
 extern void stress_mwc_seed_set(const uint32_t w, const uint32_t z);
 extern void stress_mwc_seed_get(uint32_t *w, uint32_t *z);
@@ -49,6 +59,8 @@ extern __uint128_t stress_mwc128(void);
 extern void stress_rndbuf(void *buf, const size_t len);
 extern void stress_rndstr(char *str, const size_t len);
 extern void stress_uint8rnd4(uint8_t *data, const size_t len);
+extern void stress_mwc_fill(void *buf, const size_t len);
+extern void stress_mwc_buffer_refill(void);
 
 #if defined(HAVE_FAST_MODULO_REDUCTION)
 /*
@@ -104,6 +116,38 @@ static inline uint64_t stress_mwc64modn(const uint64_t max)
 extern uint64_t stress_mwc64modn(const uint64_t max);
 #endif
 
+/*
+ *  stress_mwc32_next_buffered()
+ *	get the next 32 bit pseudo random number from the per
+ *	process buffer, refilling the buffer when it is empty
+ */
+static inline uint32_t ALWAYS_INLINE stress_mwc32_next_buffered(void)
+{
+	if (g_mwc_buffer.index >= STRESS_MWC_BUFFER_SIZE)
+		stress_mwc_buffer_refill();
+	return g_mwc_buffer.data[g_mwc_buffer.index++];
+}
+
+/*
+ *  stress_mwc32modn_buffered()
+ *	buffered stress_mwc32modn(), multiply-shift reduction,
+ *	return 32 bit non-modulo biased value 0..max - 1
+ */
+static inline uint32_t ALWAYS_INLINE stress_mwc32modn_buffered(const uint32_t max)
+{
+	return (uint32_t)(((uint64_t)stress_mwc32_next_buffered() * (uint64_t)max) >> 32);
+}
+
+/*
+ *  stress_mwc8modn_buffered()
+ *	buffered stress_mwc8modn(), multiply-shift reduction,
+ *	return 8 bit non-modulo biased value 0..max - 1
+ */
+static inline uint8_t ALWAYS_INLINE stress_mwc8modn_buffered(const uint8_t max)
+{
+	return (uint8_t)(((uint64_t)stress_mwc32_next_buffered() * (uint64_t)max) >> 32);
+}
+
 /*
  *  stress_mwcsizemodn()
  *	return size_t sized non-modulo biased value 1..max (inclusive)
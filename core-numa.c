@@ -19,6 +19,7 @@
 #include "stress-ng.h"
 #include "core-attribute.h"
 #include "core-builtin.h"
+#include "core-filesystem.h"
 #include "core-numa.h"
 
 #if defined(HAVE_LINUX_MEMPOLICY_H)
@@ -242,6 +243,57 @@ void stress_numa_mask_nodes_free(
 	stress_numa_mask_free(numa_nodes);
 }
 
+/*
+ *  stress_numa_node_cpus_get()
+ *	get an uint32_t array of the cpu numbers of the cpus on
+ *	NUMA node node, returns the number of cpus, 0 if the node
+ *	has no cpus or the cpu list cannot be read
+ */
+uint32_t stress_numa_node_cpus_get(const long int node, uint32_t **cpus)
+{
+	char path[PATH_MAX];
+	char buf[4096];
+	const char *ptr;
+	const uint32_t max_cpus = (uint32_t)stress_cpus_configured_get();
+	uint32_t n = 0;
+
+	*cpus = NULL;
+	(void)snprintf(path, sizeof(path), "/sys/devices/system/node/node%ld/cpulist", node);
+	if ((max_cpus < 1) || (stress_fs_file_read(path, buf, sizeof(buf)) < 1))
+		return 0;
+
+	*cpus = (uint32_t *)calloc((size_t)max_cpus, sizeof(**cpus));
+	if (UNLIKELY(!*cpus))
+		return 0;
+
+	/* parse comma separated cpu numbers and ranges, e.g. 0-3,8,10-11 */
+	for (ptr = buf; *ptr; ptr++) {
+		char *end;
+		unsigned long int lo, hi;
+
+		lo = strtoul(ptr, &end, 10);
+		if (end == ptr)
+			break;
+		hi = lo;
+		ptr = end;
+		if (*ptr == '-') {
+			hi = strtoul(ptr + 1, &end, 10);
+			if (end == ptr + 1)
+				break;
+			ptr = end;
+		}
+		for (; (lo <= hi) && (n < max_cpus); lo++)
+			(*cpus)[n++] = (uint32_t)lo;
+		if (*ptr != ',')
+			break;
+	}
+	if (n == 0) {
+		free(*cpus);
+		*cpus = NULL;
+	}
+	return n;
+}
+
 #if defined(__NR_get_mempolicy) &&      \
     defined(__NR_mbind) &&              \
     defined(__NR_migrate_pages) &&      \
@@ -70,6 +70,8 @@ const struct option stress_long_options[] = {
 
 	{ "autogroup",		0,	NULL,	OPT_autogroup },
 
+	{ "baseline",		1,	NULL,	OPT_baseline },
+
 	{ "bad-altstack",	1,	NULL,	OPT_bad_altstack },
 	{ "bad-altstack-ops",	1,	NULL,	OPT_bad_altstack_ops },
 
@@ -374,6 +376,8 @@ const struct option stress_long_options[] = {
 	{ "fallocate-bytes",	1,	NULL,	OPT_fallocate_bytes },
 	{ "fallocate-ops",	1,	NULL,	OPT_fallocate_ops },
 
+	{ "fairness",		0,	NULL,	OPT_fairness },
+
 	{ "fanotify",		1,	NULL,	OPT_fanotify },
 	{ "fanotify-ops",	1,	NULL,	OPT_fanotify_ops },
 
@@ -383,6 +387,8 @@ const struct option stress_long_options[] = {
 	{ "far-branch-pageout",	0,	NULL,	OPT_far_branch_pageout },
 	{ "far-branch-pages",	1,	NULL,	OPT_far_branch_pages },
 
+	{ "fast-launch",	0,	NULL,	OPT_fast_launch },
+
 	{ "fault",		1,	NULL,	OPT_fault },
 	{ "fault-ops",		1,	NULL,	OPT_fault_ops },
 
@@ -541,6 +547,7 @@ const struct option stress_long_options[] = {
 	{ "handle-ops",		1,	NULL,	OPT_handle_ops },
 
 	{ "hash",		1,	NULL,	OPT_hash },
+	{ "hash-bulk",		1,	NULL,	OPT_hash_bulk },
 	{ "hash-method",	1,	NULL,	OPT_hash_method },
 	{ "hash-ops",		1,	NULL,	OPT_hash_ops },
 
@@ -692,6 +699,8 @@ const struct option stress_long_options[] = {
 	{ "landlock",		1,	NULL,	OPT_landlock },
 	{ "landlock-ops",	1,	NULL,	OPT_landlock_ops },
 
+	{ "latency-histogram",	0,	NULL,	OPT_latency_histogram },
+
 	{ "led",		1,	NULL,	OPT_led },
 	{ "led-ops",		1,	NULL,	OPT_led_ops },
 
@@ -733,6 +742,8 @@ const struct option stress_long_options[] = {
 	{ "lockbus-nosplit",	0,	NULL,	OPT_lockbus_nosplit },
 	{ "lockbus-ops",	1,	NULL,	OPT_lockbus_ops },
 
+	{ "lock-method",	1,	NULL,	OPT_lock_method },
+
 	{ "lockf",		1,	NULL,	OPT_lockf },
 	{ "lockf-nonblock", 	0,	NULL,	OPT_lockf_nonblock },
 	{ "lockf-ops",		1,	NULL,	OPT_lockf_ops },
@@ -814,6 +825,8 @@ const struct option stress_long_options[] = {
 	{ "memcpy",		1,	NULL,	OPT_memcpy },
 	{ "memcpy-method",	1,	NULL,	OPT_memcpy_method },
 	{ "memcpy-ops",		1,	NULL,	OPT_memcpy_ops },
+	{ "memcpy-sweep",	0,	NULL,	OPT_memcpy_sweep },
+	{ "memcpy-sweep-max",	1,	NULL,	OPT_memcpy_sweep_max },
 
 	{ "memfd",		1,	NULL,	OPT_memfd },
 	{ "memfd-bytes",	1,	NULL,	OPT_memfd_bytes },
@@ -832,6 +845,7 @@ const struct option stress_long_options[] = {
 	{ "memrate-bytes",	1,	NULL,	OPT_memrate_bytes },
 	{ "memrate-discontiguous", 0,	NULL,	OPT_memrate_discontiguous },
 	{ "memrate-flush",	0,	NULL,	OPT_memrate_flush },
+	{ "memrate-latency",	0,	NULL,	OPT_memrate_latency },
 	{ "memrate-method",	1,	NULL,	OPT_memrate_method },
 	{ "memrate-ops",	1,	NULL,	OPT_memrate_ops },
 	{ "memrate-rd-mbs",	1,	NULL,	OPT_memrate_rd_mbs },
@@ -852,6 +866,8 @@ const struct option stress_long_options[] = {
 
 	{ "metrics",		0,	NULL,	OPT_metrics },
 	{ "metrics-brief",	0,	NULL,	OPT_metrics_brief },
+	{ "metrics-interval",	1,	NULL,	OPT_metrics_interval },
+	{ "metrics-stream",	1,	NULL,	OPT_metrics_stream },
 
 	{ "mincore",		1,	NULL,	OPT_mincore },
 	{ "mincore-ops",	1,	NULL,	OPT_mincore_ops },
@@ -1000,6 +1016,7 @@ const struct option stress_long_options[] = {
 
 	{ "mutex",		1,	NULL,	OPT_mutex },
 	{ "mutex-affinity",	0,	NULL,	OPT_mutex_affinity },
+	{ "mutex-lock",		1,	NULL,	OPT_mutex_lock },
 	{ "mutex-ops",		1,	NULL,	OPT_mutex_ops },
 	{ "mutex-procs",	1,	NULL,	OPT_mutex_procs },
 
@@ -1100,6 +1117,8 @@ const struct option stress_long_options[] = {
 #if defined(STRESS_PERF_STATS) && 	\
     defined(HAVE_LINUX_PERF_EVENT_H)
 	{ "perf",		0,	NULL,	OPT_perf_stats },
+	{ "perf-interval",	1,	NULL,	OPT_perf_interval },
+	{ "perf-topdown",	0,	NULL,	OPT_perf_topdown },
 #endif
 
 	{ "permute",		1,	NULL,	OPT_permute },
@@ -1197,7 +1216,10 @@ const struct option stress_long_options[] = {
 
 	{ "ptr-chase",		1,	NULL,	OPT_ptr_chase },
 	{ "ptr-chase-ops",	1,	NULL,	OPT_ptr_chase_ops },
+	{ "ptr-chase-hugepages",	0,	NULL,	OPT_ptr_chase_hugepages },
 	{ "ptr-chase-pages",	1,	NULL,	OPT_ptr_chase_pages },
+	{ "ptr-chase-sweep",	0,	NULL,	OPT_ptr_chase_sweep },
+	{ "ptr-chase-sweep-max",	1,	NULL,	OPT_ptr_chase_sweep_max },
 
 
 	{ "pty",		1,	NULL,	OPT_pty },
@@ -1273,6 +1295,8 @@ const struct option stress_long_options[] = {
 	{ "regex",		1,	NULL,	OPT_regex },
 	{ "regex-ops",		1,	NULL,	OPT_regex_ops },
 
+	{ "regress-threshold",	1,	NULL,	OPT_regress_threshold },
+
 	{ "regs",		1,	NULL,	OPT_regs },
 	{ "regs-bitflip",	0,	NULL,	OPT_regs_bitflip },
 	{ "regs-ops",		1,	NULL,	OPT_regs_ops },
@@ -1285,6 +1309,9 @@ const struct option stress_long_options[] = {
 	{ "rename",		1,	NULL,	OPT_rename },
 	{ "rename-ops",		1,	NULL,	OPT_rename_ops },
 
+	{ "repeat",		1,	NULL,	OPT_repeat },
+	{ "repeat-ci-width",	1,	NULL,	OPT_repeat_ci_width },
+
 	{ "resched",		1,	NULL,	OPT_resched },
 	{ "resched-ops",	1,	NULL,	OPT_resched_ops },
 
@@ -1328,6 +1355,10 @@ const struct option stress_long_options[] = {
 	{ "rtc",		1,	NULL,	OPT_rtc },
 	{ "rtc-ops",		1,	NULL,	OPT_rtc_ops },
 
+	{ "sampler",		1,	NULL,	OPT_sampler },
+
+	{ "scale-search",	0,	NULL,	OPT_scale_search },
+
 	{ "sched",		1,	NULL,	OPT_sched },
 	{ "sched-deadline",	1,	NULL,	OPT_sched_deadline },
 	{ "sched-period",	1,	NULL,	OPT_sched_period },
@@ -1529,6 +1560,8 @@ const struct option stress_long_options[] = {
 	{ "softlockup",		1,	NULL,	OPT_softlockup },
 	{ "softlockup-ops",	1,	NULL,	OPT_softlockup_ops },
 
+	{ "sort-data",		1,	NULL,	OPT_sort_data },
+
 	{ "sparsematrix",	1,	NULL,	OPT_sparsematrix },
 	{ "sparsematrix-items",	1,	NULL,	OPT_sparsematrix_items },
 	{ "sparsematrix-method",1,	NULL,	OPT_sparsematrix_method },
@@ -1563,6 +1596,8 @@ const struct option stress_long_options[] = {
 	{ "stackmmap",		1,	NULL,	OPT_stackmmap },
 	{ "stackmmap-ops",	1,	NULL,	OPT_stackmmap_ops },
 
+	{ "stall-detect",	1,	NULL,	OPT_stall_detect },
+
 	{ "statmount",		1,	NULL,	OPT_statmount },
 	{ "statmount-ops",	1,	NULL,	OPT_statmount_ops },
 
@@ -1581,7 +1616,9 @@ const struct option stress_long_options[] = {
 	{ "stream-index",	1,	NULL,	OPT_stream_index },
 	{ "stream-l3-size",	1,	NULL,	OPT_stream_l3_size },
 	{ "stream-madvise",	1,	NULL,	OPT_stream_madvise },
+	{ "stream-method",	1,	NULL,	OPT_stream_method },
 	{ "stream-mlock",	0,	NULL,	OPT_stream_mlock },
+	{ "stream-numa",	0,	NULL,	OPT_stream_numa },
 	{ "stream-ops",		1,	NULL,	OPT_stream_ops },
 	{ "stream-prefetch",	0,	NULL,	OPT_stream_prefetch },
 
@@ -1863,6 +1900,8 @@ const struct option stress_long_options[] = {
 	{ "waitcpu",		1,	NULL,	OPT_waitcpu },
 	{ "waitcpu-ops",	1,	NULL,	OPT_waitcpu_ops },
 
+	{ "warmup",		1,	NULL,	OPT_warmup },
+
 	{ "watchdog",		1,	NULL,	OPT_watchdog },
 	{ "watchdog-ops",	1,	NULL,	OPT_watchdog_ops },
 
@@ -83,12 +83,12 @@
 #define OPT_FLAGS_MAKE_IT_FAIL	 STRESS_BIT_ULL(51)	/* --make-it-fail */
 #define OPT_FLAGS_EXERCISED	 STRESS_BIT_ULL(52)	/* --exercised */
 #define OPT_FLAGS_IOS		 STRESS_BIT_ULL(53)	/* --ios */
-#define OPT_FLAGS_SPARE_54	 STRESS_BIT_ULL(54)
-#define OPT_FLAGS_SPARE_55	 STRESS_BIT_ULL(55)
+#define OPT_FLAGS_LATENCY_HISTOGRAM STRESS_BIT_ULL(54)	/* --latency-histogram */
+#define OPT_FLAGS_FAIRNESS	 STRESS_BIT_ULL(55)	/* --fairness */
 
-#define OPT_FLAGS_SPARE_56	 STRESS_BIT_ULL(56)
-#define OPT_FLAGS_SPARE_57	 STRESS_BIT_ULL(57)
-#define OPT_FLAGS_SPARE_58	 STRESS_BIT_ULL(58)
+#define OPT_FLAGS_SCALE_SEARCH	 STRESS_BIT_ULL(56)	/* --scale-search */
+#define OPT_FLAGS_PERF_TOPDOWN	 STRESS_BIT_ULL(57)	/* --perf-topdown */
+#define OPT_FLAGS_FAST_LAUNCH	 STRESS_BIT_ULL(58)	/* --fast-launch */
 #define OPT_FLAGS_SPARE_59	 STRESS_BIT_ULL(59)
 #define OPT_FLAGS_SPARE_60	 STRESS_BIT_ULL(60)
 #define OPT_FLAGS_SPARE_61	 STRESS_BIT_ULL(61)
@@ -200,6 +200,8 @@ typedef enum {
 
 	OPT_autogroup,
 
+	OPT_baseline,
+
 	OPT_bad_altstack,
 	OPT_bad_altstack_ops,
 
@@ -495,6 +497,8 @@ typedef enum {
 	OPT_fallocate_bytes,
 	OPT_fallocate_ops,
 
+	OPT_fairness,
+
 	OPT_fanotify,
 	OPT_fanotify_ops,
 
@@ -504,6 +508,8 @@ typedef enum {
 	OPT_far_branch_pageout,
 	OPT_far_branch_pages,
 
+	OPT_fast_launch,
+
 	OPT_fault,
 	OPT_fault_ops,
 
@@ -661,6 +667,7 @@ typedef enum {
 	OPT_handle_ops,
 
 	OPT_hash,
+	OPT_hash_bulk,
 	OPT_hash_method,
 	OPT_hash_ops,
 
@@ -802,6 +809,8 @@ typedef enum {
 	OPT_landlock,
 	OPT_landlock_ops,
 
+	OPT_latency_histogram,
+
 	OPT_lease,
 	OPT_lease_breakers,
 	OPT_lease_ops,
@@ -838,6 +847,8 @@ typedef enum {
 	OPT_lockbus_nosplit,
 	OPT_lockbus_ops,
 
+	OPT_lock_method,
+
 	OPT_locka,
 	OPT_locka_ops,
 
@@ -918,6 +929,8 @@ typedef enum {
 	OPT_memcpy,
 	OPT_memcpy_method,
 	OPT_memcpy_ops,
+	OPT_memcpy_sweep,
+	OPT_memcpy_sweep_max,
 
 	OPT_memfd,
 	OPT_memfd_bytes,
@@ -936,6 +949,7 @@ typedef enum {
 	OPT_memrate_bytes,
 	OPT_memrate_discontiguous,
 	OPT_memrate_flush,
+	OPT_memrate_latency,
 	OPT_memrate_method,
 	OPT_memrate_ops,
 	OPT_memrate_rd_mbs,
@@ -955,6 +969,8 @@ typedef enum {
 	OPT_metamix_ops,
 
 	OPT_metrics_brief,
+	OPT_metrics_interval,
+	OPT_metrics_stream,
 
 	OPT_mincore,
 	OPT_mincore_ops,
@@ -1102,6 +1118,7 @@ typedef enum {
 
 	OPT_mutex,
 	OPT_mutex_affinity,
+	OPT_mutex_lock,
 	OPT_mutex_ops,
 	OPT_mutex_procs,
 
@@ -1194,7 +1211,9 @@ typedef enum {
 	OPT_pci_ops,
 	OPT_pci_ops_rate,
 
+	OPT_perf_interval,
 	OPT_perf_stats,
+	OPT_perf_topdown,
 
 	OPT_permute,
 
@@ -1288,7 +1307,10 @@ typedef enum {
 
 	OPT_ptr_chase,
 	OPT_ptr_chase_ops,
+	OPT_ptr_chase_hugepages,
 	OPT_ptr_chase_pages,
+	OPT_ptr_chase_sweep,
+	OPT_ptr_chase_sweep_max,
 
 	OPT_pty,
 	OPT_pty_max,
@@ -1359,6 +1381,8 @@ typedef enum {
 	OPT_regex,
 	OPT_regex_ops,
 
+	OPT_regress_threshold,
+
 	OPT_regs,
 	OPT_regs_bitflip,
 	OPT_regs_ops,
@@ -1370,6 +1394,9 @@ typedef enum {
 
 	OPT_rename_ops,
 
+	OPT_repeat,
+	OPT_repeat_ci_width,
+
 	OPT_resched,
 	OPT_resched_ops,
 
@@ -1413,6 +1440,10 @@ typedef enum {
 	OPT_rtc,
 	OPT_rtc_ops,
 
+	OPT_sampler,
+
+	OPT_scale_search,
+
 	OPT_sched,
 	OPT_sched_prio,
 
@@ -1614,6 +1645,8 @@ typedef enum {
 	OPT_softlockup,
 	OPT_softlockup_ops,
 
+	OPT_sort_data,
+
 	OPT_swap,
 	OPT_swap_ops,
 	OPT_swap_self,
@@ -1656,6 +1689,8 @@ typedef enum {
 	OPT_stackmmap,
 	OPT_stackmmap_ops,
 
+	OPT_stall_detect,
+
 	OPT_statmount,
 	OPT_statmount_ops,
 
@@ -1673,7 +1708,9 @@ typedef enum {
 	OPT_stream_index,
 	OPT_stream_l3_size,
 	OPT_stream_madvise,
+	OPT_stream_method,
 	OPT_stream_mlock,
+	OPT_stream_numa,
 	OPT_stream_ops,
 	OPT_stream_prefetch,
 
@@ -1931,6 +1968,8 @@ typedef enum {
 	OPT_waitcpu,
 	OPT_waitcpu_ops,
 
+	OPT_warmup,
+
 	OPT_watchdog,
 	OPT_watchdog_ops,
 
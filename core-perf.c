@@ -22,8 +22,10 @@
 #include "core-lock.h"
 #include "core-perf.h"
 #include "core-perf-event.h"
+#include "core-pthread.h"
 
 #include <ctype.h>
+#include <float.h>
 #include <sys/ioctl.h>
 
 #if defined(HAVE_LINUX_PERF_EVENT_H)
@@ -58,19 +60,40 @@ typedef struct {
 	const char *label;		/* human readable name for perf type */
 } stress_perf_info_t;
 
-/* perf data */
-typedef struct {
-	uint64_t counter;		/* perf counter */
-	uint64_t time_enabled;		/* perf time enabled */
-	uint64_t time_running;		/* perf time running */
-} stress_perf_data_t;
-
 typedef struct {
 	const double	threshold;	/* scaling threshold */
 	const double	scale;		/* scaling value */
 	const char 	*suffix;	/* scaling suffix, GB, MB, etc */
 } stress_perf_scale_t;
 
+#define TOPDOWN_NONE		(0)	/* top-down events not available */
+#define TOPDOWN_METRICS		(1)	/* slots and level 1 perf metrics events */
+#define TOPDOWN_SLOTS		(2)	/* topdown slots and bubbles events */
+#define TOPDOWN_APPROX		(3)	/* cycles and stalled cycles approximation */
+
+/* Approximate branch mis-prediction penalty in cycles */
+#define TOPDOWN_BRANCH_MISS_PENALTY	(20.0)
+
+/* top-down event */
+typedef struct {
+	unsigned int type;		/* perf type */
+	uint64_t config;		/* perf type specific config */
+	double scale;			/* sysfs event scale */
+} stress_perf_topdown_event_t;
+
+/* top-down events for the selected method */
+typedef struct {
+	int method;			/* TOPDOWN_* method */
+	size_t n;			/* number of events */
+	stress_perf_topdown_event_t event[STRESS_PERF_TOPDOWN_MAX];
+} stress_perf_topdown_t;
+
+static stress_perf_topdown_t perf_topdown;
+
+static const char * const perf_topdown_method[] = {
+	"none", "topdown-metrics", "topdown-slots", "stalled-cycles-approximation",
+};
+
 /* Tracepoint */
 #define PERF_INFO_TP(path, label)	\
 	{ PERF_TYPE_TRACEPOINT, UNRESOLVED, path, label }
@@ -407,20 +430,6 @@ static inline void stress_perf_type_tracepoint_resolve_config(stress_perf_info_t
 	pi->config = config;
 }
 
-/*
- *  stress_perf_init()
- *	perf initialize, resolve all configs
- */
-void stress_perf_init(void)
-{
-	size_t i;
-
-	for (i = 0; i < STRESS_PERF_MAX; i++) {
-		if (perf_info[i].type == PERF_TYPE_TRACEPOINT) {
-			stress_perf_type_tracepoint_resolve_config(&perf_info[i]);
-		}
-	}
-}
 
 /*
  *  stress_sys_perf_event_open()
@@ -436,6 +445,211 @@ static inline int stress_sys_perf_event_open(
 	return (int)syscall(__NR_perf_event_open, attr, pid, cpu, group_fd, flags);
 }
 
+/*
+ *  stress_perf_topdown_find()
+ *	resolve a PMU sysfs event such as topdown-fe-bound into
+ *	a perf type, config and scale using the PMU format field
+ *	bit ranges, returns false if the event does not exist
+ */
+static bool stress_perf_topdown_find(const char *name, stress_perf_topdown_event_t *event)
+{
+	static const char * const pmus[] = { "cpu", "cpu_core" };
+	size_t i;
+
+	for (i = 0; i < SIZEOF_ARRAY(pmus); i++) {
+		char path[PATH_MAX];
+		char buf[256];
+		char *term, *saveptr = NULL;
+		unsigned int type;
+		uint64_t config = 0;
+		bool ok = true;
+
+		(void)snprintf(path, sizeof(path), "/sys/bus/event_source/devices/%s/type", pmus[i]);
+		if ((stress_fs_file_read(path, buf, sizeof(buf)) <= 0) ||
+		    (sscanf(buf, "%u", &type) != 1))
+			continue;
+		(void)snprintf(path, sizeof(path), "/sys/bus/event_source/devices/%s/events/%s", pmus[i], name);
+		if (stress_fs_file_read(path, buf, sizeof(buf)) <= 0)
+			continue;
+
+		/* terms are field=value or field, e.g. event=0x00,umask=0x81 */
+		for (term = strtok_r(buf, ",\n", &saveptr); term; term = strtok_r(NULL, ",\n", &saveptr)) {
+			char format[64];
+			char *eq = strchr(term, '=');
+			char *range, *rsaveptr = NULL;
+			uint64_t value = 1;
+
+			if (eq) {
+				*eq = '\0';
+				value = (uint64_t)strtoull(eq + 1, NULL, 0);
+			}
+			(void)snprintf(path, sizeof(path), "/sys/bus/event_source/devices/%s/format/%s", pmus[i], term);
+			if ((stress_fs_file_read(path, format, sizeof(format)) <= 0) ||
+			    strncmp(format, "config:", 7)) {
+				/* only fields in the config word are supported */
+				ok = false;
+				break;
+			}
+			/* format is one or more bit ranges, e.g. config:0-7,32-35 */
+			for (range = strtok_r(format + 7, ",\n", &rsaveptr); range; range = strtok_r(NULL, ",\n", &rsaveptr)) {
+				unsigned int lo, hi, width;
+
+				if (sscanf(range, "%u-%u", &lo, &hi) != 2)
+					hi = lo = (unsigned int)strtoul(range, NULL, 10);
+				if ((hi < lo) || (hi > 63)) {
+					ok = false;
+					break;
+				}
+				width = hi - lo + 1;
+				config |= (value & ((width == 64) ? ~0ULL : ((1ULL << width) - 1))) << lo;
+				value = (width == 64) ? 0 : value >> width;
+			}
+			if (!ok)
+				break;
+		}
+		if (!ok)
+			continue;
+
+		event->type = type;
+		event->config = config;
+		event->scale = 1.0;
+		(void)snprintf(path, sizeof(path), "/sys/bus/event_source/devices/%s/events/%s.scale", pmus[i], name);
+		if (stress_fs_file_read(path, buf, sizeof(buf)) > 0) {
+			const double scale = atof(buf);
+
+			if (scale > 0.0)
+				event->scale = scale;
+		}
+		return true;
+	}
+	return false;
+}
+
+/*
+ *  stress_perf_topdown_group_open()
+ *	open the top-down events as a group on process pid, the
+ *	first event is the group leader, returns false if any
+ *	of the events cannot be opened
+ */
+static bool stress_perf_topdown_group_open(stress_perf_stat_t *topdown, const pid_t pid)
+{
+	size_t i;
+
+	for (i = 0; i < perf_topdown.n; i++) {
+		struct perf_event_attr attr;
+
+		(void)shim_memset(&attr, 0, sizeof(attr));
+		attr.type = perf_topdown.event[i].type;
+		attr.config = perf_topdown.event[i].config;
+		attr.disabled = (i == 0);
+		attr.inherit = 1;
+		attr.read_format = PERF_FORMAT_GROUP |
+				   PERF_FORMAT_TOTAL_TIME_ENABLED |
+				   PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.size = sizeof(attr);
+		topdown[i].fd = stress_sys_perf_event_open(&attr, pid, -1,
+			(i == 0) ? -1 : topdown[0].fd, 0);
+		topdown[i].leader = 0;
+		if (topdown[i].fd < 0) {
+			while (i-- > 0) {
+				(void)close(topdown[i].fd);
+				topdown[i].fd = -1;
+			}
+			return false;
+		}
+	}
+	return true;
+}
+
+/*
+ *  stress_perf_topdown_init()
+ *	select the top-down method, the kernel perf metrics
+ *	events (Intel Ice Lake onwards) are preferred, then the
+ *	older Intel topdown slots events and finally a generic
+ *	cycles and stalled cycles approximation. Each method is
+ *	checked by opening its event group on this process.
+ */
+static void stress_perf_topdown_init(void)
+{
+	static const struct {
+		const int method;
+		const char *names[STRESS_PERF_TOPDOWN_MAX];
+	} methods[] = {
+		{ TOPDOWN_METRICS, { "slots", "topdown-fe-bound", "topdown-bad-spec",
+				     "topdown-be-bound", "topdown-retiring" } },
+		{ TOPDOWN_SLOTS,   { "topdown-total-slots", "topdown-fetch-bubbles",
+				     "topdown-recovery-bubbles", "topdown-slots-issued",
+				     "topdown-slots-retired" } },
+	};
+	stress_perf_stat_t topdown[STRESS_PERF_TOPDOWN_MAX];
+	size_t i, j;
+
+	for (i = 0; i < SIZEOF_ARRAY(methods); i++) {
+		(void)shim_memset(&perf_topdown, 0, sizeof(perf_topdown));
+		for (j = 0; j < STRESS_PERF_TOPDOWN_MAX; j++) {
+			if (!stress_perf_topdown_find(methods[i].names[j], &perf_topdown.event[j]))
+				break;
+		}
+		if (j < STRESS_PERF_TOPDOWN_MAX)
+			continue;
+		perf_topdown.n = STRESS_PERF_TOPDOWN_MAX;
+		perf_topdown.method = methods[i].method;
+		if (stress_perf_topdown_group_open(topdown, 0))
+			goto opened;
+	}
+
+#if STRESS_PERF_DEFINED(HW_CPU_CYCLES) &&		\
+    STRESS_PERF_DEFINED(HW_STALLED_CYCLES_FRONTEND) &&	\
+    STRESS_PERF_DEFINED(HW_STALLED_CYCLES_BACKEND) &&	\
+    STRESS_PERF_DEFINED(HW_BRANCH_MISSES)
+	{
+		static const unsigned long int configs[] = {
+			PERF_COUNT_HW_CPU_CYCLES,
+			PERF_COUNT_HW_STALLED_CYCLES_FRONTEND,
+			PERF_COUNT_HW_STALLED_CYCLES_BACKEND,
+			PERF_COUNT_HW_BRANCH_MISSES,
+		};
+
+		(void)shim_memset(&perf_topdown, 0, sizeof(perf_topdown));
+		for (j = 0; j < SIZEOF_ARRAY(configs); j++) {
+			perf_topdown.event[j].type = PERF_TYPE_HARDWARE;
+			perf_topdown.event[j].config = configs[j];
+			perf_topdown.event[j].scale = 1.0;
+		}
+		perf_topdown.n = SIZEOF_ARRAY(configs);
+		perf_topdown.method = TOPDOWN_APPROX;
+		if (stress_perf_topdown_group_open(topdown, 0))
+			goto opened;
+	}
+#endif
+	(void)shim_memset(&perf_topdown, 0, sizeof(perf_topdown));
+	pr_inf("perf-topdown: no top-down or stalled cycles perf events available, "
+		"top-down breakdown disabled\n");
+	return;
+
+opened:
+	for (j = 0; j < perf_topdown.n; j++)
+		(void)close(topdown[j].fd);
+	pr_dbg("perf-topdown: using %s events\n", perf_topdown_method[perf_topdown.method]);
+}
+
+/*
+ *  stress_perf_init()
+ *	perf initialize, resolve all configs
+ */
+void stress_perf_init(void)
+{
+	size_t i;
+
+	for (i = 0; i < STRESS_PERF_MAX; i++) {
+		if (perf_info[i].type == PERF_TYPE_TRACEPOINT) {
+			stress_perf_type_tracepoint_resolve_config(&perf_info[i]);
+		}
+	}
+	if (g_opt_flags & OPT_FLAGS_PERF_TOPDOWN)
+		stress_perf_topdown_init();
+}
+
 /*
  *  stress_perf_yaml_label()
  *	turns text into a yaml compatible label.
@@ -468,13 +682,138 @@ static char *stress_perf_yaml_label(char *dst, const char *src, const size_t n)
 	return dst;
 }
 
+/*
+ *  Compare type + config relative to another reference type and config
+ */
+typedef struct {
+	const unsigned int	type;
+	const unsigned long int	config;
+	const unsigned int	ref_type;
+	const unsigned long int	ref_config;
+	const bool		percent;	/* scale by 100.0 for percentages? */
+	const char 		*fmt;		/* snprintf format */
+} perf_relative_t;
+
+static const perf_relative_t perf_relatives[] = {
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_INSTRUCTIONS,
+	  PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CPU_CYCLES,
+	  false, " (%.3f instr. per cycle)" },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CACHE_MISSES,
+	  PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CACHE_REFERENCES,
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_BRANCH_MISSES,
+	  PERF_TYPE_HARDWARE,	PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(L1D, READ, MISS),
+	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(L1D, READ, ACCESS),
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(LL, READ, MISS),
+	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(LL, READ, ACCESS),
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(LL, WRITE, MISS),
+	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(LL, WRITE, ACCESS),
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(DTLB, READ, MISS),
+	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(DTLB, READ, ACCESS),
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(DTLB, WRITE, MISS),
+	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(DTLB, WRITE, ACCESS),
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(ITLB, READ, MISS),
+	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(ITLB, READ, ACCESS),
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(BPU, READ, MISS),
+	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(BPU, READ, ACCESS),
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(NODE, READ, MISS),
+	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(NODE, READ, ACCESS),
+	  true, " (%6.3f%%)" },
+	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(NODE, WRITE, MISS),
+	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(NODE, WRITE, ACCESS),
+	  true, " (%6.3f%%)" },
+};
+
+/*
+ *  stress_perf_grouped()
+ *	hardware and hardware cache events are opened in groups
+ *	so that they are scheduled onto the PMU at the same time
+ */
+static inline bool stress_perf_grouped(const size_t i)
+{
+	return (perf_info[i].type == PERF_TYPE_HARDWARE) ||
+	       (perf_info[i].type == PERF_TYPE_HW_CACHE);
+}
+
+/*
+ *  stress_perf_paired()
+ *	return true if perf_info events i and j are used to
+ *	compute a perf_relatives ratio
+ */
+static bool stress_perf_paired(const size_t i, const size_t j)
+{
+	size_t k;
+
+	for (k = 0; k < SIZEOF_ARRAY(perf_relatives); k++) {
+		const perf_relative_t *pr = &perf_relatives[k];
+
+		if ((perf_info[i].type == pr->type) && (perf_info[i].config == pr->config) &&
+		    (perf_info[j].type == pr->ref_type) && (perf_info[j].config == pr->ref_config))
+			return true;
+		if ((perf_info[j].type == pr->type) && (perf_info[j].config == pr->config) &&
+		    (perf_info[i].type == pr->ref_type) && (perf_info[i].config == pr->ref_config))
+			return true;
+	}
+	return false;
+}
+
+/*
+ *  stress_perf_group_close()
+ *	close all the perf fds of a group
+ */
+static void stress_perf_group_close(stress_perf_t *sp, const int leader)
+{
+	size_t i;
+
+	for (i = (size_t)leader; (i < STRESS_PERF_MAX) && perf_info[i].label; i++) {
+		stress_perf_stat_t *ps = &sp->perf_stat[i];
+
+		if ((ps->fd > -1) && (ps->leader == leader)) {
+			(void)close(ps->fd);
+			ps->fd = -1;
+		}
+	}
+}
+
+/*
+ *  stress_perf_topdown_close()
+ *	close the top-down event group
+ */
+static void stress_perf_topdown_close(stress_perf_t *sp)
+{
+	size_t i;
+
+	for (i = 0; i < STRESS_PERF_TOPDOWN_MAX; i++) {
+		if (sp->topdown[i].fd > -1) {
+			(void)close(sp->topdown[i].fd);
+			sp->topdown[i].fd = -1;
+		}
+	}
+}
+
 /*
  *  stress_perf_open()
- *	open perf, get leader and perf fd's
+ *	open perf, get leader and perf fd's. Hardware events are
+ *	opened in groups of up to STRESS_PERF_GROUP_MAX events so
+ *	that events used in the same ratio are always counted over
+ *	the same time when the PMU is multiplexed, other events
+ *	are opened as single event groups
  */
 int stress_perf_open(stress_perf_t *sp)
 {
-	size_t i;
+	size_t i, group_size = 0;
+	int leader = -1;
+	/* --perf-topdown without --perf only opens the top-down events */
+	const size_t n = (g_opt_flags & OPT_FLAGS_PERF_STATS) ? STRESS_PERF_MAX : 0;
 
 	if (!sp)
 		return -1;
@@ -486,27 +825,78 @@ int stress_perf_open(stress_perf_t *sp)
 
 	for (i = 0; i < STRESS_PERF_MAX; i++) {
 		sp->perf_stat[i].fd = -1;
+		sp->perf_stat[i].leader = -1;
 		sp->perf_stat[i].counter = 0;
 	}
+	for (i = 0; i < STRESS_PERF_TOPDOWN_MAX; i++)
+		sp->topdown[i].fd = -1;
 
-	for (i = 0; (i < STRESS_PERF_MAX) && perf_info[i].label; i++) {
-		if (perf_info[i].config != UNRESOLVED) {
-			struct perf_event_attr attr;
+	for (i = 0; (i < n) && perf_info[i].label; i++) {
+		struct perf_event_attr attr;
+		const bool grouped = stress_perf_grouped(i);
+		const int prev_leader = leader;
+		const size_t prev_group_size = group_size;
+		int fd;
+
+		if (perf_info[i].config == UNRESOLVED)
+			continue;
 
-			(void)shim_memset(&attr, 0, sizeof(attr));
-			attr.type = perf_info[i].type;
-			attr.config = perf_info[i].config;
+		/*
+		 *  start a new group if the current one is full or
+		 *  if an event and its ratio reference event would
+		 *  be split across two groups
+		 */
+		if (!grouped ||
+		    (group_size >= STRESS_PERF_GROUP_MAX) ||
+		    ((group_size == STRESS_PERF_GROUP_MAX - 1) &&
+		     (i + 1 < STRESS_PERF_MAX) && perf_info[i + 1].label &&
+		     stress_perf_paired(i, i + 1)))
+			leader = -1;
+
+		(void)shim_memset(&attr, 0, sizeof(attr));
+		attr.type = perf_info[i].type;
+		attr.config = perf_info[i].config;
+		attr.disabled = (leader < 0);
+		attr.inherit = 1;
+		attr.read_format = PERF_FORMAT_GROUP |
+				   PERF_FORMAT_TOTAL_TIME_ENABLED |
+				   PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.size = sizeof(attr);
+		fd = stress_sys_perf_event_open(&attr, 0, -1,
+			(leader < 0) ? -1 : sp->perf_stat[leader].fd, 0);
+		if ((fd < 0) && (leader >= 0)) {
+			/*
+			 *  cannot join the group, e.g. the group would not
+			 *  fit on the PMU, try as the leader of a new group
+			 */
+			leader = -1;
 			attr.disabled = 1;
-			attr.inherit = 1;
-			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
-					   PERF_FORMAT_TOTAL_TIME_RUNNING;
-			attr.size = sizeof(attr);
-			sp->perf_stat[i].fd =
-				stress_sys_perf_event_open(&attr, 0, -1, -1, 0);
-			if (sp->perf_stat[i].fd > -1)
-				sp->perf_opened++;
+			fd = stress_sys_perf_event_open(&attr, 0, -1, -1, 0);
 		}
+		if (fd < 0) {
+			/* event not supported, carry on with the current group */
+			leader = prev_leader;
+			group_size = prev_group_size;
+			continue;
+		}
+
+		if (leader < 0) {
+			sp->perf_stat[i].leader = (int)i;
+			if (grouped) {
+				leader = (int)i;
+				group_size = 1;
+			}
+		} else {
+			sp->perf_stat[i].leader = leader;
+			group_size++;
+		}
+		sp->perf_stat[i].fd = fd;
+		sp->perf_opened++;
 	}
+	if ((g_opt_flags & OPT_FLAGS_PERF_TOPDOWN) && perf_topdown.n &&
+	    stress_perf_topdown_group_open(sp->topdown, 0))
+		sp->perf_opened += (int)perf_topdown.n;
+
 	if (!sp->perf_opened) {
 		int ret;
 
@@ -534,7 +924,8 @@ int stress_perf_open(stress_perf_t *sp)
 
 /*
  *  stress_perf_enable()
- *	enable perf counters
+ *	enable perf counters, each group is reset and
+ *	enabled via its leader
  */
 int stress_perf_enable(stress_perf_t *sp)
 {
@@ -548,26 +939,25 @@ int stress_perf_enable(stress_perf_t *sp)
 	for (i = 0; (i < STRESS_PERF_MAX) && perf_info[i].label; i++) {
 		const int fd = sp->perf_stat[i].fd;
 
-		if (fd > -1) {
-			if (ioctl(fd, PERF_EVENT_IOC_RESET,
-				  PERF_IOC_FLAG_GROUP) < 0) {
-				(void)close(fd);
-				sp->perf_stat[i].fd = -1;
-				continue;
-			}
-			if (ioctl(fd, PERF_EVENT_IOC_ENABLE,
-				  PERF_IOC_FLAG_GROUP) < 0) {
-				(void)close(fd);
-				sp->perf_stat[i].fd = -1;
-			}
+		if ((fd > -1) && (sp->perf_stat[i].leader == (int)i)) {
+			if ((ioctl(fd, PERF_EVENT_IOC_RESET,
+				   PERF_IOC_FLAG_GROUP) < 0) ||
+			    (ioctl(fd, PERF_EVENT_IOC_ENABLE,
+				   PERF_IOC_FLAG_GROUP) < 0))
+				stress_perf_group_close(sp, (int)i);
 		}
 	}
+	if ((sp->topdown[0].fd > -1) &&
+	    ((ioctl(sp->topdown[0].fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP) < 0) ||
+	     (ioctl(sp->topdown[0].fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) < 0)))
+		stress_perf_topdown_close(sp);
 	return 0;
 }
 
 /*
  *  stress_perf_disable()
- *	disable perf counters
+ *	disable perf counters, each group is
+ *	disabled via its leader
  */
 int stress_perf_disable(stress_perf_t *sp)
 {
@@ -581,17 +971,108 @@ int stress_perf_disable(stress_perf_t *sp)
 	for (i = 0; (i < STRESS_PERF_MAX) && perf_info[i].label; i++) {
 		const int fd = sp->perf_stat[i].fd;
 
-		if (fd > -1) {
+		if ((fd > -1) && (sp->perf_stat[i].leader == (int)i)) {
 			if (ioctl(fd, PERF_EVENT_IOC_DISABLE,
-			          PERF_IOC_FLAG_GROUP) < 0) {
-				(void)close(fd);
-				sp->perf_stat[i].fd = -1;
-			}
+			          PERF_IOC_FLAG_GROUP) < 0)
+				stress_perf_group_close(sp, (int)i);
 		}
 	}
+	if ((sp->topdown[0].fd > -1) &&
+	    (ioctl(sp->topdown[0].fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP) < 0))
+		stress_perf_topdown_close(sp);
+	return 0;
+}
+
+/*
+ *  stress_perf_group_data()
+ *	read a group of up to max values, data is filled with the
+ *	number of values, time enabled, time running and the values
+ *	and scale is set to the time enabled / time running scaling
+ *	factor, returns -1 on failure or if the group was enabled
+ *	but never scheduled onto the PMU, so it has no counts
+ */
+static int stress_perf_group_data(const int fd, uint64_t *data, const size_t max, double *scale)
+{
+	const size_t size = (3 + max) * sizeof(*data);
+	ssize_t ret;
+
+	(void)shim_memset(data, 0, size);
+	ret = read(fd, data, size);
+	if ((ret < (ssize_t)(3 * sizeof(*data))) || (data[0] > max) ||
+	    (ret < (ssize_t)((3 + data[0]) * sizeof(*data))))
+		return -1;
+
+	/* Ensure we don't get division by zero */
+	if (data[2] == 0) {
+		if (data[1] > 0)
+			return -1;
+		*scale = 1.0;
+	} else {
+		*scale = (double)data[1] / (double)data[2];
+	}
 	return 0;
 }
 
+/*
+ *  stress_perf_group_read()
+ *	read all the counters of a group with one read via the
+ *	group leader and scale them by the time enabled / time
+ *	running of the group to account for PMU multiplexing
+ */
+static void stress_perf_group_read(stress_perf_t *sp, const int leader)
+{
+	uint64_t data[3 + STRESS_PERF_GROUP_MAX];	/* nr, time enabled, time running, values */
+	size_t i, n = 0, members = 0;
+	double scale;
+
+	if (stress_perf_group_data(sp->perf_stat[leader].fd, data,
+				   STRESS_PERF_GROUP_MAX, &scale) < 0)
+		return;
+
+	/* values can only be matched to events if all the members are read */
+	for (i = (size_t)leader; (i < STRESS_PERF_MAX) && perf_info[i].label; i++) {
+		if ((sp->perf_stat[i].fd > -1) && (sp->perf_stat[i].leader == leader))
+			members++;
+	}
+	if (members != data[0])
+		return;
+
+	/* group values are in the order the events were opened */
+	for (i = (size_t)leader; (i < STRESS_PERF_MAX) && perf_info[i].label && (n < data[0]); i++) {
+		stress_perf_stat_t *ps = &sp->perf_stat[i];
+
+		if ((ps->fd > -1) && (ps->leader == leader)) {
+			ps->counter = (uint64_t)((double)data[3 + n] * scale);
+			ps->time_enabled = data[1];
+			ps->time_running = data[2];
+			n++;
+		}
+	}
+}
+
+/*
+ *  stress_perf_topdown_read()
+ *	read and close the top-down event group
+ */
+static void stress_perf_topdown_read(stress_perf_t *sp)
+{
+	uint64_t data[3 + STRESS_PERF_TOPDOWN_MAX];	/* nr, time enabled, time running, values */
+	size_t i;
+	double scale;
+
+	for (i = 0; i < STRESS_PERF_TOPDOWN_MAX; i++)
+		sp->topdown[i].counter = STRESS_PERF_INVALID;
+	if (sp->topdown[0].fd < 0)
+		return;
+
+	if ((stress_perf_group_data(sp->topdown[0].fd, data, STRESS_PERF_TOPDOWN_MAX, &scale) == 0) &&
+	    (data[0] == perf_topdown.n)) {
+		for (i = 0; i < perf_topdown.n; i++)
+			sp->topdown[i].counter = (uint64_t)((double)data[3 + i] * scale);
+	}
+	stress_perf_topdown_close(sp);
+}
+
 /*
  *  stress_perf_close()
  *	read counters and close
@@ -599,40 +1080,31 @@ int stress_perf_disable(stress_perf_t *sp)
 int stress_perf_close(stress_perf_t *sp)
 {
 	size_t i = 0;
-	stress_perf_data_t data;
-	ssize_t ret;
-	double scale;
 
 	if (!sp)
 		return -1;
-	if (!sp->perf_opened)
+	if (!sp->perf_opened) {
+		for (i = 0; i < STRESS_PERF_TOPDOWN_MAX; i++)
+			sp->topdown[i].counter = STRESS_PERF_INVALID;
+		i = 0;
 		goto out_ok;
+	}
 
 	for (i = 0; (i < STRESS_PERF_MAX) && perf_info[i].label; i++) {
-		const int fd = sp->perf_stat[i].fd;
-
-		if (fd < 0 ) {
-			sp->perf_stat[i].counter = STRESS_PERF_INVALID;
-			continue;
-		}
-
-		(void)shim_memset(&data, 0, sizeof(data));
-		ret = read(fd, &data, sizeof(data));
-		if (ret != sizeof(data))
-			sp->perf_stat[i].counter = STRESS_PERF_INVALID;
-		else {
-			/* Ensure we don't get division by zero */
-			if (data.time_running == 0) {
-				scale = (data.time_enabled == 0) ? 1.0 : 0.0;
-			} else {
-				scale = (double)data.time_enabled /
-					(double)data.time_running;
-			}
-			sp->perf_stat[i].counter = (uint64_t)
-				((double)data.counter * scale);
+		sp->perf_stat[i].counter = STRESS_PERF_INVALID;
+		sp->perf_stat[i].time_enabled = 0;
+		sp->perf_stat[i].time_running = 0;
+	}
+	for (i = 0; (i < STRESS_PERF_MAX) && perf_info[i].label; i++) {
+		if ((sp->perf_stat[i].fd > -1) && (sp->perf_stat[i].leader == (int)i))
+			stress_perf_group_read(sp, (int)i);
+	}
+	stress_perf_topdown_read(sp);
+	for (i = 0; (i < STRESS_PERF_MAX) && perf_info[i].label; i++) {
+		if (sp->perf_stat[i].fd > -1) {
+			(void)close(sp->perf_stat[i].fd);
+			sp->perf_stat[i].fd = -1;
 		}
-		(void)close(fd);
-		sp->perf_stat[i].fd = -1;
 	}
 
 out_ok:
@@ -681,57 +1153,6 @@ static const char *stress_perf_stat_scale(const uint64_t counter, const double d
 	return buffer;
 }
 
-/*
- *  Compare type + config relative to another reference type and config
- */
-typedef struct {
-	const unsigned int	type;
-	const unsigned long int	config;
-	const unsigned int	ref_type;
-	const unsigned long int	ref_config;
-	const bool		percent;	/* scale by 100.0 for percentages? */
-	const char 		*fmt;		/* snprintf format */
-} perf_relative_t;
-
-static const perf_relative_t perf_relatives[] = {
-	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_INSTRUCTIONS,
-	  PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CPU_CYCLES,
-	  false, " (%.3f instr. per cycle)" },
-	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CACHE_MISSES,
-	  PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CACHE_REFERENCES,
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_BRANCH_MISSES,
-	  PERF_TYPE_HARDWARE,	PERF_COUNT_HW_BRANCH_INSTRUCTIONS,
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(L1D, READ, MISS),
-	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(L1D, READ, ACCESS),
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(LL, READ, MISS),
-	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(LL, READ, ACCESS),
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(LL, WRITE, MISS),
-	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(LL, WRITE, ACCESS),
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(DTLB, READ, MISS),
-	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(DTLB, READ, ACCESS),
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(DTLB, WRITE, MISS),
-	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(DTLB, WRITE, ACCESS),
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(ITLB, READ, MISS),
-	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(ITLB, READ, ACCESS),
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(BPU, READ, MISS),
-	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(BPU, READ, ACCESS),
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(NODE, READ, MISS),
-	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(NODE, READ, ACCESS),
-	  true, " (%6.3f%%)" },
-	{ PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(NODE, WRITE, MISS),
-	  PERF_TYPE_HW_CACHE,	PERF_INFO_HW_CACHE_CONFIG(NODE, WRITE, ACCESS),
-	  true, " (%6.3f%%)" },
-};
-
 /*
  *  stress_perf_stat_dump()
  *	emit perf statistics
@@ -739,6 +1160,7 @@ static const perf_relative_t perf_relatives[] = {
 void stress_perf_stat_dump(FILE *yaml, stress_list_item_t *stressors_list, const double duration)
 {
 	bool no_perf_stats = true;
+	bool multiplexed_any = false;
 	stress_list_item_t *item;
 
 #if defined(HAVE_LOCALE_H)
@@ -750,7 +1172,11 @@ void stress_perf_stat_dump(FILE *yaml, stress_list_item_t *stressors_list, const
 	for (item = stressors_list; item; item = item->next) {
 		int p;
 		uint64_t counter_totals[STRESS_PERF_MAX];
+		uint64_t enabled_totals[STRESS_PERF_MAX];
+		uint64_t running_totals[STRESS_PERF_MAX];
 		bool got_data = false;
+		double item_duration = 0.0;
+		int32_t k, n_durations = 0;
 
 		if (item->ignore.run)
 			continue;
@@ -760,19 +1186,24 @@ void stress_perf_stat_dump(FILE *yaml, stress_list_item_t *stressors_list, const
 			continue;
 
 		(void)shim_memset(counter_totals, 0, sizeof(counter_totals));
+		(void)shim_memset(enabled_totals, 0, sizeof(enabled_totals));
+		(void)shim_memset(running_totals, 0, sizeof(running_totals));
 
 		/* Sum totals across all instances of the stressor */
 		for (p = 0; (p < STRESS_PERF_MAX) && perf_info[p].label; p++) {
 			int32_t j;
 
 			for (j = 0; j < item->instances; j++) {
-				const uint64_t counter = item->stats[j]->sp.perf_stat[p].counter;
+				const stress_perf_stat_t *ps = &item->stats[j]->sp.perf_stat[p];
+				const uint64_t counter = ps->counter;
 
 				if (counter == STRESS_PERF_INVALID) {
 					counter_totals[p] = STRESS_PERF_INVALID;
 					break;
 				}
 				counter_totals[p] += counter;
+				enabled_totals[p] += ps->time_enabled;
+				running_totals[p] += ps->time_running;
 				got_data |= (counter > 0);
 			}
 		}
@@ -780,9 +1211,22 @@ void stress_perf_stat_dump(FILE *yaml, stress_list_item_t *stressors_list, const
 		if (!got_data)
 			continue;
 
+		/*
+		 *  Counters are from the last run of each instance, so use
+		 *  the mean last run time, this excludes any --warmup phase
+		 *  and earlier --seq, --permute and --repeat runs
+		 */
+		for (k = 0; k < item->instances; k++) {
+			if (item->stats[k]->duration > 0.0) {
+				item_duration += item->stats[k]->duration;
+				n_durations++;
+			}
+		}
+		item_duration = n_durations ? item_duration / (double)n_durations : duration;
+
 		pr_inf("%s:\n", item->stressor->name);
 		pr_yaml(yaml, "    - stressor: %s\n", item->stressor->name);
-		pr_yaml(yaml, "      duration: %f\n", duration);
+		pr_yaml(yaml, "      duration: %f\n", item_duration);
 
 		for (p = 0; (p < STRESS_PERF_MAX) && perf_info[p].label; p++) {
 			const char *label = perf_info[p].label;
@@ -790,12 +1234,23 @@ void stress_perf_stat_dump(FILE *yaml, stress_list_item_t *stressors_list, const
 
 			if (label && (ct != STRESS_PERF_INVALID)) {
 				char extra[32];
+				char multiplexed[32];
 				char yaml_label[128];
 				size_t i;
+				/* percentage of time the group was on the PMU */
+				const double running = (enabled_totals[p] > 0) ?
+					100.0 * (double)running_totals[p] / (double)enabled_totals[p] : 100.0;
 
 				*extra = '\0';
+				*multiplexed = '\0';
 				no_perf_stats = false;
 
+				if (running < 99.995) {
+					(void)snprintf(multiplexed, sizeof(multiplexed),
+						" [%.2f%% running]", running);
+					multiplexed_any = true;
+				}
+
 				for (i = 0; i < SIZEOF_ARRAY(perf_relatives); i++) {
 					if ((perf_info[p].type == perf_relatives[i].type) &&
 					    (perf_info[p].config == perf_relatives[i].config)) {
@@ -812,20 +1267,25 @@ void stress_perf_stat_dump(FILE *yaml, stress_list_item_t *stressors_list, const
 					}
 				}
 
-				pr_inf("%'26" PRIu64 " %-24s %s%s\n",
-					ct, label, stress_perf_stat_scale(ct, duration),
-					extra);
+				pr_inf("%'26" PRIu64 " %-24s %s%s%s\n",
+					ct, label, stress_perf_stat_scale(ct, item_duration),
+					extra, multiplexed);
 
 				*yaml_label = '\0';
 				stress_perf_yaml_label(yaml_label, label, sizeof(yaml_label));
 				pr_yaml(yaml, "      %s_total: %" PRIu64
 					"\n", yaml_label, ct);
 				pr_yaml(yaml, "      %s_per_second: %f\n",
-					yaml_label, (double)ct / duration);
+					yaml_label, (double)ct / item_duration);
+				pr_yaml(yaml, "      %s_running_percent: %f\n",
+					yaml_label, running);
 			}
 		}
 		pr_yaml(yaml, "\n");
 	}
+	if (multiplexed_any)
+		pr_inf("perf counters that were multiplexed on the PMU are scaled "
+			"by time enabled / time running\n");
 	if (no_perf_stats) {
 		if (geteuid() != 0) {
 			char buffer[64];
@@ -851,4 +1311,607 @@ void stress_perf_stat_dump(FILE *yaml, stress_list_item_t *stressors_list, const
 		}
 	}
 }
+
+/*
+ *  stress_perf_topdown_fractions()
+ *	compute the top-down level 1 frontend bound, bad speculation,
+ *	backend bound and retiring fractions from the summed top-down
+ *	counters, the fractions are clamped and normalized to sum to 1
+ */
+static bool stress_perf_topdown_fractions(const double *counters, double *fraction)
+{
+	double total = 0.0;
+	size_t i;
+
+	switch (perf_topdown.method) {
+	case TOPDOWN_METRICS:
+		/* metric events count slots * metric fraction */
+		fraction[0] = counters[1];
+		fraction[1] = counters[2];
+		fraction[2] = counters[3];
+		fraction[3] = counters[4];
+		break;
+	case TOPDOWN_SLOTS:
+		if (counters[0] <= 0.0)
+			return false;
+		fraction[0] = counters[1] / counters[0];
+		fraction[1] = (counters[3] - counters[4] + counters[2]) / counters[0];
+		fraction[3] = counters[4] / counters[0];
+		fraction[2] = 1.0 - fraction[0] - fraction[1] - fraction[3];
+		break;
+	case TOPDOWN_APPROX:
+		if (counters[0] <= 0.0)
+			return false;
+		fraction[0] = counters[1] / counters[0];
+		fraction[1] = counters[3] * TOPDOWN_BRANCH_MISS_PENALTY / counters[0];
+		fraction[2] = counters[2] / counters[0];
+		fraction[3] = 1.0 - fraction[0] - fraction[1] - fraction[2];
+		break;
+	default:
+		return false;
+	}
+
+	for (i = 0; i < 4; i++) {
+		if (fraction[i] < 0.0)
+			fraction[i] = 0.0;
+		total += fraction[i];
+	}
+	if (total <= 0.0)
+		return false;
+	for (i = 0; i < 4; i++)
+		fraction[i] /= total;
+	return true;
+}
+
+/*
+ *  stress_perf_topdown_dump()
+ *	emit the per stressor top-down level 1 breakdown
+ */
+void stress_perf_topdown_dump(FILE *yaml, stress_list_item_t *stressors_list)
+{
+	static const char * const names[] = {
+		"frontend-bound", "bad-speculation", "backend-bound", "retiring",
+	};
+	stress_list_item_t *item;
+	bool header = false;
+
+	if (perf_topdown.method == TOPDOWN_NONE)
+		return;
+
+	pr_block_begin();
+	for (item = stressors_list; item; item = item->next) {
+		double counters[STRESS_PERF_TOPDOWN_MAX];
+		double fraction[4];
+		int32_t j;
+		size_t i;
+		bool valid = true;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+
+		/* Sum scaled counters across all instances of the stressor */
+		(void)shim_memset(counters, 0, sizeof(counters));
+		for (j = 0; valid && (j < item->instances); j++) {
+			const stress_perf_t *sp = &item->stats[j]->sp;
+
+			if (!stress_perf_stat_succeeded(sp))
+				valid = false;
+			for (i = 0; valid && (i < perf_topdown.n); i++) {
+				if (sp->topdown[i].counter == STRESS_PERF_INVALID)
+					valid = false;
+				else
+					counters[i] += (double)sp->topdown[i].counter * perf_topdown.event[i].scale;
+			}
+		}
+		if (!valid || !stress_perf_topdown_fractions(counters, fraction))
+			continue;
+
+		if (!header) {
+			pr_inf("perf-topdown: top-down level 1 breakdown (%s):\n",
+				perf_topdown_method[perf_topdown.method]);
+			pr_inf("%-13s %15s %15s %15s %15s\n", "stressor",
+				names[0], names[1], names[2], names[3]);
+			pr_yaml(yaml, "perf-topdown:\n");
+			pr_yaml(yaml, "    method: %s\n", perf_topdown_method[perf_topdown.method]);
+			pr_yaml(yaml, "    stressors:\n");
+			header = true;
+		}
+		pr_inf("%-13s %14.2f%% %14.2f%% %14.2f%% %14.2f%%\n", item->stressor->name,
+			100.0 * fraction[0], 100.0 * fraction[1],
+			100.0 * fraction[2], 100.0 * fraction[3]);
+		pr_yaml(yaml, "      - stressor: %s\n", item->stressor->name);
+		for (i = 0; i < SIZEOF_ARRAY(names); i++)
+			pr_yaml(yaml, "        %s-percent: %f\n", names[i], 100.0 * fraction[i]);
+	}
+	if (header) {
+		if (perf_topdown.method == TOPDOWN_APPROX)
+			pr_inf("perf-topdown: approximated from stalled cycles and a %.0f cycle "
+				"branch miss penalty, retiring includes unaccounted slots\n",
+				TOPDOWN_BRANCH_MISS_PENALTY);
+		pr_yaml(yaml, "\n");
+	} else {
+		pr_inf("perf-topdown: no top-down perf counters were read\n");
+	}
+	pr_block_end();
+}
+
+/*
+ *  --perf-interval hardware counter sampling, a thread in the
+ *  parent opens a small set of event groups on each stressor
+ *  instance and reads them every interval to track the IPC,
+ *  cache miss and branch miss rates of each stressor over time
+ */
+#define PERF_INTERVAL_EVENTS		(6)
+#define PERF_INTERVAL_GROUP_EVENTS	(2)
+#define PERF_INTERVAL_SAMPLES_MAX	(1U << 20)
+
+/* Event pairs, each pair is a group of event and reference event */
+static const struct {
+	const unsigned int	type;
+	const unsigned long int	config;
+} perf_interval_events[PERF_INTERVAL_EVENTS] = {
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CPU_CYCLES },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_INSTRUCTIONS },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CACHE_REFERENCES },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_CACHE_MISSES },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+	{ PERF_TYPE_HARDWARE,	PERF_COUNT_HW_BRANCH_MISSES },
+};
+
+/* Per interval sample, negative values are not available */
+typedef struct {
+	double time;			/* time since stressor started */
+	double ipc;			/* instructions per cycle */
+	double cache_miss;		/* cache miss percent */
+	double branch_miss;		/* branch miss percent */
+} stress_perf_sample_t;
+
+/* Per stressor instance event fds */
+typedef struct {
+	pid_t pid;			/* pid the events are opened on */
+	int fd[PERF_INTERVAL_EVENTS];	/* event fds, -1 = not open */
+	uint64_t last[PERF_INTERVAL_EVENTS];	/* previous scaled counts */
+} stress_perf_interval_fds_t;
+
+/* Per stressor interval samples */
+typedef struct stress_perf_interval {
+	struct stress_perf_interval *next;	/* next stressor */
+	stress_list_item_t *item;	/* stressor being sampled */
+	stress_perf_interval_fds_t *fds;	/* per instance fds */
+	stress_perf_sample_t *samples;	/* interval samples */
+	size_t n_samples;		/* number of samples */
+	size_t max_samples;		/* allocated samples */
+	double t_start;			/* time sampling started */
+} stress_perf_interval_t;
+
+static stress_perf_interval_t *perf_interval_head;
+static stress_perf_interval_t *perf_interval_tail;
+static pthread_t perf_interval_pthread;
+static int perf_interval_pthread_ret = -1;
+static volatile bool perf_interval_run;
+static uint32_t perf_interval_ms;
+static bool perf_interval_opened;
+
+/*
+ *  stress_perf_interval_open()
+ *	open the interval event groups on a stressor instance,
+ *	groups that cannot be opened are left closed
+ */
+static void stress_perf_interval_open(stress_perf_interval_fds_t *fds, const pid_t pid)
+{
+	size_t i;
+
+	fds->pid = pid;
+	for (i = 0; i < PERF_INTERVAL_EVENTS; i++) {
+		struct perf_event_attr attr;
+		const bool leader = ((i % PERF_INTERVAL_GROUP_EVENTS) == 0);
+
+		fds->last[i] = 0;
+		fds->fd[i] = -1;
+		if (!leader && (fds->fd[i - 1] < 0))
+			continue;
+
+		(void)shim_memset(&attr, 0, sizeof(attr));
+		attr.type = perf_interval_events[i].type;
+		attr.config = perf_interval_events[i].config;
+		attr.inherit = 1;
+		attr.read_format = PERF_FORMAT_GROUP |
+				   PERF_FORMAT_TOTAL_TIME_ENABLED |
+				   PERF_FORMAT_TOTAL_TIME_RUNNING;
+		attr.size = sizeof(attr);
+		fds->fd[i] = stress_sys_perf_event_open(&attr, pid, -1,
+			leader ? -1 : fds->fd[i - 1], 0);
+		if (!leader && (fds->fd[i] < 0)) {
+			/* a group without its reference event is useless */
+			(void)close(fds->fd[i - 1]);
+			fds->fd[i - 1] = -1;
+		}
+		if ((fds->fd[i] > -1) && !leader)
+			perf_interval_opened = true;
+	}
+}
+
+/*
+ *  stress_perf_interval_close()
+ *	close the interval event groups of a stressor instance
+ */
+static void stress_perf_interval_close(stress_perf_interval_fds_t *fds)
+{
+	size_t i;
+
+	for (i = 0; i < PERF_INTERVAL_EVENTS; i++) {
+		if (fds->fd[i] > -1) {
+			(void)close(fds->fd[i]);
+			fds->fd[i] = -1;
+		}
+	}
+	fds->pid = 0;
+}
+
+/*
+ *  stress_perf_interval_read()
+ *	read the event groups of a stressor instance and add the
+ *	scaled counter deltas since the last read to deltas
+ */
+static void stress_perf_interval_read(stress_perf_interval_fds_t *fds, uint64_t *deltas)
+{
+	size_t i;
+
+	for (i = 0; i < PERF_INTERVAL_EVENTS; i += PERF_INTERVAL_GROUP_EVENTS) {
+		uint64_t data[3 + PERF_INTERVAL_GROUP_EVENTS];	/* nr, time enabled, time running, values */
+		size_t j;
+		double scale;
+
+		if (fds->fd[i] < 0)
+			continue;
+		if (read(fds->fd[i], data, sizeof(data)) != (ssize_t)sizeof(data))
+			continue;
+		if (data[0] != PERF_INTERVAL_GROUP_EVENTS)
+			continue;
+		/* not scheduled onto the PMU since it was enabled, no counts yet */
+		if (data[2] == 0)
+			continue;
+		scale = (double)data[1] / (double)data[2];
+
+		for (j = 0; j < PERF_INTERVAL_GROUP_EVENTS; j++) {
+			const uint64_t value = (uint64_t)((double)data[3 + j] * scale);
+
+			if (value > fds->last[i + j])
+				deltas[i + j] += value - fds->last[i + j];
+			fds->last[i + j] = value;
+		}
+	}
+}
+
+/*
+ *  stress_perf_interval_ratio()
+ *	ratio of two counter deltas, -1.0 if not available
+ */
+static inline double stress_perf_interval_ratio(
+	const uint64_t value,
+	const uint64_t ref,
+	const double scale)
+{
+	return (ref > 0) ? scale * (double)value / (double)ref : -1.0;
+}
+
+/*
+ *  stress_perf_interval_sample()
+ *	sample the event groups of all the instances of all
+ *	the stressors and add an interval sample per stressor,
+ *	new instances are opened, reaped instances are read
+ *	for the last time and closed
+ */
+static void stress_perf_interval_sample(const double t_now)
+{
+	stress_perf_interval_t *pi;
+
+	for (pi = perf_interval_head; pi; pi = pi->next) {
+		stress_list_item_t *item = pi->item;
+		uint64_t deltas[PERF_INTERVAL_EVENTS];
+		stress_perf_sample_t *sample;
+		int32_t i;
+
+		if (!pi->fds)
+			continue;
+
+		(void)shim_memset(deltas, 0, sizeof(deltas));
+		for (i = 0; i < item->instances; i++) {
+			const stress_stats_t *stats = item->stats[i];
+			stress_perf_interval_fds_t *fds = &pi->fds[i];
+			const pid_t pid = stats->s_pid.pid;
+			const bool active = (pid > 0) && !stats->s_pid.reaped;
+
+			if (fds->pid != pid) {
+				if (fds->pid > 0)
+					stress_perf_interval_close(fds);
+				if (active)
+					stress_perf_interval_open(fds, pid);
+			}
+			if (fds->pid > 0) {
+				stress_perf_interval_read(fds, deltas);
+				if (!active)
+					stress_perf_interval_close(fds);
+			}
+		}
+		if (!deltas[0] && !deltas[2] && !deltas[4])
+			continue;
+
+		if (pi->n_samples >= pi->max_samples) {
+			stress_perf_sample_t *samples;
+			const size_t max_samples = pi->max_samples ? pi->max_samples * 2 : 64;
+
+			if (max_samples > PERF_INTERVAL_SAMPLES_MAX)
+				continue;
+			samples = (stress_perf_sample_t *)realloc(pi->samples,
+				max_samples * sizeof(*samples));
+			if (!samples)
+				continue;
+			pi->samples = samples;
+			pi->max_samples = max_samples;
+		}
+		sample = &pi->samples[pi->n_samples++];
+		sample->time = t_now - pi->t_start;
+		sample->ipc = stress_perf_interval_ratio(deltas[1], deltas[0], 1.0);
+		sample->cache_miss = stress_perf_interval_ratio(deltas[3], deltas[2], 100.0);
+		sample->branch_miss = stress_perf_interval_ratio(deltas[5], deltas[4], 100.0);
+	}
+}
+
+/*
+ *  stress_perf_interval_pthread()
+ *	interval sampling thread, all signals are blocked so
+ *	that they are always handled by the main thread
+ */
+static void *stress_perf_interval_pthread(void *arg)
+{
+	const double period = (double)perf_interval_ms / 1000.0;
+	sigset_t set;
+	double t_next;
+
+	(void)arg;
+	(void)sigfillset(&set);
+	(void)pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+	t_next = stress_time_now();
+	while (perf_interval_run) {
+		double delta;
+
+		t_next += period;
+		delta = t_next - stress_time_now();
+		if (delta > 0.0)
+			(void)shim_nanosleep_uint64((uint64_t)(delta * STRESS_DBL_NANOSECOND));
+		stress_perf_interval_sample(stress_time_now());
+	}
+	return &g_nowt;
+}
+
+/*
+ *  stress_perf_interval_start()
+ *	start the --perf-interval sampling thread
+ */
+void stress_perf_interval_start(stress_list_item_t *stressors_list)
+{
+	stress_list_item_t *item;
+	const double t_now = stress_time_now();
+
+	if (!stress_setting_get("perf-interval", &perf_interval_ms) || (perf_interval_ms == 0))
+		return;
+
+	for (item = stressors_list; item; item = item->next) {
+		stress_perf_interval_t *pi;
+		int32_t i;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+
+		/* stressors are re-run with --repeat, keep adding samples */
+		for (pi = perf_interval_head; pi; pi = pi->next) {
+			if (pi->item == item)
+				break;
+		}
+		if (!pi) {
+			pi = (stress_perf_interval_t *)calloc(1, sizeof(*pi));
+			if (!pi) {
+				pr_inf("perf-interval: cannot allocate sampling data for %s, skipping\n",
+					item->stressor->name);
+				continue;
+			}
+			pi->item = item;
+			pi->t_start = t_now;
+			if (perf_interval_tail)
+				perf_interval_tail->next = pi;
+			else
+				perf_interval_head = pi;
+			perf_interval_tail = pi;
+		}
+		pi->fds = (stress_perf_interval_fds_t *)calloc((size_t)item->instances, sizeof(*pi->fds));
+		if (!pi->fds) {
+			pr_inf("perf-interval: cannot allocate perf fds for %s, skipping\n",
+				item->stressor->name);
+			continue;
+		}
+		for (i = 0; i < item->instances; i++) {
+			size_t j;
+
+			for (j = 0; j < PERF_INTERVAL_EVENTS; j++)
+				pi->fds[i].fd[j] = -1;
+		}
+	}
+
+	perf_interval_run = true;
+	perf_interval_pthread_ret = pthread_create(&perf_interval_pthread, NULL,
+					stress_perf_interval_pthread, NULL);
+	if (perf_interval_pthread_ret != 0) {
+		pr_inf("perf-interval: cannot create sampling thread, errno=%d (%s), "
+			"sampling disabled\n", perf_interval_pthread_ret,
+			strerror(perf_interval_pthread_ret));
+		perf_interval_run = false;
+	}
+}
+
+/*
+ *  stress_perf_interval_stop()
+ *	stop the sampling thread, take a final sample of the
+ *	reaped instances and close all the perf fds
+ */
+void stress_perf_interval_stop(void)
+{
+	stress_perf_interval_t *pi;
+
+	if (perf_interval_pthread_ret == 0) {
+		perf_interval_run = false;
+		(void)pthread_join(perf_interval_pthread, NULL);
+		perf_interval_pthread_ret = -1;
+		stress_perf_interval_sample(stress_time_now());
+	}
+
+	for (pi = perf_interval_head; pi; pi = pi->next) {
+		int32_t i;
+
+		if (!pi->fds)
+			continue;
+		for (i = 0; i < pi->item->instances; i++)
+			stress_perf_interval_close(&pi->fds[i]);
+		free(pi->fds);
+		pi->fds = NULL;
+	}
+}
+
+/*
+ *  stress_perf_interval_stats()
+ *	min, mean and max of a sample field, returns false
+ *	if the field was never available
+ */
+static bool stress_perf_interval_stats(
+	const stress_perf_interval_t *pi,
+	const size_t offset,
+	double *min,
+	double *mean,
+	double *max)
+{
+	size_t i, n = 0;
+	double total = 0.0;
+
+	*min = DBL_MAX;
+	*max = -DBL_MAX;
+	for (i = 0; i < pi->n_samples; i++) {
+		const double value = *(const double *)((const char *)&pi->samples[i] + offset);
+
+		if (value < 0.0)
+			continue;
+		if (*min > value)
+			*min = value;
+		if (*max < value)
+			*max = value;
+		total += value;
+		n++;
+	}
+	if (!n) {
+		*min = 0.0;
+		*mean = 0.0;
+		*max = 0.0;
+		return false;
+	}
+	*mean = total / (double)n;
+	return true;
+}
+
+/*
+ *  stress_perf_interval_dump()
+ *	dump the per stressor min/mean/max interval IPC, cache
+ *	miss and branch miss rates and the per interval samples
+ */
+void stress_perf_interval_dump(FILE *yaml)
+{
+	static const struct {
+		const size_t offset;
+		const char *name;
+	} fields[] = {
+		{ offsetof(stress_perf_sample_t, ipc),		"instructions-per-cycle" },
+		{ offsetof(stress_perf_sample_t, cache_miss),	"cache-miss-percent" },
+		{ offsetof(stress_perf_sample_t, branch_miss),	"branch-miss-percent" },
+	};
+	stress_perf_interval_t *pi;
+	bool header = false;
+
+	if (!perf_interval_head)
+		return;
+	if (!perf_interval_opened) {
+		pr_inf("perf-interval: cannot open hardware perf events, no interval samples\n");
+		return;
+	}
+
+	pr_block_begin();
+	for (pi = perf_interval_head; pi; pi = pi->next) {
+		double stats[SIZEOF_ARRAY(fields)][3];
+		char str[SIZEOF_ARRAY(fields)][32];
+		size_t i, j;
+
+		if (!pi->n_samples)
+			continue;
+		if (!header) {
+			pr_inf("perf-interval: hardware counter rates sampled every %" PRIu32 " ms:\n",
+				perf_interval_ms);
+			pr_inf("%-13s %7s %23s %23s %23s\n", "", "",
+				"IPC", "cache-miss %", "branch-miss %");
+			pr_inf("%-13s %7s %23s %23s %23s\n", "stressor", "samples",
+				"min    mean     max", "min    mean     max", "min    mean     max");
+			pr_yaml(yaml, "perf-interval:\n");
+			pr_yaml(yaml, "    interval-ms: %" PRIu32 "\n", perf_interval_ms);
+			pr_yaml(yaml, "    stressors:\n");
+			header = true;
+		}
+		pr_yaml(yaml, "      - stressor: %s\n", pi->item->stressor->name);
+		for (i = 0; i < SIZEOF_ARRAY(fields); i++) {
+			if (stress_perf_interval_stats(pi, fields[i].offset,
+						       &stats[i][0], &stats[i][1], &stats[i][2])) {
+				(void)snprintf(str[i], sizeof(str[i]), "%7.3f %7.3f %7.3f",
+					stats[i][0], stats[i][1], stats[i][2]);
+				pr_yaml(yaml, "        %s-min: %f\n", fields[i].name, stats[i][0]);
+				pr_yaml(yaml, "        %s-mean: %f\n", fields[i].name, stats[i][1]);
+				pr_yaml(yaml, "        %s-max: %f\n", fields[i].name, stats[i][2]);
+			} else {
+				(void)shim_strscpy(str[i], "n/a", sizeof(str[i]));
+			}
+		}
+		pr_inf("%-13s %7zu %23s %23s %23s\n", pi->item->stressor->name,
+			pi->n_samples, str[0], str[1], str[2]);
+
+		pr_yaml(yaml, "        samples:\n");
+		for (i = 0; i < pi->n_samples; i++) {
+			const stress_perf_sample_t *sample = &pi->samples[i];
+
+			pr_yaml(yaml, "          - time: %f\n", sample->time);
+			for (j = 0; j < SIZEOF_ARRAY(fields); j++) {
+				const double value = *(const double *)((const char *)sample + fields[j].offset);
+
+				if (value >= 0.0)
+					pr_yaml(yaml, "            %s: %f\n", fields[j].name, value);
+			}
+		}
+	}
+	if (header)
+		pr_yaml(yaml, "\n");
+	pr_block_end();
+}
+
+/*
+ *  stress_perf_interval_free()
+ *	free interval samples
+ */
+void stress_perf_interval_free(void)
+{
+	stress_perf_interval_t *pi = perf_interval_head;
+
+	while (pi) {
+		stress_perf_interval_t *next = pi->next;
+
+		free(pi->samples);
+		free(pi);
+		pi = next;
+	}
+	perf_interval_head = NULL;
+	perf_interval_tail = NULL;
+}
 #endif
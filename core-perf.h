@@ -26,17 +26,22 @@
 #define STRESS_PERF_STATS	(1)
 #define STRESS_PERF_INVALID	(~0ULL)
 #define STRESS_PERF_MAX		(128 + 32)
+#define STRESS_PERF_GROUP_MAX	(4)	/* max hardware events per group */
+#define STRESS_PERF_TOPDOWN_MAX	(5)	/* max top-down events */
 
 /* per perf counter info */
 typedef struct {
-	uint64_t counter;		/* perf counter */
+	uint64_t counter;		/* perf counter, scaled if multiplexed */
+	uint64_t time_enabled;		/* group time enabled, nanoseconds */
+	uint64_t time_running;		/* group time running, nanoseconds */
 	int	 fd;			/* perf per counter fd */
-	uint8_t	 padding[4];		/* padding */
+	int	 leader;		/* perf_stat index of group leader */
 } stress_perf_stat_t;
 
 /* per stressor perf info */
 typedef struct {
 	stress_perf_stat_t perf_stat[STRESS_PERF_MAX]; /* perf counters */
+	stress_perf_stat_t topdown[STRESS_PERF_TOPDOWN_MAX]; /* top-down counters */
 	int perf_opened;		/* count of opened counters */
 	uint8_t	padding[4];		/* padding */
 } stress_perf_t;
@@ -48,6 +53,11 @@ extern int stress_perf_close(stress_perf_t *sp);
 extern void stress_perf_stat_dump(FILE *yaml, stress_list_item_t *procs_head,
 	const double duration);
 extern void stress_perf_init(void);
+extern void stress_perf_topdown_dump(FILE *yaml, stress_list_item_t *stressors_list);
+extern void stress_perf_interval_start(stress_list_item_t *stressors_list);
+extern void stress_perf_interval_stop(void);
+extern void stress_perf_interval_dump(FILE *yaml);
+extern void stress_perf_interval_free(void);
 #endif
 
 #endif
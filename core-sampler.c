@@ -0,0 +1,515 @@
+/*
+ * Copyright (C) 2026 Colin Ian King.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include "stress-ng.h"
+#include "core-builtin.h"
+#include "core-pthread.h"
+#include "core-sampler.h"
+
+#include <float.h>
+
+#define SAMPLER_WINDOW_SECS	(0.1)	/* throughput window, seconds */
+#define SAMPLER_DEFAULT_HZ	(1000)	/* default rate for --stall-detect */
+
+/*
+ *  stress_sampler_window_samples()
+ *	number of samples in a throughput window, at least one, so
+ *	rates below 10 Hz have windows longer than SAMPLER_WINDOW_SECS
+ */
+static uint32_t stress_sampler_window_samples(const uint32_t sampler_hz)
+{
+	const uint32_t window = (uint32_t)((double)sampler_hz * SAMPLER_WINDOW_SECS);
+
+	return (window < 1) ? 1 : window;
+}
+
+#if defined(HAVE_LIB_PTHREAD)
+
+typedef struct {
+	stress_list_item_t *stressors_list;	/* stressors to sample */
+	double period;			/* sampling period, seconds */
+	double stall_threshold;		/* stall threshold, seconds, 0 = disabled */
+	uint32_t window;		/* samples per throughput window */
+} stress_sampler_ctxt_t;
+
+static pthread_t sampler_pthread;
+static int sampler_pthread_ret = -1;
+static volatile bool sampler_run;
+static stress_sampler_ctxt_t sampler_ctxt;
+
+/*
+ *  stress_sampler_active()
+ *	return true if the stressor instance is running
+ */
+static inline bool stress_sampler_active(const stress_stats_t *stats)
+{
+	return (stats->s_pid.pid > 0) && !stats->s_pid.reaped;
+}
+
+/*
+ *  stress_sampler_pid_cpu()
+ *	get the CPU a process last ran on from field 39 of
+ *	/proc/$pid/stat, returns -1 if it cannot be determined
+ */
+static int32_t stress_sampler_pid_cpu(const pid_t pid)
+{
+#if defined(__linux__)
+	char path[64];
+	char buf[1024];
+	char *ptr;
+	int field, cpu;
+
+	(void)snprintf(path, sizeof(path), "/proc/%" PRIdMAX "/stat", (intmax_t)pid);
+	if (stress_fs_file_read(path, buf, sizeof(buf)) <= 0)
+		return -1;
+	/* skip over pid and (comm), comm may contain spaces */
+	ptr = shim_strrchr(buf, ')');
+	if (!ptr)
+		return -1;
+	for (field = 2, ptr++; *ptr && (field < 39); ptr++) {
+		if (*ptr == ' ')
+			field++;
+	}
+	if (sscanf(ptr, "%d", &cpu) != 1)
+		return -1;
+	return (int32_t)cpu;
+#else
+	(void)pid;
+
+	return -1;
+#endif
+}
+
+/*
+ *  stress_sampler_stall_end()
+ *	end of a stall, account for the stall duration
+ */
+static void stress_sampler_stall_end(stress_sampler_t *sampler, const double t_end)
+{
+	const double duration = t_end - sampler->stall_advanced;
+
+	sampler->stall_total += duration;
+	if (sampler->stall_max < duration)
+		sampler->stall_max = duration;
+	if ((sampler->stalls > 0) && (sampler->stalls <= STRESS_STALLS_MAX))
+		sampler->stall[sampler->stalls - 1].duration = duration;
+	sampler->stalled = false;
+}
+
+/*
+ *  stress_sampler_stall_check()
+ *	check for instances where the bogo-op counter has not
+ *	advanced for more than the stall threshold. Instances are
+ *	only checked once their counter has advanced at least once
+ *	and up to the end of their run time, so start up and tear
+ *	down are not treated as stalls.
+ */
+static void stress_sampler_stall_check(
+	stress_list_item_t *stressors_list,
+	const double t_now,
+	const double threshold)
+{
+	stress_list_item_t *item;
+
+	for (item = stressors_list; item; item = item->next) {
+		int32_t i;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+
+		for (i = 0; i < item->instances; i++) {
+			stress_stats_t *stats = item->stats[i];
+			stress_sampler_t *sampler = &stats->sampler;
+			const uint64_t counter = stats->args.bogo.count.counter;
+			const double t_end = stats->args.time_end;
+			const bool active = stress_sampler_active(stats) &&
+					    (t_now < t_end) && stress_continue_flag();
+
+			if (sampler->stalled && ((counter != sampler->stall_counter) || !active))
+				stress_sampler_stall_end(sampler, active ? t_now : STRESS_MINIMUM(t_now, t_end));
+			if (!active)
+				continue;
+			/* stalls are only checked after the --warmup phase */
+			if (t_now < sampler->t_warmup) {
+				sampler->stall_counter = counter;
+				sampler->stall_advanced = 0.0;
+				continue;
+			}
+			if (counter != sampler->stall_counter) {
+				sampler->stall_counter = counter;
+				sampler->stall_advanced = t_now;
+				continue;
+			}
+			if ((sampler->stall_advanced <= 0.0) || sampler->stalled)
+				continue;
+			if ((t_now - sampler->stall_advanced) > threshold) {
+				if (sampler->stalls < STRESS_STALLS_MAX) {
+					stress_stall_t *stall = &sampler->stall[sampler->stalls];
+
+					stall->start = sampler->stall_advanced - g_shared->time_started;
+					stall->duration = t_now - sampler->stall_advanced;
+					stall->cpu = stress_sampler_pid_cpu(stats->s_pid.pid);
+				}
+				sampler->stalls++;
+				sampler->stalled = true;
+			}
+		}
+	}
+}
+
+/*
+ *  stress_sampler_window()
+ *	end of a throughput window, compute the window bogo-op
+ *	rate of each instance from the shared bogo-op counters
+ */
+static void stress_sampler_window(
+	stress_list_item_t *stressors_list,
+	const double t_now,
+	const double duration)
+{
+	stress_list_item_t *item;
+	const double scale = (duration > 0.0) ? 1.0 / duration : 0.0;
+	double total_rate = 0.0;
+
+	for (item = stressors_list; item; item = item->next) {
+		int32_t i;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+
+		for (i = 0; i < item->instances; i++) {
+			stress_stats_t *stats = item->stats[i];
+			stress_sampler_t *sampler = &stats->sampler;
+			const uint64_t counter = stats->args.bogo.count.counter;
+			uint64_t delta;
+			double rate;
+
+			if (!stress_sampler_active(stats))
+				continue;
+
+			/* counter is reset when a stressor is re-run */
+			delta = (counter >= sampler->counter_last) ?
+				counter - sampler->counter_last : counter;
+			sampler->counter_last = counter;
+			rate = (double)delta * scale;
+			sampler->rate = rate;
+			total_rate += rate;
+			/* windows in the --warmup phase are not accounted */
+			if (t_now < sampler->t_warmup)
+				continue;
+			if (sampler->windows == 0) {
+				sampler->rate_min = rate;
+				sampler->rate_max = rate;
+			} else {
+				if (sampler->rate_min > rate)
+					sampler->rate_min = rate;
+				if (sampler->rate_max < rate)
+					sampler->rate_max = rate;
+			}
+			sampler->rate_total += rate;
+			sampler->windows++;
+		}
+	}
+	g_shared->sampler.rate = total_rate;
+}
+
+/*
+ *  stress_sampler_pthread()
+ *	sampler thread, reads the shared bogo-op counters at
+ *	the sampling rate, it sends no signals and does not
+ *	interact with the stressors, so it does not perturb
+ *	them. All signals are blocked so that they are always
+ *	handled by the main thread.
+ */
+static void *stress_sampler_pthread(void *arg)
+{
+	stress_sampler_ctxt_t *ctxt = (stress_sampler_ctxt_t *)arg;
+	sigset_t set;
+	double t_next, t_window;
+	uint32_t samples = 0;
+
+	(void)sigfillset(&set);
+	(void)pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+	t_next = stress_time_now();
+	t_window = t_next;
+
+	while (sampler_run) {
+		double delta;
+
+		t_next += ctxt->period;
+		delta = t_next - stress_time_now();
+		if (delta > 0.0)
+			(void)shim_nanosleep_uint64((uint64_t)(delta * STRESS_DBL_NANOSECOND));
+
+		if (ctxt->stall_threshold > 0.0)
+			stress_sampler_stall_check(ctxt->stressors_list, stress_time_now(), ctxt->stall_threshold);
+
+		samples++;
+		if (samples >= ctxt->window) {
+			const double t_now = stress_time_now();
+
+			stress_sampler_window(ctxt->stressors_list, t_now, t_now - t_window);
+			t_window = t_now;
+			samples = 0;
+		}
+	}
+	return &g_nowt;
+}
+
+/*
+ *  stress_sampler_start()
+ *	start the --sampler bogo-op counter sampling thread
+ */
+void stress_sampler_start(stress_list_item_t *stressors_list)
+{
+	stress_list_item_t *item;
+	uint32_t sampler_hz = 0;
+	uint32_t stall_detect = 0;
+
+	(void)stress_setting_get("stall-detect", &stall_detect);
+	if (!stress_setting_get("sampler", &sampler_hz) || (sampler_hz == 0)) {
+		if (!stall_detect)
+			return;
+		/* --stall-detect without --sampler, use default rate */
+		sampler_hz = SAMPLER_DEFAULT_HZ;
+	}
+
+	/* prime the window start counters */
+	for (item = stressors_list; item; item = item->next) {
+		int32_t i;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+		for (i = 0; i < item->instances; i++) {
+			stress_stats_t *stats = item->stats[i];
+
+			stats->sampler.counter_last = stats->args.bogo.count.counter;
+			stats->sampler.stall_counter = stats->args.bogo.count.counter;
+			stats->sampler.stall_advanced = 0.0;
+			stats->sampler.stalled = false;
+		}
+	}
+
+	sampler_ctxt.stressors_list = stressors_list;
+	sampler_ctxt.period = 1.0 / (double)sampler_hz;
+	sampler_ctxt.stall_threshold = (double)stall_detect / 1000.0;
+	sampler_ctxt.window = stress_sampler_window_samples(sampler_hz);
+
+	g_shared->sampler.rate = 0.0;
+	g_shared->sampler.enabled = true;
+	sampler_run = true;
+	sampler_pthread_ret = pthread_create(&sampler_pthread, NULL,
+					stress_sampler_pthread, &sampler_ctxt);
+	if (sampler_pthread_ret != 0) {
+		pr_inf("sampler: cannot create sampler thread, errno=%d (%s), "
+			"sampling disabled\n", sampler_pthread_ret, strerror(sampler_pthread_ret));
+		sampler_run = false;
+		g_shared->sampler.enabled = false;
+	}
+}
+
+/*
+ *  stress_sampler_stop()
+ *	stop the sampling thread
+ */
+void stress_sampler_stop(void)
+{
+	stress_list_item_t *item;
+	const double t_now = stress_time_now();
+
+	if (sampler_pthread_ret != 0)
+		return;
+
+	sampler_run = false;
+	(void)pthread_join(sampler_pthread, NULL);
+	sampler_pthread_ret = -1;
+	g_shared->sampler.rate = 0.0;
+
+	/* account for any stalls still in progress */
+	for (item = sampler_ctxt.stressors_list; item; item = item->next) {
+		int32_t i;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+		for (i = 0; i < item->instances; i++) {
+			stress_stats_t *stats = item->stats[i];
+
+			if (stats->sampler.stalled)
+				stress_sampler_stall_end(&stats->sampler,
+					STRESS_MINIMUM(t_now, stats->args.time_end));
+		}
+	}
+}
+
+#else
+
+void stress_sampler_start(stress_list_item_t *stressors_list)
+{
+	uint32_t sampler_hz = 0;
+	uint32_t stall_detect = 0;
+
+	(void)stressors_list;
+
+	if ((stress_setting_get("sampler", &sampler_hz) && (sampler_hz > 0)) ||
+	    (stress_setting_get("stall-detect", &stall_detect) && (stall_detect > 0)))
+		pr_inf("sampler: pthreads not supported, sampling and stall detection disabled\n");
+}
+
+void stress_sampler_stop(void)
+{
+}
+
+#endif
+
+/*
+ *  stress_sampler_dump()
+ *	dump the sampler window throughput min/mean/max per stressor
+ */
+void stress_sampler_dump(FILE *yaml, stress_list_item_t *stressors_list)
+{
+	stress_list_item_t *item;
+	uint32_t sampler_hz = 0;
+	double window_secs;
+	bool pr_heading = false;
+
+	if (!stress_setting_get("sampler", &sampler_hz) || (sampler_hz == 0))
+		return;
+	window_secs = (double)stress_sampler_window_samples(sampler_hz) / (double)sampler_hz;
+
+	for (item = stressors_list; item; item = item->next) {
+		int32_t i;
+		uint64_t windows = 0;
+		double rate_min = DBL_MAX, rate_max = 0.0, rate_total = 0.0;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+
+		for (i = 0; i < item->instances; i++) {
+			const stress_sampler_t *sampler = &item->stats[i]->sampler;
+
+			if (sampler->windows == 0)
+				continue;
+			if (rate_min > sampler->rate_min)
+				rate_min = sampler->rate_min;
+			if (rate_max < sampler->rate_max)
+				rate_max = sampler->rate_max;
+			rate_total += sampler->rate_total;
+			windows += sampler->windows;
+		}
+		if (windows == 0)
+			continue;
+
+		if (!pr_heading) {
+			pr_inf("sampler: per instance bogo-ops/s over %.3f second windows:\n",
+				window_secs);
+			pr_inf("%-13s %8s %12s %12s %12s\n",
+				"stressor", "windows", "min", "mean", "max");
+			pr_yaml(yaml, "sampler:\n");
+			pr_heading = true;
+		}
+		pr_inf("%-13s %8" PRIu64 " %12.2f %12.2f %12.2f\n",
+			item->stressor->name, windows, rate_min,
+			rate_total / (double)windows, rate_max);
+
+		pr_yaml(yaml, "    - stressor: %s\n", item->stressor->name);
+		pr_yaml(yaml, "      window-secs: %f\n", window_secs);
+		pr_yaml(yaml, "      windows: %" PRIu64 "\n", windows);
+		pr_yaml(yaml, "      window-bogo-ops-per-second-min: %f\n", rate_min);
+		pr_yaml(yaml, "      window-bogo-ops-per-second-mean: %f\n", rate_total / (double)windows);
+		pr_yaml(yaml, "      window-bogo-ops-per-second-max: %f\n", rate_max);
+		pr_yaml(yaml, "      instances:\n");
+		for (i = 0; i < item->instances; i++) {
+			const stress_sampler_t *sampler = &item->stats[i]->sampler;
+
+			if (sampler->windows == 0)
+				continue;
+			pr_yaml(yaml, "          - instance: %" PRId32 "\n", i);
+			pr_yaml(yaml, "            windows: %" PRIu64 "\n", sampler->windows);
+			pr_yaml(yaml, "            window-bogo-ops-per-second-min: %f\n", sampler->rate_min);
+			pr_yaml(yaml, "            window-bogo-ops-per-second-mean: %f\n",
+				sampler->rate_total / (double)sampler->windows);
+			pr_yaml(yaml, "            window-bogo-ops-per-second-max: %f\n", sampler->rate_max);
+		}
+	}
+	if (pr_heading)
+		pr_yaml(yaml, "\n");
+}
+
+/*
+ *  stress_sampler_stalls_dump()
+ *	dump per instance bogo-op counter stalls found by --stall-detect
+ */
+void stress_sampler_stalls_dump(FILE *yaml, stress_list_item_t *stressors_list)
+{
+	stress_list_item_t *item;
+	uint32_t stall_detect = 0;
+	bool pr_heading = false;
+
+	if (!stress_setting_get("stall-detect", &stall_detect) || (stall_detect == 0))
+		return;
+
+	for (item = stressors_list; item; item = item->next) {
+		int32_t i;
+		bool pr_name = false;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+
+		for (i = 0; i < item->instances; i++) {
+			const stress_sampler_t *sampler = &item->stats[i]->sampler;
+			uint32_t j, n;
+
+			if (sampler->stalls == 0)
+				continue;
+
+			if (!pr_heading) {
+				pr_yaml(yaml, "stalls:\n");
+				pr_heading = true;
+			}
+			if (!pr_name) {
+				pr_inf("%s:\n", item->stressor->name);
+				pr_yaml(yaml, "    - stressor: %s\n", item->stressor->name);
+				pr_yaml(yaml, "      instances:\n");
+				pr_name = true;
+			}
+			pr_inf("%11s instance %" PRId32 ": %" PRIu32 " stall%s > %" PRIu32 " ms, "
+				"total %.3f secs, longest %.3f secs\n", "",
+				i, sampler->stalls, sampler->stalls > 1 ? "s" : "",
+				stall_detect, sampler->stall_total, sampler->stall_max);
+			pr_yaml(yaml, "          - instance: %" PRId32 "\n", i);
+			pr_yaml(yaml, "            stalls: %" PRIu32 "\n", sampler->stalls);
+			pr_yaml(yaml, "            stall-total-secs: %f\n", sampler->stall_total);
+			pr_yaml(yaml, "            stall-max-secs: %f\n", sampler->stall_max);
+			pr_yaml(yaml, "            events:\n");
+
+			n = STRESS_MINIMUM(sampler->stalls, STRESS_STALLS_MAX);
+			for (j = 0; j < n; j++) {
+				const stress_stall_t *stall = &sampler->stall[j];
+
+				pr_yaml(yaml, "                - start-secs: %f\n", stall->start);
+				pr_yaml(yaml, "                  duration-secs: %f\n", stall->duration);
+				pr_yaml(yaml, "                  cpu: %" PRId32 "\n", stall->cpu);
+			}
+		}
+	}
+	if (pr_heading)
+		pr_yaml(yaml, "\n");
+	else
+		pr_inf("stall-detect: no bogo-op counter stalls > %" PRIu32 " ms detected\n", stall_detect);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2026 Colin Ian King.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#ifndef CORE_SAMPLER_H
+#define CORE_SAMPLER_H
+
+#define STRESS_STALLS_MAX		(16)	/* stalls recorded per instance */
+
+/* Bogo-op counter stall event */
+typedef struct {
+	double start;			/* time stall started */
+	double duration;		/* stall duration in seconds */
+	int32_t cpu;			/* CPU instance was on, -1 = unknown */
+} stress_stall_t;
+
+/* Per stressor instance sampler window throughput and stall info */
+typedef struct {
+	uint64_t counter_last;		/* bogo-op counter at start of window */
+	double rate;			/* bogo-ops/sec of most recent window */
+	double rate_min;		/* minimum window bogo-ops/sec */
+	double rate_max;		/* maximum window bogo-ops/sec */
+	double rate_total;		/* sum of window bogo-ops/sec */
+	uint64_t windows;		/* number of complete windows */
+	uint64_t stall_counter;		/* bogo-op counter when it last advanced */
+	double stall_advanced;		/* time counter last advanced, 0 = not yet */
+	double stall_total;		/* total stalled time in seconds */
+	double stall_max;		/* longest stall in seconds */
+	uint32_t stalls;		/* number of stalls detected */
+	bool stalled;			/* true if currently stalled */
+	double t_warmup;		/* end of --warmup phase, not sampled before */
+	stress_stall_t stall[STRESS_STALLS_MAX];	/* first stalls detected */
+} stress_sampler_t;
+
+extern void stress_sampler_start(stress_list_item_t *stressors_list);
+extern void stress_sampler_stop(void);
+extern void stress_sampler_dump(FILE *yaml, stress_list_item_t *stressors_list);
+extern void stress_sampler_stalls_dump(FILE *yaml, stress_list_item_t *stressors_list);
+
+#endif
@@ -19,11 +19,25 @@
  */
 #include "stress-ng.h"
 #include "core-builtin.h"
+#include "core-hash.h"
 #include "core-setting.h"
 #include "core-sort.h"
 
+#define SETTING_HASH_SIZE	(509)	/* setting name hash table size, prime */
+
 static stress_setting_t *setting_head;	/* setting list head */
 static stress_setting_t *setting_tail;	/* setting list tail */
+static uint32_t setting_count;		/* number of settings in list */
+
+/* settings hashed by name, newest setting first in each bucket */
+static stress_setting_t *setting_hash[SETTING_HASH_SIZE];
+
+/* cached stress_setting_get() list cut off for a stressor item */
+static struct {
+	const stress_list_item_t *item;	/* item the cut off is for */
+	uint32_t limit;			/* settings at index >= limit are ignored */
+	bool valid;			/* false if settings changed */
+} setting_cutoff;
 
 typedef void (*pr_func_t)(const char *fmt, ...) FORMAT(printf, 1, 2);
 
@@ -45,6 +59,18 @@ void stress_setting_free(void)
 	}
 	setting_head = NULL;
 	setting_tail = NULL;
+	setting_count = 0;
+	(void)shim_memset(setting_hash, 0, sizeof(setting_hash));
+	setting_cutoff.valid = false;
+}
+
+/*
+ *  stress_setting_hash()
+ *	hash bucket of a setting name
+ */
+static inline stress_setting_t **stress_setting_hash(const char *name)
+{
+	return &setting_hash[stress_hash_djb2a(name) % SETTING_HASH_SIZE];
 }
 
 static void stress_setting_show_setting(
@@ -246,9 +272,9 @@ static int stress_setting_generic_set(
 		_exit(EXIT_NOT_SUCCESS);
 	}
 
-	for (setting = setting_head; setting; setting = setting->next) {
-		if ((shim_strcmp(setting->stressor_name, stressor_name) == 0) &&
-		    (shim_strcmp(setting->name, name) == 0)) {
+	for (setting = *stress_setting_hash(name); setting; setting = setting->hash_next) {
+		if ((shim_strcmp(setting->name, name) == 0) &&
+		    (shim_strcmp(setting->stressor_name, stressor_name) == 0)) {
 			new_setting = false;
 			break;
 		}
@@ -344,13 +370,20 @@ static int stress_setting_generic_set(
 #endif
 
 	if (new_setting) {
+		stress_setting_t **bucket = stress_setting_hash(name);
+
 		if (setting_tail) {
 			setting_tail->next = setting;
 		} else {
 			setting_head = setting;
 		}
 		setting_tail = setting;
+		setting->index = setting_count++;
+		setting->hash_next = *bucket;
+		*bucket = setting;
 	}
+	/* the item of an existing setting may have changed too */
+	setting_cutoff.valid = false;
 
 	return 0;
 err:
@@ -385,118 +418,127 @@ int stress_setting_global_set(
 }
 
 /*
- *  stress_setting_get()
- *	get an existing setting
+ *  stress_setting_cutoff()
+ *	settings are visible to the current stressor item up to
+ *	the end of the run of settings made for that item, find
+ *	the list index of the first setting past that point. The
+ *	result is cached until the current item or settings change.
  */
-bool stress_setting_get(const char *name, void *value)
+static uint32_t stress_setting_cutoff(void)
 {
-	stress_setting_t *setting;
-	bool set = false;
+	const stress_setting_t *setting;
 	bool found = false;
 
+	if (setting_cutoff.valid && (setting_cutoff.item == g_item_current))
+		return setting_cutoff.limit;
+
+	setting_cutoff.limit = setting_count;
 	for (setting = setting_head; setting; setting = setting->next) {
 		if (setting->item == g_item_current)
 			found = true;
-		if (found && ((setting->item != g_item_current) && (!setting->global)))
+		if (found && ((setting->item != g_item_current) && (!setting->global))) {
+			setting_cutoff.limit = setting->index;
+			break;
+		}
+	}
+	setting_cutoff.item = g_item_current;
+	setting_cutoff.valid = true;
+
+	return setting_cutoff.limit;
+}
+
+/*
+ *  stress_setting_get()
+ *	get an existing setting, the most recent setting
+ *	of the given name before the cut off is used
+ */
+bool stress_setting_get(const char *name, void *value)
+{
+	const stress_setting_t *setting;
+	const uint32_t limit = stress_setting_cutoff();
+
+	for (setting = *stress_setting_hash(name); setting; setting = setting->hash_next) {
+		if ((setting->index < limit) && !shim_strcmp(setting->name, name))
 			break;
+	}
+	if (!setting)
+		return false;
 
-		if (!shim_strcmp(setting->name, name)) {
-			switch (setting->type_id) {
-			case TYPE_ID_UINT8:
-				set = true;
-				*(uint8_t *)value = setting->u.uint8;
-				break;
-			case TYPE_ID_INT8:
-				set = true;
-				*(int8_t *)value = setting->u.int8;
-				break;
-			case TYPE_ID_UINT16:
-				set = true;
-				*(uint16_t *)value = setting->u.uint16;
-				break;
-			case TYPE_ID_INT16:
-				set = true;
-				*(int16_t *)value = setting->u.int16;
-				break;
-			case TYPE_ID_UINT32:
-			case TYPE_ID_UINT32_TIME:
-				set = true;
-				*(uint32_t *)value = setting->u.uint32;
-				break;
-			case TYPE_ID_INT32:
-			case TYPE_ID_INT32_TIME:
-				set = true;
-				*(int32_t *)value = setting->u.int32;
-				break;
-			case TYPE_ID_INT32_CPU_PERCENT:
-				set = true;
-				*(int32_t *)value = setting->u.int32;
-				break;
-			case TYPE_ID_UINT64:
-			case TYPE_ID_UINT64_BYTES:
-			case TYPE_ID_UINT64_BYTES_FS:
-			case TYPE_ID_UINT64_BYTES_VM:
-			case TYPE_ID_UINT64_TIME:
-				set = true;
-				*(uint64_t *)value = setting->u.uint64;
-				break;
-			case TYPE_ID_UINT64_BYTES_FS_PERCENT:
-				set = true;
-				*(uint64_t *)value = setting->u.uint64 * (stress_fs_size_get() / 100);
-				break;
-			case TYPE_ID_INT64:
-				set = true;
-				*(int64_t *)value = setting->u.int64;
-				break;
-			case TYPE_ID_SIZE_T:
-			case TYPE_ID_SIZE_T_BYTES:
-			case TYPE_ID_SIZE_T_BYTES_FS:
-			case TYPE_ID_SIZE_T_BYTES_VM:
-			case TYPE_ID_SIZE_T_METHOD:
-				set = true;
-				*(size_t *)value = setting->u.size;
-				break;
-			case TYPE_ID_SIZE_T_BYTES_FS_PERCENT:
-				set = true;
-				*(size_t *)value = setting->u.size * (stress_fs_size_get() / 100);
-				break;
-			case TYPE_ID_SSIZE_T:
-				set = true;
-				*(ssize_t *)value = setting->u.ssize;
-				break;
-			case TYPE_ID_UINT:
-				set = true;
-				*(unsigned int *)value = setting->u.uint;
-				break;
-			case TYPE_ID_INT:
-			case TYPE_ID_INT_DOMAIN:
-			case TYPE_ID_INT_PORT:
-				set = true;
-				*(int *)value = setting->u.sint;
-				break;
-			case TYPE_ID_OFF_T:
-				set = true;
-				*(off_t *)value = setting->u.off;
-				break;
-			case TYPE_ID_STR:
-				set = true;
-				*(const char **)value = setting->u.str;
-				break;
-			case TYPE_ID_BOOL:
-				set = true;
-				*(bool *)value = setting->u.boolean;
-				break;
-			case TYPE_ID_UNDEFINED:
-			default:
-				set = true;
-				break;
-			}
+	switch (setting->type_id) {
+	case TYPE_ID_UINT8:
+		*(uint8_t *)value = setting->u.uint8;
+		break;
+	case TYPE_ID_INT8:
+		*(int8_t *)value = setting->u.int8;
+		break;
+	case TYPE_ID_UINT16:
+		*(uint16_t *)value = setting->u.uint16;
+		break;
+	case TYPE_ID_INT16:
+		*(int16_t *)value = setting->u.int16;
+		break;
+	case TYPE_ID_UINT32:
+	case TYPE_ID_UINT32_TIME:
+		*(uint32_t *)value = setting->u.uint32;
+		break;
+	case TYPE_ID_INT32:
+	case TYPE_ID_INT32_TIME:
+		*(int32_t *)value = setting->u.int32;
+		break;
+	case TYPE_ID_INT32_CPU_PERCENT:
+		*(int32_t *)value = setting->u.int32;
+		break;
+	case TYPE_ID_UINT64:
+	case TYPE_ID_UINT64_BYTES:
+	case TYPE_ID_UINT64_BYTES_FS:
+	case TYPE_ID_UINT64_BYTES_VM:
+	case TYPE_ID_UINT64_TIME:
+		*(uint64_t *)value = setting->u.uint64;
+		break;
+	case TYPE_ID_UINT64_BYTES_FS_PERCENT:
+		*(uint64_t *)value = setting->u.uint64 * (stress_fs_size_get() / 100);
+		break;
+	case TYPE_ID_INT64:
+		*(int64_t *)value = setting->u.int64;
+		break;
+	case TYPE_ID_SIZE_T:
+	case TYPE_ID_SIZE_T_BYTES:
+	case TYPE_ID_SIZE_T_BYTES_FS:
+	case TYPE_ID_SIZE_T_BYTES_VM:
+	case TYPE_ID_SIZE_T_METHOD:
+		*(size_t *)value = setting->u.size;
+		break;
+	case TYPE_ID_SIZE_T_BYTES_FS_PERCENT:
+		*(size_t *)value = setting->u.size * (stress_fs_size_get() / 100);
+		break;
+	case TYPE_ID_SSIZE_T:
+		*(ssize_t *)value = setting->u.ssize;
+		break;
+	case TYPE_ID_UINT:
+		*(unsigned int *)value = setting->u.uint;
+		break;
+	case TYPE_ID_INT:
+	case TYPE_ID_INT_DOMAIN:
+	case TYPE_ID_INT_PORT:
+		*(int *)value = setting->u.sint;
+		break;
+	case TYPE_ID_OFF_T:
+		*(off_t *)value = setting->u.off;
+		break;
+	case TYPE_ID_STR:
+		*(const char **)value = setting->u.str;
+		break;
+	case TYPE_ID_BOOL:
+		*(bool *)value = setting->u.boolean;
+		break;
+	case TYPE_ID_UNDEFINED:
+	default:
+		break;
+	}
 #if defined(DEBUG_SETTINGS)
-			stress_setting_show_setting(setting, pr_dbg, true);
+	stress_setting_show_setting(setting, pr_dbg, true);
 #endif
-		}
-	}
-	return set;
+	return true;
 }
 
 /*
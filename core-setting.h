@@ -58,6 +58,8 @@ typedef enum {
 /* settings for storing opt arg parsed data */
 typedef struct stress_setting {
 	struct stress_setting *next;	/* next setting in list */
+	struct stress_setting *hash_next; /* next setting in hash bucket */
+	uint32_t	index;		/* position in setting list */
 	stress_list_item_t *item;	/* stressor list item */
 	const char *stressor_name;	/* name of stressor */
 	const char *name;		/* name of setting */
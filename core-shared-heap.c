@@ -34,6 +34,11 @@ typedef struct stress_shared_heap_str {
 	char str[];
 } stress_shared_heap_str_t;
 
+#if defined(HAVE_ATOMIC_COMPARE_EXCHANGE) &&	\
+    defined(HAVE_ATOMIC_LOAD_N)
+#define SHARED_HEAP_LOCK_FREE
+#endif
+
 /*
  *  stress_shared_heap_init()
  *	initialized shared heap
@@ -42,26 +47,29 @@ void *stress_shared_heap_init(const size_t metrics_size)
 {
 	const size_t page_size = stress_memory_page_size_get();
 	size_t size = (metrics_size > 0) ? metrics_size : 1;	/* at least one metric */
+	shared_heap_t *sh = &g_shared->shared_heap;
 
 	/* and round up to multiple of pages */
 	size = (size + page_size - 1) & ~(page_size - 1);
-	g_shared->shared_heap.out_of_memory = false;
-	g_shared->shared_heap.heap_size = size;
-	g_shared->shared_heap.str_list_head = NULL;
-	g_shared->shared_heap.heap = stress_mmap_anon_shared(size, PROT_READ | PROT_WRITE);
-	if (UNLIKELY(g_shared->shared_heap.heap == MAP_FAILED)) {
-		g_shared->shared_heap.lock = NULL;
+	sh->out_of_memory = false;
+	sh->heap_size = size;
+	sh->offset = 0;
+	sh->str_list_head = NULL;
+	sh->heap = stress_mmap_anon_shared(size, PROT_READ | PROT_WRITE);
+	if (UNLIKELY(sh->heap == MAP_FAILED)) {
+		sh->heap = NULL;
+		sh->lock = NULL;
 		return NULL;
 	}
-	stress_memory_anon_name_set(g_shared->shared_heap.heap, size, "shared-heap");
-	(void)stress_madvise_mergeable(g_shared->shared_heap.heap, size);
-	g_shared->shared_heap.lock = stress_lock_create("shared-heap");
-	if (UNLIKELY(!g_shared->shared_heap.lock)) {
-		(void)stress_munmap_anon_shared(g_shared->shared_heap.heap, g_shared->shared_heap.heap_size);
-		g_shared->shared_heap.heap = NULL;
+	stress_memory_anon_name_set(sh->heap, size, "shared-heap");
+	(void)stress_madvise_mergeable(sh->heap, size);
+	sh->lock = stress_lock_create_method("shared-heap", 0);
+	if (UNLIKELY(!sh->lock)) {
+		(void)stress_munmap_anon_shared(sh->heap, sh->heap_size);
+		sh->heap = NULL;
 		return NULL;
 	}
-	return g_shared->shared_heap.lock;
+	return sh->lock;
 }
 
 /*
@@ -92,26 +100,44 @@ void stress_shared_heap_free(void)
 /*
  *  stress_shared_heap_malloc()
  *	Primitive non-free'ing heap allocator. Just return next allocated chunk from
- *	the shared memory heap. We don't use need a per-object free'ing, so no need
- *	to keep track of holes or do hole coalescing. Keep it simple for now.
+ *	the shared memory heap. All the allocations are made at start up and live
+ *	until the metrics are dumped at exit, so there is no per-object free'ing.
+ *	The offset is bumped with a compare and exchange so it is never moved past
+ *	the end of the heap, the heap lock is only used if atomics are not available.
  */
 void *stress_shared_heap_malloc(const size_t size)
 {
-	ssize_t heap_free;
-	void *ptr;
+	shared_heap_t *sh = &g_shared->shared_heap;
+	const size_t aligned_size = (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
+	size_t offset;
 
-	if (UNLIKELY(stress_lock_acquire(g_shared->shared_heap.lock) < 0))
+	if (UNLIKELY(!sh->heap))
 		return NULL;
+#if defined(SHARED_HEAP_LOCK_FREE)
+	offset = __atomic_load_n(&sh->offset, __ATOMIC_RELAXED);
+	do {
+		size_t new_offset;
 
-	heap_free = g_shared->shared_heap.heap_size - g_shared->shared_heap.offset;
-	if (heap_free < (ssize_t)size) {
-		g_shared->shared_heap.out_of_memory = true;
-		(void)stress_lock_release(g_shared->shared_heap.lock);
+		if (UNLIKELY(sh->heap_size - offset < aligned_size)) {
+			sh->out_of_memory = true;
+			return NULL;
+		}
+		new_offset = offset + aligned_size;
+		if (__atomic_compare_exchange(&sh->offset, &offset, &new_offset, false,
+					      __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+			break;
+	} while (true);
+#else
+	if (UNLIKELY(stress_lock_acquire(sh->lock) < 0))
+		return NULL;
+	offset = sh->offset;
+	if (sh->heap_size - offset < aligned_size) {
+		sh->out_of_memory = true;
+		(void)stress_lock_release(sh->lock);
 		return NULL;
 	}
-	ptr = (void *)((uintptr_t)g_shared->shared_heap.heap + g_shared->shared_heap.offset);
-	g_shared->shared_heap.offset += (size + sizeof(void *) - 1) & ~(sizeof(void *) - 1);
-	(void)stress_lock_release(g_shared->shared_heap.lock);
-
-	return ptr;
+	sh->offset += aligned_size;
+	(void)stress_lock_release(sh->lock);
+#endif
+	return (void *)((uintptr_t)sh->heap + offset);
 }
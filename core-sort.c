@@ -17,12 +17,43 @@
  *
  */
 #include "stress-ng.h"
+#include "core-builtin.h"
+#include "core-helper.h"
+#include "core-pthread.h"
 #include "core-sort.h"
 #include "core-pragma.h"
 #include "core-target-clones.h"
 
+#include <math.h>
+
 #define THRESH	(63)
 
+#define SORT_DATA_RANDOM	(0)
+#define SORT_DATA_SORTED	(1)
+#define SORT_DATA_REVERSE	(2)
+#define SORT_DATA_NEARLY_SORTED	(3)
+#define SORT_DATA_FEW_UNIQUE	(4)
+#define SORT_DATA_ZIPF		(5)
+#define SORT_DATA_ORGAN_PIPE	(6)
+#define SORT_DATA_SAWTOOTH	(7)
+
+#define SORT_DATA_FEW_VALUES	(16)	/* distinct values, few-unique */
+#define SORT_DATA_TEETH		(64)	/* number of runs, sawtooth */
+
+static const char * const stress_sort_data_names[] = {
+	"random",
+	"sorted",
+	"reverse",
+	"nearly-sorted",
+	"few-unique",
+	"zipf",
+	"organ-pipe",
+	"sawtooth",
+};
+
+static size_t stress_sort_data_type = SORT_DATA_RANDOM;
+static bool stress_sort_data_type_set = false;
+
 uint64_t stress_sort_compares ALIGN64;
 
 /*
@@ -121,6 +152,175 @@ PRAGMA_UNROLL_N(8)
 	}
 }
 
+/*
+ *  stress_sort_data_method()
+ *	return name of the i'th --sort-data distribution, NULL if out of range
+ */
+const char *stress_sort_data_method(const size_t i)
+{
+	return (i < SIZEOF_ARRAY(stress_sort_data_names)) ? stress_sort_data_names[i] : NULL;
+}
+
+/*
+ *  stress_sort_data_int32_reverse()
+ *	reverse the order of the data
+ */
+static void OPTIMIZE3 stress_sort_data_int32_reverse(int32_t *data, const size_t n)
+{
+	register int32_t *lo = data, *hi = data + n - 1;
+
+	while (lo < hi) {
+		register const int32_t tmp = *lo;
+
+		*(lo++) = *hi;
+		*(hi--) = tmp;
+	}
+}
+
+/*
+ *  stress_sort_data_int32_nearly_sorted()
+ *	monotonically increasing values with 1% of the
+ *	values swapped with randomly chosen values
+ */
+static void OPTIMIZE3 stress_sort_data_int32_nearly_sorted(int32_t *data, const size_t n)
+{
+	size_t k;
+
+	stress_sort_data_int32_init(data, n);
+	for (k = (n / 100) + 1; k; k--) {
+		register const size_t i = (size_t)stress_mwc32modn((uint32_t)n);
+		register const size_t j = (size_t)stress_mwc32modn((uint32_t)n);
+		register const int32_t tmp = data[i];
+
+		data[i] = data[j];
+		data[j] = tmp;
+	}
+}
+
+/*
+ *  stress_sort_data_int32_few_unique()
+ *	random selection of a few distinct values, lots of duplicates
+ */
+static void OPTIMIZE3 stress_sort_data_int32_few_unique(int32_t *data, const size_t n)
+{
+	register size_t i;
+
+	for (i = 0; i < n; i++)
+		data[i] = (int32_t)((stress_mwc8() % SORT_DATA_FEW_VALUES) + 1) * 1000;
+}
+
+/*
+ *  stress_sort_data_int32_zipf()
+ *	values 1..n with value k occurring with a probability of
+ *	approx 1/k, Zipf's law with s = 1, computed by raising
+ *	(n + 1) to the power of a uniform random value in [0..1)
+ */
+static void OPTIMIZE3 stress_sort_data_int32_zipf(int32_t *data, const size_t n)
+{
+	const double ln = log((double)n + 1.0);
+	const double scale = ln / 4294967296.0;
+	register size_t i;
+
+	for (i = 0; i < n; i++)
+		data[i] = (int32_t)exp(scale * (double)stress_mwc32());
+}
+
+/*
+ *  stress_sort_data_int32_organ_pipe()
+ *	even values increasing in the first half and odd values
+ *	decreasing in the second half, all values are unique
+ */
+static void OPTIMIZE3 stress_sort_data_int32_organ_pipe(int32_t *data, const size_t n)
+{
+	register size_t i;
+
+	for (i = 0; i < (n + 1) / 2; i++)
+		data[i] = (int32_t)(i * 2);
+	for (i = 0; i < n / 2; i++)
+		data[n - 1 - i] = (int32_t)((i * 2) + 1);
+}
+
+/*
+ *  stress_sort_data_int32_sawtooth()
+ *	SORT_DATA_TEETH runs of increasing values, all values are unique
+ */
+static void OPTIMIZE3 stress_sort_data_int32_sawtooth(int32_t *data, const size_t n)
+{
+	const size_t len = (n + SORT_DATA_TEETH - 1) / SORT_DATA_TEETH;
+	register size_t i;
+
+	for (i = 0; i < n; i++)
+		data[i] = (int32_t)(((i % len) * SORT_DATA_TEETH) + (i / len));
+}
+
+/*
+ *  stress_sort_data_int32()
+ *	fill data with the --sort-data distribution. The default
+ *	random distribution shuffles data that has already been
+ *	initialized with stress_sort_data_int32_init(). Flag
+ *	STRESS_SORT_DATA_SORTED returns the data in ascending order
+ *	for searching, STRESS_SORT_DATA_UNIQUE avoids distributions
+ *	with duplicate values.
+ */
+void stress_sort_data_int32(int32_t *data, const size_t n, const int flags)
+{
+	if (!stress_sort_data_type_set) {
+		(void)stress_setting_get("sort-data", &stress_sort_data_type);
+		stress_sort_data_type_set = true;
+	}
+	if (n < 1)
+		return;
+
+	switch (stress_sort_data_type) {
+	case SORT_DATA_SORTED:
+		stress_sort_data_int32_init(data, n);
+		break;
+	case SORT_DATA_REVERSE:
+		stress_sort_data_int32_init(data, n);
+		if (!(flags & STRESS_SORT_DATA_SORTED))
+			stress_sort_data_int32_reverse(data, n);
+		break;
+	case SORT_DATA_NEARLY_SORTED:
+		if (flags & STRESS_SORT_DATA_SORTED)
+			stress_sort_data_int32_init(data, n);
+		else
+			stress_sort_data_int32_nearly_sorted(data, n);
+		break;
+	case SORT_DATA_FEW_UNIQUE:
+	case SORT_DATA_ZIPF:
+		/* duplicate values, fall back to random unique values */
+		if (flags & STRESS_SORT_DATA_UNIQUE)
+			goto random;
+		if (stress_sort_data_type == SORT_DATA_FEW_UNIQUE)
+			stress_sort_data_int32_few_unique(data, n);
+		else
+			stress_sort_data_int32_zipf(data, n);
+		if (flags & STRESS_SORT_DATA_SORTED)
+			stress_sort_radix_lsd(data, n, sizeof(*data), stress_sort_cmp_fwd_int32);
+		break;
+	case SORT_DATA_ORGAN_PIPE:
+		if (flags & STRESS_SORT_DATA_SORTED)
+			stress_sort_data_int32_init(data, n);
+		else
+			stress_sort_data_int32_organ_pipe(data, n);
+		break;
+	case SORT_DATA_SAWTOOTH:
+		if (flags & STRESS_SORT_DATA_SORTED)
+			stress_sort_data_int32_init(data, n);
+		else
+			stress_sort_data_int32_sawtooth(data, n);
+		break;
+	case SORT_DATA_RANDOM:
+	default:
+random:
+		if (flags & STRESS_SORT_DATA_SORTED)
+			stress_sort_data_int32_init(data, n);
+		else
+			stress_sort_data_int32_shuffle(data, n);
+		break;
+	}
+}
+
 static void OPTIMIZE3 sort_swap8(void *p1, void *p2, register const size_t size)
 {
 	register uint64_t tmp64;
@@ -374,3 +574,883 @@ void TARGET_CLONES OPTIMIZE3 qsort_bm(
 	if (s > es)
 		qsort_bm(pn - s, s / es, es, cmp);
 }
+
+/*
+ *  Sort engines, qsort compatible sort functions that can be
+ *  selected by the sorting stressors --*sort-method options
+ */
+#define PDQ_INSERTION_THRESHOLD		(24)
+#define PDQ_NINTHER_THRESHOLD		(128)
+#define PDQ_PARTIAL_INSERTION_LIMIT	(8)
+#define NETSORT_N			(16)	/* sorting network size */
+#define MERGESORT_MT_THREADS_MAX	(8)
+#define MERGESORT_MT_MIN_PER_THREAD	(4096)	/* min elements per thread */
+#define MERGESORT_INSERTION_THRESHOLD	(16)
+
+typedef int (*stress_sort_cmp_func_t)(const void *, const void *);
+
+/* pdqsort state shared across the recursion */
+typedef struct {
+	size_t es;				/* element size */
+	stress_sort_cmp_func_t cmp;		/* comparison function */
+	stress_sort_swap_func_t swap;		/* element swap function */
+} stress_sort_pdq_t;
+
+/* merge sort state, one per thread */
+typedef struct {
+	uint8_t *base;				/* data to sort */
+	uint8_t *tmp;				/* temporary merge buffer */
+	size_t lo;				/* first element */
+	size_t mid;				/* first element of 2nd run */
+	size_t hi;				/* end element */
+	size_t es;				/* element size */
+	stress_sort_cmp_func_t cmp;		/* comparison function */
+	stress_sort_copy_func_t copy;		/* element copy function */
+	uint64_t compares;			/* comparisons made by this thread */
+} stress_sort_merge_t;
+
+/*
+ *  stress_sort_int32_ascending()
+ *	probe the comparator with two int32 values, returns true
+ *	if it orders them in ascending order. The int32 specific
+ *	engines use this to sort the keys directly without calling
+ *	the comparator on every comparison
+ */
+static bool stress_sort_int32_ascending(const stress_sort_cmp_func_t cmp)
+{
+	const int32_t lo = -1, hi = 1;
+
+	return cmp(&lo, &hi) <= 0;
+}
+
+/*
+ *  stress_sort_pdq_insertion()
+ *	insertion sort of [begin, end)
+ */
+static void OPTIMIZE3 stress_sort_pdq_insertion(
+	uint8_t *begin,
+	uint8_t *end,
+	const stress_sort_pdq_t *pdq)
+{
+	const size_t es = pdq->es;
+	uint8_t *cur;
+
+	for (cur = begin + es; cur < end; cur += es) {
+		register uint8_t *sift;
+
+		for (sift = cur; (sift > begin) && (pdq->cmp(sift - es, sift) > 0); sift -= es)
+			pdq->swap(sift - es, sift, es);
+	}
+}
+
+/*
+ *  stress_sort_pdq_partial_insertion()
+ *	insertion sort of [begin, end) that gives up if more than
+ *	PDQ_PARTIAL_INSERTION_LIMIT elements are moved, returns
+ *	true if the data got sorted
+ */
+static bool OPTIMIZE3 stress_sort_pdq_partial_insertion(
+	uint8_t *begin,
+	uint8_t *end,
+	const stress_sort_pdq_t *pdq)
+{
+	const size_t es = pdq->es;
+	uint8_t *cur;
+	size_t moved = 0;
+
+	for (cur = begin + es; cur < end; cur += es) {
+		register uint8_t *sift;
+
+		for (sift = cur; (sift > begin) && (pdq->cmp(sift - es, sift) > 0); sift -= es) {
+			pdq->swap(sift - es, sift, es);
+			if (++moved > PDQ_PARTIAL_INSERTION_LIMIT)
+				return false;
+		}
+	}
+	return true;
+}
+
+/*
+ *  stress_sort_pdq_sort3()
+ *	sort the 3 elements a, b, c
+ */
+static inline void OPTIMIZE3 stress_sort_pdq_sort3(
+	uint8_t *a,
+	uint8_t *b,
+	uint8_t *c,
+	const stress_sort_pdq_t *pdq)
+{
+	if (pdq->cmp(b, a) < 0)
+		pdq->swap(a, b, pdq->es);
+	if (pdq->cmp(c, b) < 0) {
+		pdq->swap(b, c, pdq->es);
+		if (pdq->cmp(b, a) < 0)
+			pdq->swap(a, b, pdq->es);
+	}
+}
+
+/*
+ *  stress_sort_pdq_heapsort()
+ *	heapsort fallback for when too many bad partitions occur
+ */
+static void OPTIMIZE3 stress_sort_pdq_heapsort(
+	uint8_t *begin,
+	const size_t n,
+	const stress_sort_pdq_t *pdq)
+{
+	const size_t es = pdq->es;
+	size_t i, end;
+
+	for (i = n / 2; i-- > 0; ) {
+		size_t root = i;
+
+		for (;;) {
+			size_t child = (2 * root) + 1;
+
+			if (child >= n)
+				break;
+			if ((child + 1 < n) && (pdq->cmp(begin + (child * es), begin + ((child + 1) * es)) < 0))
+				child++;
+			if (pdq->cmp(begin + (root * es), begin + (child * es)) >= 0)
+				break;
+			pdq->swap(begin + (root * es), begin + (child * es), es);
+			root = child;
+		}
+	}
+	for (end = n - 1; end > 0; end--) {
+		size_t root = 0;
+
+		pdq->swap(begin, begin + (end * es), es);
+		for (;;) {
+			size_t child = (2 * root) + 1;
+
+			if (child >= end)
+				break;
+			if ((child + 1 < end) && (pdq->cmp(begin + (child * es), begin + ((child + 1) * es)) < 0))
+				child++;
+			if (pdq->cmp(begin + (root * es), begin + (child * es)) >= 0)
+				break;
+			pdq->swap(begin + (root * es), begin + (child * es), es);
+			root = child;
+		}
+	}
+}
+
+/*
+ *  stress_sort_pdq_partition_right()
+ *	partition [begin, end) around the pivot at begin, elements
+ *	less than the pivot go to the left, returns the final pivot
+ *	position. already_partitioned is set if no swaps were required
+ */
+static uint8_t OPTIMIZE3 *stress_sort_pdq_partition_right(
+	uint8_t *begin,
+	uint8_t *end,
+	bool *already_partitioned,
+	const stress_sort_pdq_t *pdq)
+{
+	const size_t es = pdq->es;
+	uint8_t *first = begin + es;
+	uint8_t *last = end - es;
+
+	while ((first <= last) && (pdq->cmp(first, begin) < 0))
+		first += es;
+	while ((first <= last) && (pdq->cmp(last, begin) >= 0))
+		last -= es;
+	*already_partitioned = (first > last);
+
+	while (first < last) {
+		pdq->swap(first, last, es);
+		first += es;
+		last -= es;
+		while ((first <= last) && (pdq->cmp(first, begin) < 0))
+			first += es;
+		while ((first <= last) && (pdq->cmp(last, begin) >= 0))
+			last -= es;
+	}
+	pdq->swap(begin, last, es);
+	return last;
+}
+
+/*
+ *  stress_sort_pdq_partition_left()
+ *	partition [begin, end) around the pivot at begin, elements
+ *	less than or equal to the pivot go to the left, used when
+ *	there are many elements equal to the pivot
+ */
+static uint8_t OPTIMIZE3 *stress_sort_pdq_partition_left(
+	uint8_t *begin,
+	uint8_t *end,
+	const stress_sort_pdq_t *pdq)
+{
+	const size_t es = pdq->es;
+	uint8_t *first = begin + es;
+	uint8_t *last = end - es;
+
+	while ((first <= last) && (pdq->cmp(begin, last) < 0))
+		last -= es;
+	while ((first <= last) && (pdq->cmp(begin, first) >= 0))
+		first += es;
+
+	while (first < last) {
+		pdq->swap(first, last, es);
+		first += es;
+		last -= es;
+		while ((first <= last) && (pdq->cmp(begin, last) < 0))
+			last -= es;
+		while ((first <= last) && (pdq->cmp(begin, first) >= 0))
+			first += es;
+	}
+	pdq->swap(begin, last, es);
+	return last;
+}
+
+/*
+ *  stress_sort_pdq_loop()
+ *	pattern-defeating quicksort loop, based on Orson Peters'
+ *	pdqsort, https://arxiv.org/abs/2106.05123
+ */
+static void OPTIMIZE3 stress_sort_pdq_loop(
+	uint8_t *begin,
+	uint8_t *end,
+	const stress_sort_pdq_t *pdq,
+	int bad_allowed,
+	bool leftmost)
+{
+	const size_t es = pdq->es;
+
+	for (;;) {
+		const size_t size = (size_t)(end - begin) / es;
+		const size_t s2 = size / 2;
+		size_t l_size, r_size;
+		uint8_t *pivot;
+		bool already_partitioned;
+
+		if (size < PDQ_INSERTION_THRESHOLD) {
+			stress_sort_pdq_insertion(begin, end, pdq);
+			return;
+		}
+
+		/* move median of 3 or pseudo median of 9 to begin */
+		if (size > PDQ_NINTHER_THRESHOLD) {
+			stress_sort_pdq_sort3(begin, begin + (s2 * es), end - es, pdq);
+			stress_sort_pdq_sort3(begin + es, begin + ((s2 - 1) * es), end - (2 * es), pdq);
+			stress_sort_pdq_sort3(begin + (2 * es), begin + ((s2 + 1) * es), end - (3 * es), pdq);
+			stress_sort_pdq_sort3(begin + ((s2 - 1) * es), begin + (s2 * es), begin + ((s2 + 1) * es), pdq);
+			pdq->swap(begin, begin + (s2 * es), es);
+		} else {
+			stress_sort_pdq_sort3(begin + (s2 * es), begin, end - es, pdq);
+		}
+
+		/*
+		 *  if the pivot equals the element before this range then
+		 *  all the elements equal to the pivot can be skipped over
+		 */
+		if (!leftmost && (pdq->cmp(begin - es, begin) >= 0)) {
+			begin = stress_sort_pdq_partition_left(begin, end, pdq) + es;
+			continue;
+		}
+
+		pivot = stress_sort_pdq_partition_right(begin, end, &already_partitioned, pdq);
+		l_size = (size_t)(pivot - begin) / es;
+		r_size = (size_t)(end - (pivot + es)) / es;
+
+		if ((l_size < size / 8) || (r_size < size / 8)) {
+			/* bad partition, fall back to heapsort if too many */
+			if (--bad_allowed == 0) {
+				stress_sort_pdq_heapsort(begin, size, pdq);
+				return;
+			}
+			/* break up patterns that cause bad partitions */
+			if (l_size >= PDQ_INSERTION_THRESHOLD) {
+				const size_t q = l_size / 4;
+
+				pdq->swap(begin, begin + (q * es), es);
+				pdq->swap(pivot - es, pivot - (q * es), es);
+				if (l_size > PDQ_NINTHER_THRESHOLD) {
+					pdq->swap(begin + es, begin + ((q + 1) * es), es);
+					pdq->swap(begin + (2 * es), begin + ((q + 2) * es), es);
+					pdq->swap(pivot - (2 * es), pivot - ((q + 1) * es), es);
+					pdq->swap(pivot - (3 * es), pivot - ((q + 2) * es), es);
+				}
+			}
+			if (r_size >= PDQ_INSERTION_THRESHOLD) {
+				const size_t q = r_size / 4;
+
+				pdq->swap(pivot + es, pivot + ((q + 1) * es), es);
+				pdq->swap(end - es, end - (q * es), es);
+				if (r_size > PDQ_NINTHER_THRESHOLD) {
+					pdq->swap(pivot + (2 * es), pivot + ((q + 2) * es), es);
+					pdq->swap(pivot + (3 * es), pivot + ((q + 3) * es), es);
+					pdq->swap(end - (2 * es), end - ((q + 1) * es), es);
+					pdq->swap(end - (3 * es), end - ((q + 2) * es), es);
+				}
+			}
+		} else if (already_partitioned &&
+			   stress_sort_pdq_partial_insertion(begin, pivot, pdq) &&
+			   stress_sort_pdq_partial_insertion(pivot + es, end, pdq)) {
+			/* well partitioned and nearly sorted, all done */
+			return;
+		}
+
+		/* recurse into the left, loop on the right */
+		stress_sort_pdq_loop(begin, pivot, pdq, bad_allowed, leftmost);
+		begin = pivot + es;
+		leftmost = false;
+	}
+}
+
+/*
+ *  stress_sort_pdqsort()
+ *	pattern-defeating quicksort
+ */
+void OPTIMIZE3 stress_sort_pdqsort(
+	void *base,
+	size_t n,
+	size_t es,
+	int (*cmp)(const void *, const void *))
+{
+	stress_sort_pdq_t pdq;
+	int bad_allowed = 1;
+
+	if (n < 2)
+		return;
+
+	pdq.es = es;
+	pdq.cmp = cmp;
+	pdq.swap = stress_sort_swap_func(es);
+	while ((n >> bad_allowed) > 0)
+		bad_allowed++;
+
+	stress_sort_pdq_loop((uint8_t *)base, (uint8_t *)base + (n * es), &pdq, bad_allowed, true);
+}
+
+/*
+ *  stress_sort_radix_lsd()
+ *	least significant digit first radix sort of 32 bit integers,
+ *	four 8 bit digit passes with the histograms computed in one
+ *	pass and passes where all keys share the same digit skipped.
+ *	Other element sizes are sorted with pdqsort
+ */
+void OPTIMIZE3 stress_sort_radix_lsd(
+	void *base,
+	size_t n,
+	size_t es,
+	int (*cmp)(const void *, const void *))
+{
+	size_t count[4][256];
+	uint32_t *data = (uint32_t *)base;
+	uint32_t *tmp, *src, *dst;
+	uint32_t flip;
+	size_t i, d;
+
+	if ((es != sizeof(uint32_t)) || (n < 2)) {
+		stress_sort_pdqsort(base, n, es, cmp);
+		return;
+	}
+	tmp = (uint32_t *)malloc(n * sizeof(*tmp));
+	if (!tmp) {
+		stress_sort_pdqsort(base, n, es, cmp);
+		return;
+	}
+
+	/* map signed keys to unsigned keys in the required order */
+	flip = stress_sort_int32_ascending(cmp) ? 0x80000000U : 0x7fffffffU;
+
+	(void)shim_memset(count, 0, sizeof(count));
+	for (i = 0; i < n; i++) {
+		const uint32_t key = data[i] ^ flip;
+
+		count[0][key & 0xff]++;
+		count[1][(key >> 8) & 0xff]++;
+		count[2][(key >> 16) & 0xff]++;
+		count[3][key >> 24]++;
+	}
+
+	src = data;
+	dst = tmp;
+	for (d = 0; d < 4; d++) {
+		const uint32_t shift = (uint32_t)d * 8;
+		size_t sum = 0;
+
+		/* all keys have the same digit, nothing to do */
+		if (count[d][((src[0] ^ flip) >> shift) & 0xff] == n)
+			continue;
+
+		for (i = 0; i < 256; i++) {
+			const size_t c = count[d][i];
+
+			count[d][i] = sum;
+			sum += c;
+		}
+		for (i = 0; i < n; i++) {
+			const uint32_t val = src[i];
+
+			dst[count[d][((val ^ flip) >> shift) & 0xff]++] = val;
+		}
+		src = dst;
+		dst = (dst == tmp) ? data : tmp;
+	}
+	if (src != data)
+		(void)shim_memcpy(data, src, n * sizeof(*data));
+	free(tmp);
+}
+
+/*
+ *  stress_sort_network16()
+ *	bitonic sorting network of 16 32 bit integers, branchless
+ *	min/max compare exchanges on fixed indices so the compiler
+ *	can use SIMD min/max instructions
+ */
+static inline void ALWAYS_INLINE stress_sort_network16(int32_t *v)
+{
+	size_t i, j, k;
+
+	for (k = 2; k <= NETSORT_N; k <<= 1) {
+		for (j = k >> 1; j > 0; j >>= 1) {
+			for (i = 0; i < NETSORT_N; i++) {
+				const size_t l = i ^ j;
+
+				if (l > i) {
+					const int32_t a = v[i];
+					const int32_t b = v[l];
+					const int32_t lo = (a < b) ? a : b;
+					const int32_t hi = (a < b) ? b : a;
+
+					v[i] = (i & k) ? hi : lo;
+					v[l] = (i & k) ? lo : hi;
+				}
+			}
+		}
+	}
+}
+
+/*
+ *  stress_sort_int32_med3()
+ *	median of 3 integers, adds the comparisons made to compares
+ */
+static inline int32_t ALWAYS_INLINE stress_sort_int32_med3(
+	const int32_t a,
+	const int32_t b,
+	const int32_t c,
+	uint64_t *compares)
+{
+	*compares += 2;
+	if (a < b) {
+		if (b < c)
+			return b;
+		(*compares)++;
+		return (a < c) ? c : a;
+	}
+	if (a < c)
+		return a;
+	(*compares)++;
+	return (b < c) ? c : b;
+}
+
+/*
+ *  stress_sort_netsort_int32()
+ *	quicksort of int32 keys with a pseudo median of 9 pivot
+ *	down to partitions of NETSORT_N elements that are sorted
+ *	with the sorting network, the key comparisons are counted
+ *	in stress_sort_compares
+ */
+static void TARGET_CLONES OPTIMIZE3 stress_sort_netsort_int32(int32_t *data, size_t n)
+{
+	uint64_t compares = 0;
+
+	while (n > NETSORT_N) {
+		const size_t s = n / 8, m = n / 2;
+		const int32_t m1 = stress_sort_int32_med3(data[0], data[s], data[2 * s], &compares);
+		const int32_t m2 = stress_sort_int32_med3(data[m - s], data[m], data[m + s], &compares);
+		const int32_t m3 = stress_sort_int32_med3(data[n - 1 - (2 * s)], data[n - 1 - s], data[n - 1], &compares);
+		const int32_t pivot = stress_sort_int32_med3(m1, m2, m3, &compares);
+		size_t i = 0, j = n - 1;
+
+		/* Hoare partition, the scans end on a failed comparison */
+		for (;;) {
+			int32_t tmp;
+
+			while (data[i] < pivot) {
+				i++;
+				compares++;
+			}
+			while (data[j] > pivot) {
+				j--;
+				compares++;
+			}
+			compares += 2;
+			if (i >= j)
+				break;
+			tmp = data[i];
+			data[i] = data[j];
+			data[j] = tmp;
+			i++;
+			j--;
+		}
+
+		/* recurse into the smaller partition, loop on the larger */
+		if (j + 1 < n - (j + 1)) {
+			stress_sort_netsort_int32(data, j + 1);
+			data += j + 1;
+			n -= j + 1;
+		} else {
+			stress_sort_netsort_int32(data + j + 1, n - (j + 1));
+			n = j + 1;
+		}
+	}
+
+	if (n > 1) {
+		int32_t v[NETSORT_N];
+		size_t i;
+
+		for (i = 0; i < NETSORT_N; i++)
+			v[i] = (i < n) ? data[i] : INT32_MAX;
+		stress_sort_network16(v);
+		for (i = 0; i < n; i++)
+			data[i] = v[i];
+		compares += 80;		/* the 16 input bitonic network always makes 80 comparisons */
+	}
+	stress_sort_compares += compares;
+}
+
+/*
+ *  stress_sort_netsort()
+ *	quicksort with a sorting network base case for 32 bit
+ *	integers, descending sorts are performed by sorting the
+ *	bitwise inverted keys. Other element sizes use pdqsort
+ */
+void OPTIMIZE3 stress_sort_netsort(
+	void *base,
+	size_t n,
+	size_t es,
+	int (*cmp)(const void *, const void *))
+{
+	int32_t *data = (int32_t *)base;
+	size_t i;
+
+	if (es != sizeof(int32_t)) {
+		stress_sort_pdqsort(base, n, es, cmp);
+		return;
+	}
+	if (stress_sort_int32_ascending(cmp)) {
+		stress_sort_netsort_int32(data, n);
+	} else {
+		for (i = 0; i < n; i++)
+			data[i] = ~data[i];
+		stress_sort_netsort_int32(data, n);
+		for (i = 0; i < n; i++)
+			data[i] = ~data[i];
+	}
+}
+
+/*
+ *  stress_sort_merge_runs()
+ *	merge the sorted runs [lo, mid) and [mid, hi), returns
+ *	the number of comparisons made
+ */
+static uint64_t OPTIMIZE3 stress_sort_merge_runs(const stress_sort_merge_t *m)
+{
+	const size_t es = m->es;
+	uint8_t *p1 = m->base + (m->lo * es);
+	uint8_t *p2 = m->base + (m->mid * es);
+	uint8_t *const end1 = p2;
+	uint8_t *const end2 = m->base + (m->hi * es);
+	uint8_t *dst = m->tmp + (m->lo * es);
+	uint64_t compares = 1;
+
+	/* already in order */
+	if ((p1 == end1) || (p2 == end2))
+		return 0;
+	if (m->cmp(end1 - es, p2) <= 0)
+		return compares;
+
+	while ((p1 < end1) && (p2 < end2)) {
+		compares++;
+		if (m->cmp(p1, p2) <= 0) {
+			m->copy(dst, p1, es);
+			p1 += es;
+		} else {
+			m->copy(dst, p2, es);
+			p2 += es;
+		}
+		dst += es;
+	}
+	if (p1 < end1)
+		(void)shim_memcpy(dst, p1, (size_t)(end1 - p1));
+	else
+		(void)shim_memcpy(dst, p2, (size_t)(end2 - p2));
+	(void)shim_memcpy(m->base + (m->lo * es), m->tmp + (m->lo * es), (m->hi - m->lo) * es);
+	return compares;
+}
+
+/*
+ *  stress_sort_merge_insertion()
+ *	insertion sort of small runs [lo, hi), returns the
+ *	number of comparisons made
+ */
+static uint64_t OPTIMIZE3 stress_sort_merge_insertion(const stress_sort_merge_t *m, const size_t lo, const size_t hi)
+{
+	const size_t es = m->es;
+	const stress_sort_swap_func_t swap = stress_sort_swap_func(es);
+	uint8_t *const begin = m->base + (lo * es);
+	uint8_t *const end = m->base + (hi * es);
+	uint8_t *cur;
+	uint64_t compares = 0;
+
+	for (cur = begin + es; cur < end; cur += es) {
+		register uint8_t *sift;
+
+		for (sift = cur; sift > begin; sift -= es) {
+			compares++;
+			if (m->cmp(sift - es, sift) <= 0)
+				break;
+			swap(sift - es, sift, es);
+		}
+	}
+	return compares;
+}
+
+/*
+ *  stress_sort_merge_sort()
+ *	top down merge sort of [lo, hi), insertion sort of small runs,
+ *	the comparisons made are added to m->compares
+ */
+static void OPTIMIZE3 stress_sort_merge_sort(stress_sort_merge_t *m, const size_t lo, const size_t hi)
+{
+	stress_sort_merge_t run = *m;
+
+	if (hi - lo <= MERGESORT_INSERTION_THRESHOLD) {
+		m->compares += stress_sort_merge_insertion(m, lo, hi);
+		return;
+	}
+	run.lo = lo;
+	run.mid = lo + ((hi - lo) / 2);
+	run.hi = hi;
+	stress_sort_merge_sort(m, run.lo, run.mid);
+	stress_sort_merge_sort(m, run.mid, run.hi);
+	m->compares += stress_sort_merge_runs(&run);
+}
+
+/*
+ *  stress_sort_merge_sort_run()
+ *	merge sort the [lo, hi) elements of a thread
+ */
+static void *stress_sort_merge_sort_run(void *arg)
+{
+	stress_sort_merge_t *m = (stress_sort_merge_t *)arg;
+
+	stress_sort_merge_sort(m, m->lo, m->hi);
+	return NULL;
+}
+
+/*
+ *  stress_sort_merge_runs_run()
+ *	merge the two runs of a thread
+ */
+static void *stress_sort_merge_runs_run(void *arg)
+{
+	stress_sort_merge_t *m = (stress_sort_merge_t *)arg;
+
+	m->compares += stress_sort_merge_runs(m);
+	return NULL;
+}
+
+#if defined(HAVE_LIB_PTHREAD)
+/*
+ *  stress_sort_merge_threads()
+ *	run func on m[0]..m[n - 1], m[0] on the calling thread
+ *	and the others on new threads, if a thread cannot be
+ *	created then the work is performed by the calling thread.
+ *	The new threads inherit a fully blocked signal mask so
+ *	signals are just handled by the calling thread
+ */
+static void stress_sort_merge_threads(
+	void *(*func)(void *arg),
+	stress_sort_merge_t *m,
+	const size_t n)
+{
+	pthread_t pthreads[MERGESORT_MT_THREADS_MAX];
+	bool created[MERGESORT_MT_THREADS_MAX];
+	sigset_t set, old_set;
+	size_t i;
+
+	(void)sigfillset(&set);
+	(void)pthread_sigmask(SIG_BLOCK, &set, &old_set);
+	for (i = 1; i < n; i++)
+		created[i] = (pthread_create(&pthreads[i], NULL, func, &m[i]) == 0);
+	(void)pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+	(void)func(&m[0]);
+	for (i = 1; i < n; i++) {
+		if (created[i])
+			(void)pthread_join(pthreads[i], NULL);
+		else
+			(void)func(&m[i]);
+	}
+}
+#else
+static void stress_sort_merge_threads(
+	void *(*func)(void *arg),
+	stress_sort_merge_t *m,
+	const size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++)
+		(void)func(&m[i]);
+}
+#endif
+
+/*
+ *  stress_sort_merge_cmp_int32_fwd()
+ *	ascending int32 comparison that does not touch the shared
+ *	stress_sort_compares counter, for use by the merge threads
+ */
+static int OPTIMIZE3 stress_sort_merge_cmp_int32_fwd(const void *p1, const void *p2)
+{
+	const int32_t v1 = *(const int32_t *)p1;
+	const int32_t v2 = *(const int32_t *)p2;
+
+	return (v1 > v2) - (v1 < v2);
+}
+
+/*
+ *  stress_sort_merge_cmp_int32_rev()
+ *	descending int32 comparison that does not touch the shared
+ *	stress_sort_compares counter, for use by the merge threads
+ */
+static int OPTIMIZE3 stress_sort_merge_cmp_int32_rev(const void *p1, const void *p2)
+{
+	const int32_t v1 = *(const int32_t *)p1;
+	const int32_t v2 = *(const int32_t *)p2;
+
+	return (v1 < v2) - (v1 > v2);
+}
+
+/*
+ *  stress_sort_mergesort_mt()
+ *	multithreaded merge sort, the data is split into one run
+ *	per thread that are merge sorted in parallel and then pairs
+ *	of runs are merged in parallel until one sorted run is left.
+ *	32 bit integers are compared by the threads without touching
+ *	stress_sort_compares, each thread counts its comparisons and
+ *	the counts are added to stress_sort_compares after the joins.
+ *	Other element sizes use the comparator on a single thread.
+ *	SIGALRM is blocked while the threads run so a stressor's
+ *	SIGALRM siglongjmp handler cannot jump out while the threads
+ *	use the data, other signals are still handled
+ */
+void OPTIMIZE3 stress_sort_mergesort_mt(
+	void *base,
+	size_t n,
+	size_t es,
+	int (*cmp)(const void *, const void *))
+{
+	stress_sort_merge_t m[MERGESORT_MT_THREADS_MAX];
+	size_t bounds[MERGESORT_MT_THREADS_MAX + 1];
+	size_t i, runs, width;
+	int32_t cpus = stress_cpus_online_get();
+	stress_sort_cmp_func_t merge_cmp = cmp;
+	uint64_t compares = 0;
+	uint8_t *tmp;
+#if defined(HAVE_LIB_PTHREAD)
+	sigset_t set, old_set;
+#endif
+
+	if (n < 2)
+		return;
+	tmp = (uint8_t *)malloc(n * es);
+	if (!tmp) {
+		stress_sort_pdqsort(base, n, es, cmp);
+		return;
+	}
+
+	runs = (cpus < 1) ? 1 : (size_t)cpus;
+	if (runs > MERGESORT_MT_THREADS_MAX)
+		runs = MERGESORT_MT_THREADS_MAX;
+	if (runs > n / MERGESORT_MT_MIN_PER_THREAD)
+		runs = n / MERGESORT_MT_MIN_PER_THREAD;
+	if (runs < 1)
+		runs = 1;
+	if (es == sizeof(int32_t)) {
+		merge_cmp = stress_sort_int32_ascending(cmp) ?
+			stress_sort_merge_cmp_int32_fwd : stress_sort_merge_cmp_int32_rev;
+	} else {
+		/* comparator updates the shared counter, don't race on it */
+		runs = 1;
+	}
+
+	for (i = 0; i <= runs; i++)
+		bounds[i] = (n * i) / runs;
+	for (i = 0; i < runs; i++) {
+		m[i].base = (uint8_t *)base;
+		m[i].tmp = tmp;
+		m[i].lo = bounds[i];
+		m[i].mid = bounds[i];
+		m[i].hi = bounds[i + 1];
+		m[i].es = es;
+		m[i].cmp = merge_cmp;
+		m[i].copy = stress_sort_copy_func(es);
+		m[i].compares = 0;
+	}
+
+#if defined(HAVE_LIB_PTHREAD)
+	(void)sigemptyset(&set);
+	(void)sigaddset(&set, SIGALRM);
+	(void)pthread_sigmask(SIG_BLOCK, &set, &old_set);
+#endif
+	stress_sort_merge_threads(stress_sort_merge_sort_run, m, runs);
+	for (i = 0; i < runs; i++)
+		compares += m[i].compares;
+
+	for (width = 1; width < runs; width <<= 1) {
+		size_t merges = 0;
+
+		for (i = 0; i + width < runs; i += 2 * width) {
+			const size_t hi = (i + (2 * width) < runs) ? i + (2 * width) : runs;
+
+			m[merges] = m[0];
+			m[merges].lo = bounds[i];
+			m[merges].mid = bounds[i + width];
+			m[merges].hi = bounds[hi];
+			m[merges].compares = 0;
+			merges++;
+		}
+		stress_sort_merge_threads(stress_sort_merge_runs_run, m, merges);
+		for (i = 0; i < merges; i++)
+			compares += m[i].compares;
+	}
+#if defined(HAVE_LIB_PTHREAD)
+	(void)pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+#endif
+	if (merge_cmp != cmp)
+		stress_sort_compares += compares;
+	free(tmp);
+}
+
+/*
+ *  Sort engines that can be selected by the sort stressors
+ */
+static const stress_sort_engine_t stress_sort_engines[] = {
+	{ "mergesort-mt",	stress_sort_mergesort_mt,	true },
+	{ "netsort",		stress_sort_netsort,		true },
+	{ "pdqsort",		stress_sort_pdqsort,		true },
+	{ "radix-lsd",		stress_sort_radix_lsd,		false },
+};
+
+/*
+ *  stress_sort_engine_name()
+ *	return name of the i'th sort engine, NULL if out of range
+ */
+const char *stress_sort_engine_name(const size_t i)
+{
+	return (i < SIZEOF_ARRAY(stress_sort_engines)) ? stress_sort_engines[i].name : NULL;
+}
+
+/*
+ *  stress_sort_engine_get()
+ *	return the i'th sort engine, NULL if out of range
+ */
+const stress_sort_engine_t *stress_sort_engine_get(const size_t i)
+{
+	return (i < SIZEOF_ARRAY(stress_sort_engines)) ? &stress_sort_engines[i] : NULL;
+}
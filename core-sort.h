@@ -25,7 +25,21 @@
 
 typedef void (*stress_sort_swap_func_t)(void *p1, void *p2, register size_t size);
 typedef void (*stress_sort_copy_func_t)(void *p1, void *p2, register size_t size);
+typedef void (*stress_sort_func_t)(void *base, size_t n, size_t es,
+	int (*cmp)(const void *, const void *));
 
+/* qsort compatible sort engine */
+typedef struct {
+	const char *name;			/* engine name */
+	const stress_sort_func_t sort;		/* sort function */
+	const bool compares;			/* true if comparisons are counted */
+} stress_sort_engine_t;
+
+#define STRESS_SORT_DATA_SORTED	(0x01)	/* data must be in ascending order */
+#define STRESS_SORT_DATA_UNIQUE	(0x02)	/* data values must be unique */
+
+extern const char *stress_sort_data_method(const size_t i);
+extern void stress_sort_data_int32(int32_t *data, const size_t n, const int flags);
 extern void stress_sort_data_int32_init(int32_t *data, const size_t n);
 extern void stress_sort_data_int32_shuffle(int32_t *data, const size_t n);
 extern void stress_sort_data_int32_mangle(int32_t *data, const size_t n);
@@ -38,6 +52,16 @@ extern stress_sort_copy_func_t stress_sort_copy_func(const size_t size);
 
 extern void qsort_bm(void *base, size_t n, size_t es,
 	int (*cmp)(const void *, const void*));
+extern void stress_sort_pdqsort(void *base, size_t n, size_t es,
+	int (*cmp)(const void *, const void *));
+extern void stress_sort_radix_lsd(void *base, size_t n, size_t es,
+	int (*cmp)(const void *, const void *));
+extern void stress_sort_netsort(void *base, size_t n, size_t es,
+	int (*cmp)(const void *, const void *));
+extern void stress_sort_mergesort_mt(void *base, size_t n, size_t es,
+	int (*cmp)(const void *, const void *));
+extern const char *stress_sort_engine_name(const size_t i);
+extern const stress_sort_engine_t *stress_sort_engine_get(const size_t i);
 
 #if defined(HAVE_QSORT)
 static inline void shim_qsort(void *base, size_t n, size_t es,
@@ -1355,14 +1355,20 @@ void stress_vmstat_start(void)
 #endif
 		if ((status_delay > 0) && (status_sleep == status_delay)) {
 			const double runtime = round(stress_time_now() - g_shared->time_started);
+			char rate[48];
 
-			pr_inf("status: %" PRIu32 " run, %" PRIu32 " exit, %" PRIu32 " reap, %" PRIu32 " fail, %" PRIu32 " SIGALRM, %s\n",
+			*rate = '\0';
+			if (g_shared->sampler.enabled)
+				(void)snprintf(rate, sizeof(rate), ", %.2f bogo-ops/s", g_shared->sampler.rate);
+
+			pr_inf("status: %" PRIu32 " run, %" PRIu32 " exit, %" PRIu32 " reap, %" PRIu32 " fail, %" PRIu32 " SIGALRM, %s%s\n",
 				g_shared->instance_count.started,
 				g_shared->instance_count.exited,
 				g_shared->instance_count.reaped,
 				g_shared->instance_count.failed,
 				g_shared->instance_count.alarmed,
-				stress_time_duration_to_str(runtime, false, true));
+				stress_time_duration_to_str(runtime, false, true),
+				rate);
 		}
 #if defined(STRESS_RAPL)
 		if ((sleep_delay > 0) &&
@@ -0,0 +1 @@
+#define STRESS_GIT_COMMIT_ID "02ab96dc3048ae3b0bd8055cbf4e8d726976511b"
@@ -183,7 +183,7 @@ static int OPTIMIZE3 stress_bitonicsort(stress_args_t *args)
 	do {
 		double t;
 
-		stress_sort_data_int32_shuffle(data, n);
+		stress_sort_data_int32(data, n, 0);
 
 		/* Sort "random" data */
 		bitonic_count = 0;
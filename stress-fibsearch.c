@@ -131,7 +131,7 @@ static int OPTIMIZE3 stress_fibsearch(stress_args_t *args)
 	do {
 		double t;
 
-		stress_sort_data_int32_init(data, n);
+		stress_sort_data_int32(data, n, STRESS_SORT_DATA_SORTED);
 		stress_sort_compare_reset();
 		t = stress_time_now();
 		for (ptr = data, i = 0; i < n; i++, ptr++) {
@@ -20,6 +20,7 @@
 #include "core-attribute.h"
 #include "core-builtin.h"
 #include "core-hash.h"
+#include "core-mmap.h"
 
 #include <math.h>
 
@@ -29,11 +30,18 @@
 
 #define STRESS_HASH_N_BUCKETS	(256)
 #define STRESS_HASH_N_KEYS	(128)
+#define STRESS_HASH_MURMUR3_SEED	(0xf12b35e1)	/* arbitrary value */
+
+#define MIN_HASH_BULK		(16)
+#define MAX_HASH_BULK		(STRESS_HASH_BULK_SIZE)
+#define STRESS_HASH_BULK_SIZE	(1 * MB)	/* bulk mode buffer size */
+#define STRESS_HASH_BULK_VERIFY	(16)		/* records verified per bulk hash */
 
 typedef struct {
 	double		duration;
 	double		chi_squared;
 	uint64_t	total;
+	uint64_t	bytes;
 } stress_hash_stats_t;
 
 typedef struct {
@@ -44,17 +52,30 @@ typedef struct {
 struct stress_hash_method_info;
 typedef struct stress_hash_method_info stress_hash_method_info_t;
 
+/* Bulk mode buffer of n records of record bytes, each a NUL terminated key */
+typedef struct {
+	char		*buffer;
+	size_t		size;
+	size_t		record;
+	size_t		n;
+	uint32_t	*hashes;
+} stress_hash_bulk_t;
+
 typedef uint32_t (*stress_hash_func)(const char *str, const size_t len);
 typedef int (*stress_method_func)(const char *name, const stress_hash_method_info_t * hmi,
 				  stress_hash_stats_t *stats, stress_bucket_t *bucket);
+typedef void (*stress_bulk_func)(const stress_hash_func hash, const stress_hash_bulk_t *bulk);
 
 struct stress_hash_method_info {
 	const char		*name;	/* human readable form of stressor */
 	const stress_method_func	func;	/* the hash method function */
+	const stress_hash_func	hash;	/* the hash function */
+	const stress_bulk_func	bulk;	/* optional bulk hash function */
 };
 
 static const stress_help_t help[] = {
 	{ NULL,  "hash N",		"start N workers that exercise various hash functions" },
+	{ NULL,  "hash-bulk N",		"hash a 1 MB buffer of N byte records, report GB/sec per method" },
 	{ NULL,  "hash-method M",	"specify stress hash method M, default is all" },
 	{ NULL,  "hash-ops N",		"stop after N hash bogo operations" },
 	{ NULL,	 NULL,			NULL }
@@ -162,9 +183,28 @@ static int OPTIMIZE3 stress_hash_method_jenkin(
 
 static uint32_t stress_hash_murmur3_32_wrapper(const char *str, const size_t len)
 {
-	const uint32_t seed = 0xf12b35e1; /* arbitrary value */
+	return (uint32_t)stress_hash_murmur3_32((const uint8_t *)str, len, STRESS_HASH_MURMUR3_SEED);
+}
+
+/*
+ *  stress_hash_bulk_murmur3_32()
+ *	bulk murmur3_32, hash STRESS_HASH_MURMUR3_LANES records at a time
+ */
+static void OPTIMIZE3 stress_hash_bulk_murmur3_32(
+	const stress_hash_func hash,
+	const stress_hash_bulk_t *bulk)
+{
+	const size_t record = bulk->record;
+	const char *ptr = bulk->buffer;
+	size_t i;
 
-	return (uint32_t)stress_hash_murmur3_32((const uint8_t *)str, len, seed);
+	for (i = 0; i + STRESS_HASH_MURMUR3_LANES <= bulk->n; i += STRESS_HASH_MURMUR3_LANES) {
+		stress_hash_murmur3_32_x8((const uint8_t *)ptr, record, record - 1,
+			STRESS_HASH_MURMUR3_SEED, bulk->hashes + i);
+		ptr += record * STRESS_HASH_MURMUR3_LANES;
+	}
+	for (; i < bulk->n; i++, ptr += record)
+		bulk->hashes[i] = hash(ptr, record - 1);
 }
 
 /*
@@ -292,6 +332,24 @@ static uint32_t CONST stress_hash_crc32c_wrapper(const char *str, const size_t l
 	return stress_hash_crc32c(str);
 }
 
+/*
+ *  stress_hash_bulk_crc32c()
+ *	bulk crc32c using the cpu crc32 instructions if available
+ */
+static void OPTIMIZE3 stress_hash_bulk_crc32c(
+	const stress_hash_func hash,
+	const stress_hash_bulk_t *bulk)
+{
+	const size_t record = bulk->record;
+	const char *ptr = bulk->buffer;
+	size_t i;
+
+	(void)hash;
+
+	for (i = 0; i < bulk->n; i++, ptr += record)
+		bulk->hashes[i] = stress_hash_crc32c_len((const uint8_t *)ptr, record - 1);
+}
+
 /*
  *  stress_hash_method_crc32c()
  *	stress test hash crc32c
@@ -414,6 +472,13 @@ static uint32_t CONST stress_hash_coffin32_wrapper_be(const char *str, const siz
 	return stress_hash_coffin32_be(str, len);	/* Big Endian */
 }
 
+static uint32_t CONST stress_hash_coffin32_wrapper(const char *str, const size_t len)
+{
+	return stress_little_endian() ?
+		stress_hash_coffin32_le(str, len) :
+		stress_hash_coffin32_be(str, len);
+}
+
 /*
  *  stress_hash_method_coffin32()
  *	stress test hash coffin
@@ -612,35 +677,35 @@ static OPTIMIZE3 int stress_hash_all(
  * Table of has stress methods
  */
 static const stress_hash_method_info_t hash_methods[] ALIGN64 = {
-	{ "all",		stress_hash_all			},	/* Special "all" test */
-	{ "adler32",		stress_hash_method_adler32	},
-	{ "coffin",		stress_hash_method_coffin	},
-	{ "coffin32",		stress_hash_method_coffin32	},
-	{ "crc32c",		stress_hash_method_crc32c	},
-	{ "djb2a",		stress_hash_method_djb2a	},
-	{ "fnv1a",		stress_hash_method_fnv1a	},
-	{ "jenkin",		stress_hash_method_jenkin	},
-	{ "kandr",		stress_hash_method_kandr	},
-	{ "knuth",		stress_hash_method_knuth	},
-	{ "loselose",		stress_hash_method_loselose	},
-	{ "mid5",		stress_hash_method_mid5		},
-	{ "muladd32",		stress_hash_method_muladd32	},
-	{ "muladd64",		stress_hash_method_muladd64	},
-	{ "mulxror32",		stress_hash_method_mulxror32	},
-	{ "mulxror64",		stress_hash_method_mulxror64	},
-	{ "murmur3_32",		stress_hash_method_murmur3_32	},
-	{ "nhash",		stress_hash_method_nhash	},
-	{ "pjw",		stress_hash_method_pjw		},
-	{ "sdbm",		stress_hash_method_sdbm		},
-	{ "sedgwick",		stress_hash_method_sedgwick	},
-	{ "sobel",		stress_hash_method_sobel	},
-	{ "x17",		stress_hash_method_x17		},
-	{ "xor",		stress_hash_method_xor		},
-	{ "xorror32",		stress_hash_method_xorror32	},
-	{ "xorror64",		stress_hash_method_xorror64	},
+	{ "all",	stress_hash_all,		NULL,				NULL },	/* Special "all" test */
+	{ "adler32",	stress_hash_method_adler32,	stress_hash_adler32,		NULL },
+	{ "coffin",	stress_hash_method_coffin,	stress_hash_coffin_wrapper,	NULL },
+	{ "coffin32",	stress_hash_method_coffin32,	stress_hash_coffin32_wrapper,	NULL },
+	{ "crc32c",	stress_hash_method_crc32c,	stress_hash_crc32c_wrapper,	stress_hash_bulk_crc32c },
+	{ "djb2a",	stress_hash_method_djb2a,	stress_hash_djb2a_wrapper,	NULL },
+	{ "fnv1a",	stress_hash_method_fnv1a,	stress_hash_fnv1a_wrapper,	NULL },
+	{ "jenkin",	stress_hash_method_jenkin,	stress_hash_jenkin_wrapper,	NULL },
+	{ "kandr",	stress_hash_method_kandr,	stress_hash_kandr_wrapper,	NULL },
+	{ "knuth",	stress_hash_method_knuth,	stress_hash_knuth,		NULL },
+	{ "loselose",	stress_hash_method_loselose,	stress_hash_loselose_wrapper,	NULL },
+	{ "mid5",	stress_hash_method_mid5,	stress_hash_mid5,		NULL },
+	{ "muladd32",	stress_hash_method_muladd32,	stress_hash_muladd32,		NULL },
+	{ "muladd64",	stress_hash_method_muladd64,	stress_hash_muladd64,		NULL },
+	{ "mulxror32",	stress_hash_method_mulxror32,	stress_hash_mulxror32,		NULL },
+	{ "mulxror64",	stress_hash_method_mulxror64,	stress_hash_mulxror64,		NULL },
+	{ "murmur3_32",	stress_hash_method_murmur3_32,	stress_hash_murmur3_32_wrapper,	stress_hash_bulk_murmur3_32 },
+	{ "nhash",	stress_hash_method_nhash,	stress_hash_nhash_wrapper,	NULL },
+	{ "pjw",	stress_hash_method_pjw,		stress_hash_pjw_wrapper,	NULL },
+	{ "sdbm",	stress_hash_method_sdbm,	stress_hash_sdbm_wrapper,	NULL },
+	{ "sedgwick",	stress_hash_method_sedgwick,	stress_hash_sedgwick_wrapper,	NULL },
+	{ "sobel",	stress_hash_method_sobel,	stress_hash_sobel_wrapper,	NULL },
+	{ "x17",	stress_hash_method_x17,		stress_hash_x17_wrapper,	NULL },
+	{ "xor",	stress_hash_method_xor,		stress_hash_xor,		NULL },
+	{ "xorror32",	stress_hash_method_xorror32,	stress_hash_xorror32,		NULL },
+	{ "xorror64",	stress_hash_method_xorror64,	stress_hash_xorror64,		NULL },
 #if defined(HAVE_XXHASH_H) &&	\
     defined(HAVE_LIB_XXHASH)
-	{ "xxh64",		stress_hash_method_xxh64,	},
+	{ "xxh64",	stress_hash_method_xxh64,	stress_hash_xxh64_wrapper,	NULL },
 #endif
 };
 
@@ -673,6 +738,115 @@ static OPTIMIZE3 int stress_hash_all(
 	return rc;
 }
 
+/*
+ *  stress_hash_bulk_generic()
+ *	bulk hash each record using the hash function
+ */
+static void OPTIMIZE3 stress_hash_bulk_generic(
+	const stress_hash_func hash,
+	const stress_hash_bulk_t *bulk)
+{
+	const size_t record = bulk->record;
+	const char *ptr = bulk->buffer;
+	size_t i;
+
+	for (i = 0; i < bulk->n; i++, ptr += record)
+		bulk->hashes[i] = hash(ptr, record - 1);
+}
+
+/*
+ *  stress_hash_bulk()
+ *	hash all the records in the bulk buffer, account the
+ *	bytes hashed for the throughput and compute the chi
+ *	squared of the record hashes
+ */
+static int OPTIMIZE3 stress_hash_bulk(
+	const char *name,
+	const stress_hash_method_info_t *hmi,
+	stress_hash_stats_t *stats,
+	stress_bucket_t *bucket,
+	const stress_hash_bulk_t *bulk)
+{
+	const stress_bulk_func bulk_func = hmi->bulk ? hmi->bulk : stress_hash_bulk_generic;
+	double sum = 0.0, n, m, divisor, t;
+	size_t i;
+
+	t = stress_time_now();
+	bulk_func(hmi->hash, bulk);
+	stats->duration += stress_time_now() - t;
+	stats->total += bulk->n;
+	stats->bytes += bulk->n * (bulk->record - 1);
+
+	(void)shim_memset(bucket->buckets, 0, sizeof(bucket->buckets));
+	for (i = 0; i < bulk->n; i++)
+		bucket->buckets[bulk->hashes[i] % STRESS_HASH_N_BUCKETS]++;
+	for (i = 0; i < STRESS_HASH_N_BUCKETS; i++) {
+		const double bi = (double)bucket->buckets[i];
+
+		sum += (bi * (bi + 1.0)) / 2.0;
+	}
+	n = (double)bulk->n;
+	m = (double)STRESS_HASH_N_BUCKETS;
+	divisor = (n / (2.0 * m)) * (n + (2.0 * m) - 1.0);
+	stats->chi_squared = sum / divisor;
+
+	/* check the bulk hashes match the single key hash function */
+	if (g_opt_flags & OPT_FLAGS_VERIFY) {
+		const char *ptr = bulk->buffer;
+
+		for (i = 0; (i < bulk->n) && (i < STRESS_HASH_BULK_VERIFY); i++, ptr += bulk->record) {
+			const uint32_t hash = hmi->hash(ptr, bulk->record - 1);
+
+			if (UNLIKELY(bulk->hashes[i] != hash)) {
+				pr_fail("%s: error detected, bulk hash %s of record %zu, "
+					"expected %" PRIx32 ", got %" PRIx32 "\n",
+					name, hmi->name, i, hash, bulk->hashes[i]);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+	return EXIT_SUCCESS;
+}
+
+/*
+ *  stress_hash_bulk_init()
+ *	allocate and fill the bulk buffer with records of
+ *	record - 1 random ASCII ' '..'_' characters and a
+ *	terminating NUL
+ */
+static int stress_hash_bulk_init(
+	stress_args_t *args,
+	stress_hash_bulk_t *bulk,
+	const size_t record)
+{
+	size_t i, sz;
+
+	bulk->record = record;
+	bulk->n = STRESS_HASH_BULK_SIZE / record;
+	bulk->size = bulk->n * record;
+	sz = bulk->size + (bulk->n * sizeof(*bulk->hashes));
+
+	bulk->buffer = (char *)stress_mmap_populate(NULL, sz,
+				PROT_READ | PROT_WRITE,
+				MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+	if (bulk->buffer == MAP_FAILED) {
+		pr_inf_skip("%s: mmap of %zu bytes failed%s, errno=%d (%s), skipping stressor\n",
+			args->name, sz, stress_memory_free_get(),
+			errno, strerror(errno));
+		return EXIT_NO_RESOURCE;
+	}
+	stress_memory_anon_name_set(bulk->buffer, sz, "hash-bulk");
+	bulk->hashes = (uint32_t *)(bulk->buffer + bulk->size);
+
+	stress_mwc_fill(bulk->buffer, bulk->size);
+	for (i = 0; i < bulk->size; i++)
+		bulk->buffer[i] = (bulk->buffer[i] & 0x3f) + ' ';
+	for (i = record - 1; i < bulk->size; i += record)
+		bulk->buffer[i] = '\0';
+
+	return EXIT_SUCCESS;
+}
+
 /*
  *  stress_hash()
  *	stress CPU by doing floating point math ops
@@ -683,37 +857,83 @@ static int OPTIMIZE3 stress_hash(stress_args_t *args)
 	const stress_hash_method_info_t *hm;
 	stress_hash_stats_t *hs;
 	size_t hash_method = 0;
+	size_t hash_bulk = 0;
+	size_t all_index = 1;
 	stress_bucket_t bucket;
+	stress_hash_bulk_t bulk;
 	int rc = EXIT_SUCCESS;
 
 	(void)stress_setting_get("hash-method", &hash_method);
+	(void)stress_setting_get("hash-bulk", &hash_bulk);
 	hm = &hash_methods[hash_method];
 	hs = &hash_stats[hash_method];
 
 	for (i = 0; i < NUM_HASH_METHODS; i++) {
 		hash_stats[i].duration = 0.0;
 		hash_stats[i].total = 0;
+		hash_stats[i].bytes = 0;
 		hash_stats[i].chi_squared = 0.0;
 	}
 
-	if (stress_instance_zero(args))
+	if (hash_bulk) {
+		rc = stress_hash_bulk_init(args, &bulk, hash_bulk);
+		if (rc != EXIT_SUCCESS)
+			return rc;
+	}
+
+	if (stress_instance_zero(args)) {
 		pr_dbg("%s: using method '%s'\n", args->name, hm->name);
+		if (hash_bulk)
+			pr_dbg("%s: bulk mode, %zu records of %zu bytes, crc32c using %s\n",
+				args->name, bulk.n, bulk.record, stress_hash_crc32c_impl());
+	}
 
 	stress_proc_state_set(args->name, STRESS_STATE_SYNC_WAIT);
 	stress_sync_start_wait(args);
 	stress_proc_state_set(args->name, STRESS_STATE_RUN);
 
 	do {
-		if (hm->func(args->name, hm, hs, &bucket) == EXIT_FAILURE) {
+		if (hash_bulk) {
+			/* cycle through the methods for "all" */
+			if (hash_method == 0) {
+				hm = &hash_methods[all_index];
+				hs = &hash_stats[all_index];
+				all_index++;
+				if (UNLIKELY(all_index >= NUM_HASH_METHODS))
+					all_index = 1;
+			}
+			if (stress_hash_bulk(args->name, hm, hs, &bucket, &bulk) == EXIT_FAILURE) {
+				rc = EXIT_FAILURE;
+				break;
+			}
+		} else if (hm->func(args->name, hm, hs, &bucket) == EXIT_FAILURE) {
 			rc = EXIT_FAILURE;
 			break;
 		}
 		stress_bogo_inc(args);
 	} while (stress_continue(args));
 
+	if (hash_bulk) {
+		for (i = 1; i < NUM_HASH_METHODS; i++) {
+			const stress_hash_stats_t *stats = &hash_stats[i];
+
+			if ((stats->duration > 0.0) && (stats->bytes > 0)) {
+				char desc[64];
+
+				(void)snprintf(desc, sizeof(desc), "%s GB per second", hash_methods[i].name);
+				stress_metrics_set(args, desc,
+					(double)stats->bytes / (stats->duration * (double)GB),
+					STRESS_METRIC_HARMONIC_MEAN);
+			}
+		}
+	}
+
 	if (stress_instance_zero(args)) {
 		pr_block_begin();
-		pr_inf("%s: %12.12s %15s %10s\n", args->name, "hash", "hashes/sec", "chi squared");
+		if (hash_bulk)
+			pr_inf("%s: %12.12s %10s %15s %10s\n", args->name, "hash", "GB/sec", "hashes/sec", "chi squared");
+		else
+			pr_inf("%s: %12.12s %15s %10s\n", args->name, "hash", "hashes/sec", "chi squared");
 		for (i = 1; i < NUM_HASH_METHODS; i++) {
 			const stress_hash_stats_t *stats = &hash_stats[i];
 
@@ -721,13 +941,23 @@ static int OPTIMIZE3 stress_hash(stress_args_t *args)
 				const double rate = ((stats->duration > 0.0) ?
 					(double)stats->total / stats->duration : 0.0);
 
-				pr_inf("%s: %12.12s %15.2f %10.2f\n",
-					args->name, hash_methods[i].name, rate, stats->chi_squared);
+				if (hash_bulk) {
+					const double gb_rate = (double)stats->bytes / (stats->duration * (double)GB);
+
+					pr_inf("%s: %12.12s %10.3f %15.2f %10.2f\n",
+						args->name, hash_methods[i].name, gb_rate, rate, stats->chi_squared);
+				} else {
+					pr_inf("%s: %12.12s %15.2f %10.2f\n",
+						args->name, hash_methods[i].name, rate, stats->chi_squared);
+				}
 			}
 		}
 		pr_block_end();
 	}
 
+	if (hash_bulk)
+		(void)munmap((void *)bulk.buffer, bulk.size + (bulk.n * sizeof(*bulk.hashes)));
+
 	stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
 
 	return rc;
@@ -739,6 +969,7 @@ static const char *stress_hash_method(const size_t i)
 }
 
 static const stress_opt_t opts[] = {
+	{ OPT_hash_bulk,   "hash-bulk",   TYPE_ID_SIZE_T_BYTES_VM, MIN_HASH_BULK, MAX_HASH_BULK, NULL },
 	{ OPT_hash_method, "hash-method", TYPE_ID_SIZE_T_METHOD, 0, 0, stress_hash_method },
 	END_OPT,
 };
@@ -765,5 +996,6 @@ const stressor_info_t stress_hash_info = {
 	.opts = opts,
 	.verify = VERIFY_OPTIONAL,
 	.help = help,
+	.max_metrics_items = NUM_HASH_METHODS,
 	.exercises = exercises,
 };
@@ -34,7 +34,7 @@ static sigjmp_buf jmp_env;
 
 static const stress_help_t help[] = {
 	{ NULL,	"heapsort N",	   	"start N workers heap sorting 32 bit random integers" },
-	{ NULL, "heapsort-method M",	"select sort method [ heapsort-libc | heapsort-nonlibc ]" },
+	{ NULL, "heapsort-method M",	"select sort method [ heapsort-libc | heapsort-nonlibc | mergesort-mt | netsort | pdqsort | radix-lsd ]" },
 	{ NULL,	"heapsort-ops N",	"stop after N heap sort bogo operations" },
 	{ NULL,	"heapsort-size N",	"number of 32 bit integers to sort" },
 	{ NULL,	NULL,		   NULL }
@@ -132,6 +132,22 @@ static int heapsort_nonlibc(
 	return 0;
 }
 
+static stress_sort_func_t heapsort_engine;
+
+/*
+ *  heapsort_engine_sort()
+ *	sort using the selected core sort engine
+ */
+static int heapsort_engine_sort(
+	void *base,
+	size_t nmemb,
+	size_t size,
+	int (*compar)(const void *, const void *))
+{
+	heapsort_engine(base, nmemb, size, compar);
+	return 0;
+}
+
 static const stress_heapsort_method_t stress_heapsort_methods[] = {
 #if (defined(HAVE_LIB_BSD) &&		\
      defined(HAVE_BSD_STDLIB_H)) ||	\
@@ -143,7 +159,9 @@ static const stress_heapsort_method_t stress_heapsort_methods[] = {
 
 static const char *stress_heapsort_method(const size_t i)
 {
-	return (i < SIZEOF_ARRAY(stress_heapsort_methods)) ? stress_heapsort_methods[i].name : NULL;
+	if (i < SIZEOF_ARRAY(stress_heapsort_methods))
+		return stress_heapsort_methods[i].name;
+	return stress_sort_engine_name(i - SIZEOF_ARRAY(stress_heapsort_methods));
 }
 
 static const stress_opt_t opts[] = {
@@ -181,6 +199,7 @@ static int stress_heapsort(stress_args_t *args)
 	CLOBBERED double duration = 0.0;
 	CLOBBERED double count = 0.0;
 	CLOBBERED double sorted = 0.0;
+	CLOBBERED bool sort_compares = true;
 	heapsort_func_t heapsort_func;
 #if defined(HAVE_SIGLONGJMP)
 	struct sigaction old_action;
@@ -189,10 +208,18 @@ static int stress_heapsort(stress_args_t *args)
 
 	(void)stress_setting_get("heapsort-method", &heapsort_method);
 
-	heapsort_func = stress_heapsort_methods[heapsort_method].heapsort_func;
+	if (heapsort_method < SIZEOF_ARRAY(stress_heapsort_methods)) {
+		heapsort_func = stress_heapsort_methods[heapsort_method].heapsort_func;
+	} else {
+		const stress_sort_engine_t *engine = stress_sort_engine_get(heapsort_method - SIZEOF_ARRAY(stress_heapsort_methods));
+
+		heapsort_engine = engine->sort;
+		heapsort_func = heapsort_engine_sort;
+		sort_compares = engine->compares;
+	}
 	if (stress_instance_zero(args))
 		pr_inf("%s: using method '%s'\n",
-			args->name, stress_heapsort_methods[heapsort_method].name);
+			args->name, stress_heapsort_method(heapsort_method));
 
 	if (!stress_setting_get("heapsort-size", &heapsort_size)) {
 		if (g_opt_flags & OPT_FLAGS_MAXIMIZE)
@@ -239,7 +266,7 @@ static int stress_heapsort(stress_args_t *args)
 	do {
 		double t;
 
-		stress_sort_data_int32_shuffle(data, n);
+		stress_sort_data_int32(data, n, 0);
 
 		/* Sort "random" data */
 		stress_sort_compare_reset();
@@ -331,15 +358,21 @@ static int stress_heapsort(stress_args_t *args)
 tidy:
 #endif
 	stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
-	rate = (duration > 0.0) ? count / duration : 0.0;
-	stress_metrics_set(args, "heapsort comparisons per sec",
-		rate, STRESS_METRIC_HARMONIC_MEAN);
-	rate = (sorted > 0.0) ? count / sorted : 0.0;
-	stress_metrics_set(args, "heapsort comparisons per item",
+	/* radix sorts make no comparisons, just report the sort rate */
+	if (sort_compares) {
+		rate = (duration > 0.0) ? count / duration : 0.0;
+		stress_metrics_set(args, "heapsort comparisons per sec",
+			rate, STRESS_METRIC_HARMONIC_MEAN);
+		rate = (sorted > 0.0) ? count / sorted : 0.0;
+		stress_metrics_set(args, "heapsort comparisons per item",
+			rate, STRESS_METRIC_HARMONIC_MEAN);
+
+		pr_dbg("%s: %.2f heapsort comparisons per sec\n", args->name, rate);
+	}
+	rate = (duration > 0.0) ? sorted / duration : 0.0;
+	stress_metrics_set(args, "heapsort elements sorted per sec",
 		rate, STRESS_METRIC_HARMONIC_MEAN);
 
-	pr_dbg("%s: %.2f heapsort comparisons per sec\n", args->name, rate);
-
 	(void)munmap((void *)data, data_size);
 
 	return rc;
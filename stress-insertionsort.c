@@ -160,7 +160,7 @@ static int stress_insertionsort(stress_args_t *args)
 	do {
 		double t;
 
-		stress_sort_data_int32_shuffle(data, n);
+		stress_sort_data_int32(data, n, 0);
 
 		/* Sort "random" data */
 		stress_sort_compare_reset();
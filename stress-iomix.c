@@ -158,7 +158,7 @@ static void stress_iomix_wr_seq_bursts(
 			ssize_t rc;
 			const size_t len = 1 + (stress_mwc32() & (sizeof(buffer) - 1));
 
-			stress_rndbuf(buffer, len);
+			stress_mwc_fill(buffer, len);
 
 			rc = write(fd, buffer, len);
 			if (UNLIKELY(rc < 0)) {
@@ -217,7 +217,7 @@ static void stress_iomix_wr_rnd_bursts(
 				return;
 			}
 
-			stress_rndbuf(buffer, len);
+			stress_mwc_fill(buffer, len);
 			rc = write(fd, buffer, len);
 			if (UNLIKELY(rc < 0)) {
 				if (errno == EINTR)
@@ -270,7 +270,7 @@ static void stress_iomix_wr_seq_slow(
 			ssize_t rc;
 			const size_t len = 1 + (stress_mwc32() & (sizeof(buffer) - 1));
 
-			stress_rndbuf(buffer, len);
+			stress_mwc_fill(buffer, len);
 
 			rc = write(fd, buffer, len);
 			if (UNLIKELY(rc < 0)) {
@@ -560,7 +560,7 @@ static void stress_iomix_rd_wr_mmap(
 				/* Force page data to be read */
 				stress_put_uint8(buffer[0]);
 
-				stress_rndbuf(mmaps[i], page_size);
+				stress_mwc_fill(mmaps[i], page_size);
 #if defined(MS_ASYNC) &&	\
     defined(MS_SYNC)
 				(void)shim_msync(mmaps[i], page_size,
@@ -214,7 +214,7 @@ static int stress_lsearch(stress_args_t *args)
 		size_t n = 0;
 		size_t min;
 
-		stress_sort_data_int32_shuffle(data, max);
+		stress_sort_data_int32(data, max, STRESS_SORT_DATA_UNIQUE);
 
 		/* Step #1, populate with data */
 		for (i = 0; LIKELY(stress_continue_flag() && (i < max)); i++) {
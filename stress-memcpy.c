@@ -19,18 +19,34 @@
  */
 #include "stress-ng.h"
 #include "core-builtin.h"
+#include "core-cpu.h"
+#include "core-cpu-cache.h"
 #include "core-mmap.h"
+#include "core-nt-store.h"
 #include "core-target-clones.h"
+#include "core-vecmath.h"
 
 #define ALIGN_SIZE	(64)
 #define MEMCPY_MEMSIZE	(2048)
 #define MEMCPY_LOOPS	(1024)
 
+#define MIN_MEMCPY_SWEEP_MAX		(8)
+#define MAX_MEMCPY_SWEEP_MAX		(1 * GB)
+#define DEFAULT_MEMCPY_SWEEP_MAX	(64 * MB)
+
+#define MEMCPY_SWEEP_MIN	(8)		/* smallest copy size */
+#define MEMCPY_SWEEP_SIZES	(32)		/* max copy sizes */
+#define MEMCPY_SWEEP_PAD	(64)		/* room for misaligned copies */
+#define MEMCPY_SWEEP_SLICE	(0.002)		/* seconds per measurement */
+#define MEMCPY_SWEEP_BATCH	(64 * KB)	/* bytes copied between time checks */
+#define MEMCPY_NT_MIN		(256)		/* smallest non-temporal copy */
 
 static const stress_help_t help[] = {
 	{ NULL,	"memcpy N",	   "start N workers performing memory copies" },
 	{ NULL,	"memcpy-method M", "set memcpy method (M = all, libc, builtin, naive..)" },
 	{ NULL,	"memcpy-ops N",	   "stop after N memcpy bogo operations" },
+	{ NULL,	"memcpy-sweep",	   "measure copy rates over copy sizes and misalignments" },
+	{ NULL,	"memcpy-sweep-max N", "largest copy size for --memcpy-sweep" },
 	{ NULL,	NULL,		   NULL }
 };
 
@@ -39,14 +55,16 @@ static const char *s_method_name = "";
 
 typedef void (*stress_memcpy_func)(uint8_t *str1, uint8_t *str2, uint8_t *str3);
 
+typedef void * (*memcpy_func_t)(void *dest, const void *src, size_t n);
+typedef void * (*memmove_func_t)(void *dest, const void *src, size_t n);
+
 typedef struct {
 	const char *name;
 	const stress_memcpy_func func;
+	const memcpy_func_t copy;	/* copy engine for --memcpy-sweep, NULL for all */
+	bool (*supported)(void);	/* NULL if always supported */
 } stress_memcpy_method_info_t;
 
-typedef void * (*memcpy_func_t)(void *dest, const void *src, size_t n);
-typedef void * (*memmove_func_t)(void *dest, const void *src, size_t n);
-
 typedef void * (*memcpy_check_func_t)(memcpy_func_t func, void *dest, const void *src, size_t n);
 typedef void * (*memmove_check_func_t)(memmove_func_t func, void *dest, const void *src, size_t n);
 
@@ -138,6 +156,203 @@ TEST_NAIVE_MEMMOVE(test_naive_memmove_o1, NOINLINE OPTIMIZE1)
 TEST_NAIVE_MEMMOVE(test_naive_memmove_o2, NOINLINE OPTIMIZE2)
 TEST_NAIVE_MEMMOVE(test_naive_memmove_o3, NOINLINE OPTIMIZE3)
 
+/*
+ *  stress_memcpy_small()
+ *	copy less than a vector, 8 bytes at a time with
+ *	an overlapping final 8 byte copy
+ */
+static inline void *stress_memcpy_small(void *dest, const void *src, size_t n)
+{
+	register uint8_t *d = (uint8_t *)dest;
+	register const uint8_t *s = (const uint8_t *)src;
+
+	if (n >= sizeof(uint64_t)) {
+		uint64_t v;
+
+		while (n > sizeof(uint64_t)) {
+			shim_memcpy(&v, s, sizeof(v));
+			shim_memcpy(d, &v, sizeof(v));
+			s += sizeof(v);
+			d += sizeof(v);
+			n -= sizeof(v);
+		}
+		shim_memcpy(&v, s + n - sizeof(v), sizeof(v));
+		shim_memcpy(d + n - sizeof(v), &v, sizeof(v));
+		return dest;
+	}
+	while (n--)
+		*(d++) = *(s++);
+	return dest;
+}
+
+/*
+ *  256 and 512 bit vector copies are built for AVX2 and AVX-512F
+ *  so they run at their full width, other targets would split them
+ *  into narrower vector operations, so they are just for x86
+ */
+#if defined(HAVE_VECMATH) &&		\
+    defined(STRESS_ARCH_X86) &&		\
+    (defined(HAVE_COMPILER_GCC) ||	\
+     defined(HAVE_COMPILER_CLANG) ||	\
+     defined(HAVE_COMPILER_ICX)) &&	\
+    !defined(HAVE_COMPILER_ICC)
+#define HAVE_MEMCPY_VEC
+#define TARGET_AVX2		__attribute__ ((target("avx2")))
+#define TARGET_AVX512F		__attribute__ ((target("avx512f")))
+
+typedef uint8_t stress_memcpy_w256_t __attribute__ ((vector_size(256 / 8)));
+typedef uint8_t stress_memcpy_w512_t __attribute__ ((vector_size(512 / 8)));
+
+/*
+ *  4 x unrolled copies using vec_t wide vectors, the vector width
+ *  and the target decides which SIMD instructions the compiler
+ *  uses. Loads and stores are unaligned and the tail is copied
+ *  with one overlapping vector copy.
+ */
+#define STRESS_MEMCPY_VEC(name, vec_t, target)				\
+static void * target OPTIMIZE3 name(void *dest, const void *src, size_t n) \
+{									\
+	register uint8_t *d = (uint8_t *)dest;				\
+	register const uint8_t *s = (const uint8_t *)src;		\
+	vec_t v0, v1, v2, v3;						\
+									\
+	if (n < sizeof(vec_t))						\
+		return stress_memcpy_small(dest, src, n);		\
+									\
+	while (n >= 4 * sizeof(vec_t)) {				\
+		shim_memcpy(&v0, s, sizeof(vec_t));			\
+		shim_memcpy(&v1, s + sizeof(vec_t), sizeof(vec_t));	\
+		shim_memcpy(&v2, s + 2 * sizeof(vec_t), sizeof(vec_t));	\
+		shim_memcpy(&v3, s + 3 * sizeof(vec_t), sizeof(vec_t));	\
+		shim_memcpy(d, &v0, sizeof(vec_t));			\
+		shim_memcpy(d + sizeof(vec_t), &v1, sizeof(vec_t));	\
+		shim_memcpy(d + 2 * sizeof(vec_t), &v2, sizeof(vec_t));	\
+		shim_memcpy(d + 3 * sizeof(vec_t), &v3, sizeof(vec_t));	\
+		s += 4 * sizeof(vec_t);					\
+		d += 4 * sizeof(vec_t);					\
+		n -= 4 * sizeof(vec_t);					\
+	}								\
+	while (n >= sizeof(vec_t)) {					\
+		shim_memcpy(&v0, s, sizeof(vec_t));			\
+		shim_memcpy(d, &v0, sizeof(vec_t));			\
+		s += sizeof(vec_t);					\
+		d += sizeof(vec_t);					\
+		n -= sizeof(vec_t);					\
+	}								\
+	if (n) {							\
+		shim_memcpy(&v0, s + n - sizeof(vec_t), sizeof(vec_t));	\
+		shim_memcpy(d + n - sizeof(vec_t), &v0, sizeof(vec_t));	\
+	}								\
+	return dest;							\
+}
+
+STRESS_MEMCPY_VEC(stress_memcpy_vec256_copy, stress_memcpy_w256_t, TARGET_AVX2)
+STRESS_MEMCPY_VEC(stress_memcpy_vec512_copy, stress_memcpy_w512_t, TARGET_AVX512F)
+
+/*
+ *  stress_memcpy_vec256_supported()
+ *	256 bit vector copies need AVX2
+ */
+static bool stress_memcpy_vec256_supported(void)
+{
+	return stress_cpu_x86_has_avx2();
+}
+
+/*
+ *  stress_memcpy_vec512_supported()
+ *	512 bit vector copies need AVX-512F
+ */
+static bool stress_memcpy_vec512_supported(void)
+{
+	return stress_cpu_x86_has_avx512_f();
+}
+#endif
+
+#if defined(HAVE_NT_STORE128)
+/*
+ *  stress_memcpy_nt_copy()
+ *	copy using 4 x unrolled 128 bit non-temporal stores to a
+ *	16 byte aligned destination, small copies are too short
+ *	to benefit from bypassing the cache so use regular stores
+ */
+static void * OPTIMIZE3 stress_memcpy_nt_copy(void *dest, const void *src, size_t n)
+{
+	register uint8_t *d = (uint8_t *)dest;
+	register const uint8_t *s = (const uint8_t *)src;
+	const size_t head = (sizeof(__uint128_t) - ((uintptr_t)d & (sizeof(__uint128_t) - 1))) & (sizeof(__uint128_t) - 1);
+	__uint128_t v0, v1, v2, v3;
+
+	if (n < MEMCPY_NT_MIN)
+		return stress_memcpy_small(dest, src, n);
+
+	(void)stress_memcpy_small(d, s, head);
+	s += head;
+	d += head;
+	n -= head;
+
+	while (n >= 4 * sizeof(__uint128_t)) {
+		shim_memcpy(&v0, s, sizeof(v0));
+		shim_memcpy(&v1, s + sizeof(v0), sizeof(v1));
+		shim_memcpy(&v2, s + 2 * sizeof(v0), sizeof(v2));
+		shim_memcpy(&v3, s + 3 * sizeof(v0), sizeof(v3));
+		stress_nt_store128((__uint128_t *)d, v0);
+		stress_nt_store128((__uint128_t *)d + 1, v1);
+		stress_nt_store128((__uint128_t *)d + 2, v2);
+		stress_nt_store128((__uint128_t *)d + 3, v3);
+		s += 4 * sizeof(__uint128_t);
+		d += 4 * sizeof(__uint128_t);
+		n -= 4 * sizeof(__uint128_t);
+	}
+	while (n >= sizeof(__uint128_t)) {
+		shim_memcpy(&v0, s, sizeof(v0));
+		stress_nt_store128((__uint128_t *)d, v0);
+		s += sizeof(__uint128_t);
+		d += sizeof(__uint128_t);
+		n -= sizeof(__uint128_t);
+	}
+	(void)stress_memcpy_small(d, s, n);
+	/* non-temporal stores are weakly ordered */
+	shim_mfence();
+
+	return dest;
+}
+
+/*
+ *  stress_memcpy_nt_supported()
+ *	non-temporal stores are x86 SSE2 movntdq, other
+ *	architectures use the compiler's non-temporal store builtin
+ */
+static bool stress_memcpy_nt_supported(void)
+{
+#if defined(STRESS_ARCH_X86)
+	return stress_cpu_x86_has_sse2();
+#else
+	return true;
+#endif
+}
+#endif
+
+#if defined(HAVE_ASM_X86_REP_MOVSB)
+/*
+ *  stress_memcpy_rep_movsb_copy()
+ *	x86 rep movsb string copy, fast with ERMS and for
+ *	short copies with FSRM
+ */
+static void * NOINLINE stress_memcpy_rep_movsb_copy(void *dest, const void *src, size_t n)
+{
+	void *d = dest;
+
+	__asm__ __volatile__(
+		"rep movsb\n"
+		: "+D" (d),
+		  "+S" (src),
+		  "+c" (n)
+		:
+		: "memory");
+	return dest;
+}
+#endif
+
 static NOINLINE void stress_memcpy_libc(
 	uint8_t *str1,
 	uint8_t *str2,
@@ -169,6 +384,9 @@ static void *stress_builtin_memmove_wrapper(void *dst, const void *src, size_t n
 {
 	return __builtin_memmove(dst, src, n);
 }
+#define STRESS_MEMCPY_BUILTIN_COPY	stress_builtin_memcpy_wrapper
+#else
+#define STRESS_MEMCPY_BUILTIN_COPY	memcpy
 #endif
 
 static NOINLINE void stress_memcpy_builtin(
@@ -242,55 +460,394 @@ STRESS_MEMCPY_NAIVE("naive_o1", stress_memcpy_naive_o1, test_naive_memcpy_o1, te
 STRESS_MEMCPY_NAIVE("naive_o2", stress_memcpy_naive_o2, test_naive_memcpy_o2, test_naive_memmove_o2)
 STRESS_MEMCPY_NAIVE("naive_o3", stress_memcpy_naive_o3, test_naive_memcpy_o3, test_naive_memmove_o3)
 
+/*
+ *  The copy engines only implement memcpy, the memmove
+ *  exercising parts of the method use libc memmove
+ */
+#if defined(HAVE_MEMCPY_VEC)
+STRESS_MEMCPY_NAIVE("vec256", stress_memcpy_vec256, stress_memcpy_vec256_copy, memmove)
+STRESS_MEMCPY_NAIVE("vec512", stress_memcpy_vec512, stress_memcpy_vec512_copy, memmove)
+#endif
+#if defined(HAVE_NT_STORE128)
+STRESS_MEMCPY_NAIVE("nt", stress_memcpy_nt, stress_memcpy_nt_copy, memmove)
+#endif
+#if defined(HAVE_ASM_X86_REP_MOVSB)
+STRESS_MEMCPY_NAIVE("rep_movsb", stress_memcpy_rep_movsb, stress_memcpy_rep_movsb_copy, memmove)
+#endif
+
+static void stress_memcpy_all(uint8_t *str1, uint8_t *str2, uint8_t *str3);
+
+static const stress_memcpy_method_info_t stress_memcpy_methods[] = {
+	{ "all",	stress_memcpy_all,	NULL,				NULL },
+	{ "libc",	stress_memcpy_libc,	memcpy,				NULL },
+	{ "builtin",	stress_memcpy_builtin,	STRESS_MEMCPY_BUILTIN_COPY,	NULL },
+	{ "naive",      stress_memcpy_naive,	test_naive_memcpy,		NULL },
+	{ "naive_o0",	stress_memcpy_naive_o0,	test_naive_memcpy_o0,		NULL },
+	{ "naive_o1",	stress_memcpy_naive_o1,	test_naive_memcpy_o1,		NULL },
+	{ "naive_o2",	stress_memcpy_naive_o2,	test_naive_memcpy_o2,		NULL },
+	{ "naive_o3",	stress_memcpy_naive_o3,	test_naive_memcpy_o3,		NULL },
+#if defined(HAVE_MEMCPY_VEC)
+	{ "vec256",	stress_memcpy_vec256,	stress_memcpy_vec256_copy,	stress_memcpy_vec256_supported },
+	{ "vec512",	stress_memcpy_vec512,	stress_memcpy_vec512_copy,	stress_memcpy_vec512_supported },
+#endif
+#if defined(HAVE_NT_STORE128)
+	{ "nt",		stress_memcpy_nt,	stress_memcpy_nt_copy,		stress_memcpy_nt_supported },
+#endif
+#if defined(HAVE_ASM_X86_REP_MOVSB)
+	{ "rep_movsb",	stress_memcpy_rep_movsb, stress_memcpy_rep_movsb_copy,	NULL },
+#endif
+};
+
+#define MEMCPY_METHOD_ALL	(0)
+#define MEMCPY_METHOD_LIBC	(1)
+
+/*
+ *  stress_memcpy_method_supported()
+ *	return true if memcpy method i can run on this CPU
+ */
+static bool stress_memcpy_method_supported(const size_t i)
+{
+	return !stress_memcpy_methods[i].supported || stress_memcpy_methods[i].supported();
+}
+
+/*
+ *  stress_memcpy_all()
+ *	cycle through all the supported memcpy methods
+ */
 static NOINLINE void stress_memcpy_all(
 	uint8_t *str1,
 	uint8_t *str2,
 	uint8_t *str3)
 {
-	static int whence;
+	static size_t whence = MEMCPY_METHOD_LIBC;
+	size_t i;
 
-	switch (whence) {
-	case 0:
-		whence++;
-		stress_memcpy_libc(str1, str2, str3);
-		return;
-	case 1:
-		whence++;
-		stress_memcpy_builtin(str1, str2, str3);
-		return;
-	case 2:
-		whence++;
-		stress_memcpy_naive(str1, str2, str3);
-		return;
-	case 3:
-		whence++;
-		stress_memcpy_naive_o0(str1, str2, str3);
-		return;
-	case 4:
-		whence++;
-		stress_memcpy_naive_o1(str1, str2, str3);
-		return;
-	case 5:
+	do {
+		i = whence;
 		whence++;
-		stress_memcpy_naive_o2(str1, str2, str3);
-		return;
-	default:
-		stress_memcpy_naive_o3(str1, str2, str3);
-		whence = 0;
+		if (whence >= SIZEOF_ARRAY(stress_memcpy_methods))
+			whence = MEMCPY_METHOD_LIBC;
+	} while (!stress_memcpy_method_supported(i));
+
+	stress_memcpy_methods[i].func(str1, str2, str3);
+}
+
+/*
+ *  stress_memcpy_size_str()
+ *	power of 2 copy size as a string, e.g. 8B, 4K, 64M
+ */
+static char *stress_memcpy_size_str(char *str, const size_t len, const size_t size)
+{
+	if (size >= GB)
+		(void)snprintf(str, len, "%zuG", size / (size_t)GB);
+	else if (size >= MB)
+		(void)snprintf(str, len, "%zuM", size / (size_t)MB);
+	else if (size >= KB)
+		(void)snprintf(str, len, "%zuK", size / (size_t)KB);
+	else
+		(void)snprintf(str, len, "%zuB", size);
+	return str;
+}
+
+/* src and dst misalignments of the --memcpy-sweep alignment matrix */
+static const size_t memcpy_sweep_offsets[] = { 0, 1, 8, 32 };
+
+#define MEMCPY_SWEEP_ALIGNS	(SIZEOF_ARRAY(memcpy_sweep_offsets) * SIZEOF_ARRAY(memcpy_sweep_offsets))
+
+/* --memcpy-sweep GB/sec per (method, size, alignment) cell */
+typedef struct {
+	size_t methods[SIZEOF_ARRAY(stress_memcpy_methods)];	/* method indices */
+	size_t sizes[MEMCPY_SWEEP_SIZES];	/* copy sizes */
+	size_t n_methods;		/* number of methods being swept */
+	size_t n_sizes;			/* number of copy sizes */
+	double *rate;			/* sum of GB/sec per cell */
+	uint64_t *count;		/* measurements per cell */
+} stress_memcpy_sweep_t;
+
+/*
+ *  stress_memcpy_sweep_cell()
+ *	index of the method, size, alignment cell
+ */
+static inline size_t stress_memcpy_sweep_cell(
+	const stress_memcpy_sweep_t *sweep,
+	const size_t method,
+	const size_t size,
+	const size_t align)
+{
+	return ((method * sweep->n_sizes) + size) * MEMCPY_SWEEP_ALIGNS + align;
+}
+
+/*
+ *  stress_memcpy_sweep_rate()
+ *	mean GB/sec of a cell, -1.0 if it has not been measured
+ */
+static double stress_memcpy_sweep_rate(
+	const stress_memcpy_sweep_t *sweep,
+	const size_t method,
+	const size_t size,
+	const size_t align)
+{
+	const size_t cell = stress_memcpy_sweep_cell(sweep, method, size, align);
+
+	return sweep->count[cell] ? sweep->rate[cell] / (double)sweep->count[cell] : -1.0;
+}
+
+/*
+ *  stress_memcpy_sweep_measure()
+ *	copy size bytes from src to dst for a time slice, batching
+ *	small copies between time checks, returns GB/sec
+ */
+static double OPTIMIZE3 stress_memcpy_sweep_measure(
+	const memcpy_func_t copy,
+	uint8_t *dst,
+	const uint8_t *src,
+	const size_t size)
+{
+	const size_t batch = (size >= MEMCPY_SWEEP_BATCH) ? 1 : MEMCPY_SWEEP_BATCH / size;
+	uint64_t copies = 0;
+	double t1, t2;
+
+	t1 = stress_time_now();
+	do {
+		size_t i;
+
+		for (i = 0; i < batch; i++)
+			(void)copy(dst, src, size);
+		copies += batch;
+		t2 = stress_time_now();
+	} while ((t2 - t1) < MEMCPY_SWEEP_SLICE);
+
+	return ((double)copies * (double)size) / ((t2 - t1) * (double)GB);
+}
+
+/*
+ *  stress_memcpy_sweep_report()
+ *	report the GB/sec of each method over the copy sizes and
+ *	alignments, the fastest aligned method for each range of
+ *	copy sizes and the peak aligned copy rate metrics
+ */
+static void stress_memcpy_sweep_report(
+	stress_args_t *args,
+	const stress_memcpy_sweep_t *sweep)
+{
+	const size_t n_offsets = SIZEOF_ARRAY(memcpy_sweep_offsets);
+	char line[256], str[16], str2[16];
+	size_t m, i, j, run_start = 0, run_method = 0;
+	bool run = false;
+
+	for (m = 0; m < sweep->n_methods; m++) {
+		const char *name = stress_memcpy_methods[sweep->methods[m]].name;
+		double peak = -1.0;
+		size_t len;
+
+		pr_block_begin();
+		pr_inf("%s: %s copy rate GB/sec per copy size and src/dst misalignment\n",
+			args->name, name);
+		len = (size_t)snprintf(line, sizeof(line), "%8s", "size");
+		for (j = 0; j < MEMCPY_SWEEP_ALIGNS; j++) {
+			(void)snprintf(str, sizeof(str), "%zu/%zu",
+				memcpy_sweep_offsets[j / n_offsets],
+				memcpy_sweep_offsets[j % n_offsets]);
+			len += (size_t)snprintf(line + len, sizeof(line) - len, " %6s", str);
+		}
+		pr_inf("%s: %s\n", args->name, line);
+		for (i = 0; i < sweep->n_sizes; i++) {
+			const double aligned = stress_memcpy_sweep_rate(sweep, m, i, 0);
+
+			if (aligned < 0.0)
+				break;
+			if (peak < aligned)
+				peak = aligned;
+			len = (size_t)snprintf(line, sizeof(line), "%8s",
+				stress_memcpy_size_str(str, sizeof(str), sweep->sizes[i]));
+			for (j = 0; j < MEMCPY_SWEEP_ALIGNS; j++) {
+				const double rate = stress_memcpy_sweep_rate(sweep, m, i, j);
+
+				if (rate < 0.0)
+					len += (size_t)snprintf(line + len, sizeof(line) - len, " %6s", "-");
+				else
+					len += (size_t)snprintf(line + len, sizeof(line) - len, " %6.2f", rate);
+			}
+			pr_inf("%s: %s\n", args->name, line);
+		}
+		pr_block_end();
+		if (peak > 0.0) {
+			(void)snprintf(line, sizeof(line), "GB per sec %s peak aligned copy rate", name);
+			stress_metrics_set(args, line, peak, STRESS_METRIC_HARMONIC_MEAN);
+		}
+	}
+
+	if (sweep->n_methods < 2)
 		return;
+
+	/* ranges of copy sizes where a method is the fastest aligned copy */
+	pr_block_begin();
+	for (i = 0; i <= sweep->n_sizes; i++) {
+		size_t best = 0;
+		double best_rate = -1.0;
+
+		for (m = 0; (i < sweep->n_sizes) && (m < sweep->n_methods); m++) {
+			const double rate = stress_memcpy_sweep_rate(sweep, m, i, 0);
+
+			if (best_rate < rate) {
+				best_rate = rate;
+				best = m;
+			}
+		}
+		if (run && ((best_rate < 0.0) || (best != run_method))) {
+			pr_inf("%s: %s is the fastest aligned copy from %s to %s\n",
+				args->name, stress_memcpy_methods[sweep->methods[run_method]].name,
+				stress_memcpy_size_str(str, sizeof(str), sweep->sizes[run_start]),
+				stress_memcpy_size_str(str2, sizeof(str2), sweep->sizes[i - 1]));
+			run = false;
+		}
+		if (best_rate < 0.0)
+			break;
+		if (!run) {
+			run = true;
+			run_start = i;
+			run_method = best;
+		}
 	}
+#if defined(HAVE_ASM_X86_REP_MOVSB)
+	if (stress_cpu_is_x86())
+		pr_inf("%s: rep movsb, enhanced (ERMS) %s, fast short (FSRM) %s\n",
+			args->name, stress_cpu_x86_has_erms() ? "yes" : "no",
+			stress_cpu_x86_has_fsrm() ? "yes" : "no");
+#endif
+	pr_block_end();
 }
 
-static const stress_memcpy_method_info_t stress_memcpy_methods[] = {
-	{ "all",	stress_memcpy_all },
-	{ "libc",	stress_memcpy_libc },
-	{ "builtin",	stress_memcpy_builtin },
-	{ "naive",      stress_memcpy_naive },
-	{ "naive_o0",	stress_memcpy_naive_o0 },
-	{ "naive_o1",	stress_memcpy_naive_o1 },
-	{ "naive_o2",	stress_memcpy_naive_o2 },
-	{ "naive_o3",	stress_memcpy_naive_o3 },
-};
+/*
+ *  stress_memcpy_sweep()
+ *	measure the copy rate of the memcpy methods over power of 2
+ *	copy sizes from 8 bytes to --memcpy-sweep-max bytes for a
+ *	matrix of src and dst misalignments
+ */
+static int stress_memcpy_sweep(stress_args_t *args, const size_t memcpy_method)
+{
+	uint64_t sweep_max = DEFAULT_MEMCPY_SWEEP_MAX;
+	stress_memcpy_sweep_t sweep;
+	const bool verify = !!(g_opt_flags & OPT_FLAGS_VERIFY);
+	const size_t n_offsets = SIZEOF_ARRAY(memcpy_sweep_offsets);
+	size_t i, region, buf_size, cells;
+	uint8_t *buf, *src, *dst;
+	int rc = EXIT_SUCCESS;
+
+	/*
+	 *  Other instances would compete for the caches and memory
+	 *  bandwidth and skew the copy rates, so just instance 0 sweeps
+	 */
+	if (!stress_instance_zero(args)) {
+		pr_dbg("%s: --memcpy-sweep only runs on instance 0, instance %" PRIu32 " is idle\n",
+			args->name, args->instance);
+		stress_proc_state_set(args->name, STRESS_STATE_SYNC_WAIT);
+		stress_sync_start_wait(args);
+		stress_proc_state_set(args->name, STRESS_STATE_RUN);
+		/* Wait for termination */
+		while (stress_continue(args))
+			(void)shim_pause();
+		stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
+		return EXIT_SUCCESS;
+	}
+	if (args->instances > 1)
+		pr_inf("%s: --memcpy-sweep only runs on instance 0, the other instances are idle\n",
+			args->name);
+
+	(void)stress_setting_get("memcpy-sweep-max", &sweep_max);
+
+	(void)shim_memset(&sweep, 0, sizeof(sweep));
+	for (i = MEMCPY_SWEEP_MIN; (i <= sweep_max) && (sweep.n_sizes < MEMCPY_SWEEP_SIZES); i <<= 1)
+		sweep.sizes[sweep.n_sizes++] = i;
+	if (memcpy_method == MEMCPY_METHOD_ALL) {
+		for (i = MEMCPY_METHOD_LIBC; i < SIZEOF_ARRAY(stress_memcpy_methods); i++) {
+			if (stress_memcpy_method_supported(i))
+				sweep.methods[sweep.n_methods++] = i;
+		}
+	} else {
+		sweep.methods[sweep.n_methods++] = memcpy_method;
+	}
+
+	cells = sweep.n_methods * sweep.n_sizes * MEMCPY_SWEEP_ALIGNS;
+	sweep.rate = (double *)calloc(cells, sizeof(*sweep.rate));
+	sweep.count = (uint64_t *)calloc(cells, sizeof(*sweep.count));
+	if (!sweep.rate || !sweep.count) {
+		pr_inf_skip("%s: failed to allocate %zu copy rate cells%s, skipping stressor\n",
+			args->name, cells, stress_memory_free_get());
+		rc = EXIT_NO_RESOURCE;
+		goto tidy_cells;
+	}
+
+	/* page aligned src and dst regions with room for the misalignments */
+	region = (sweep.sizes[sweep.n_sizes - 1] + MEMCPY_SWEEP_PAD + args->page_size - 1) & ~(args->page_size - 1);
+	buf_size = 2 * region;
+	buf = (uint8_t *)stress_mmap_populate(NULL, buf_size,
+				PROT_READ | PROT_WRITE,
+				MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+	if (buf == MAP_FAILED) {
+		pr_inf_skip("%s: mmap of %zu bytes failed%s, errno=%d (%s), skipping stressor\n",
+			args->name, buf_size, stress_memory_free_get(), errno, strerror(errno));
+		rc = EXIT_NO_RESOURCE;
+		goto tidy_cells;
+	}
+	stress_memory_anon_name_set(buf, buf_size, "memcpy-sweep-buffer");
+	src = buf;
+	dst = buf + region;
+	stress_rndbuf(src, region);
+	stress_memory_usage_get(args, buf_size, buf_size);
+
+	stress_proc_state_set(args->name, STRESS_STATE_SYNC_WAIT);
+	stress_sync_start_wait(args);
+	stress_proc_state_set(args->name, STRESS_STATE_RUN);
+
+	do {
+		size_t m;
+
+		for (m = 0; m < sweep.n_methods; m++) {
+			const stress_memcpy_method_info_t *info = &stress_memcpy_methods[sweep.methods[m]];
+
+			for (i = 0; i < sweep.n_sizes; i++) {
+				const size_t size = sweep.sizes[i];
+				size_t j;
+
+				for (j = 0; j < MEMCPY_SWEEP_ALIGNS; j++) {
+					const uint8_t *s = src + memcpy_sweep_offsets[j / n_offsets];
+					uint8_t *d = dst + memcpy_sweep_offsets[j % n_offsets];
+					const size_t cell = stress_memcpy_sweep_cell(&sweep, m, i, j);
+
+					if (verify)
+						(void)shim_memset(d, 0, size);
+					/* first copy warms the caches and is verified */
+					(void)info->copy(d, s, size);
+					if (verify && shim_memcmp(d, s, size)) {
+						pr_fail("%s: %s: %zu byte copy with %zu/%zu src/dst misalignment "
+							"content is different than expected\n",
+							args->name, info->name, size,
+							memcpy_sweep_offsets[j / n_offsets],
+							memcpy_sweep_offsets[j % n_offsets]);
+						rc = EXIT_FAILURE;
+						goto deinit;
+					}
+					sweep.rate[cell] += stress_memcpy_sweep_measure(info->copy, d, s, size);
+					sweep.count[cell]++;
+					stress_bogo_inc(args);
+					if (UNLIKELY(!stress_continue(args)))
+						goto deinit;
+				}
+			}
+		}
+	} while (stress_continue(args));
+
+deinit:
+	stress_memcpy_sweep_report(args, &sweep);
+	stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
+	(void)munmap((void *)buf, buf_size);
+tidy_cells:
+	free(sweep.count);
+	free(sweep.rate);
+
+	return rc;
+}
 
 /*
  *  stress_memcpy()
@@ -302,9 +859,21 @@ static int stress_memcpy(stress_args_t *args)
 	uint8_t *str1;
 	uint8_t *str2;
 	uint8_t *str3;
-	size_t memcpy_method = 0;
+	size_t memcpy_method = MEMCPY_METHOD_ALL;
+	bool memcpy_sweep = false;
 	stress_memcpy_func func;
 
+	(void)stress_setting_get("memcpy-method", &memcpy_method);
+	if (!stress_memcpy_method_supported(memcpy_method)) {
+		if (stress_instance_zero(args))
+			pr_inf("%s: memcpy method '%s' not supported by this CPU, using libc method\n",
+				args->name, stress_memcpy_methods[memcpy_method].name);
+		memcpy_method = MEMCPY_METHOD_LIBC;
+	}
+	(void)stress_setting_get("memcpy-sweep", &memcpy_sweep);
+	if (memcpy_sweep)
+		return stress_memcpy_sweep(args, memcpy_method);
+
 	memcpy_okay = true;
 	buf = (uint8_t *)stress_mmap_populate(NULL, 3 * MEMCPY_MEMSIZE,
 				PROT_READ | PROT_WRITE,
@@ -331,7 +900,6 @@ static int stress_memcpy(stress_args_t *args)
 		memmove_check = memmove_no_check_func;
 	}
 
-	(void)stress_setting_get("memcpy-method", &memcpy_method);
 	func = stress_memcpy_methods[memcpy_method].func;
 	stress_rndbuf(str3, MEMCPY_MEMSIZE);
 
@@ -357,7 +925,9 @@ static const char *stress_memcpy_method(const size_t i)
 }
 
 static const stress_opt_t opts[] = {
-	{ OPT_memcpy_method, "memcpy-method", TYPE_ID_SIZE_T_METHOD, 0, 0, stress_memcpy_method },
+	{ OPT_memcpy_method,    "memcpy-method",    TYPE_ID_SIZE_T_METHOD, 0, 0, stress_memcpy_method },
+	{ OPT_memcpy_sweep,     "memcpy-sweep",     TYPE_ID_BOOL, 0, 1, NULL },
+	{ OPT_memcpy_sweep_max, "memcpy-sweep-max", TYPE_ID_UINT64_BYTES_VM, MIN_MEMCPY_SWEEP_MAX, MAX_MEMCPY_SWEEP_MAX, NULL },
 	END_OPT,
 };
 
@@ -382,4 +952,5 @@ const stressor_info_t stress_memcpy_info = {
 	.verify = VERIFY_OPTIONAL,
 	.help = help,
 	.exercises = exercises,
+	.max_metrics_items = SIZEOF_ARRAY(stress_memcpy_methods),
 };
@@ -26,6 +26,7 @@
 #include "core-mmap.h"
 #include "core-nt-store.h"
 #include "core-out-of-memory.h"
+#include "core-put.h"
 #include "core-signal.h"
 #include "core-target-clones.h"
 #include "core-vecmath.h"
@@ -46,11 +47,22 @@
 
 #define STRESS_PTR_MINIMUM(a, b)	STRESS_MINIMUM((uintptr_t)a, (uintptr_t)b)
 
+#define STRESS_MEMRATE_LATENCY_LEVELS	(10)	/* 10%, 20%, .. 100% of peak load */
+#define STRESS_MEMRATE_LATENCY_STEPS	(STRESS_MEMRATE_LATENCY_LEVELS + 2)
+#define STRESS_MEMRATE_LATENCY_IDLE	(0)	/* step 0, no load */
+#define STRESS_MEMRATE_LATENCY_PEAK	(1)	/* step 1, unthrottled load */
+#define STRESS_MEMRATE_LATENCY_SLICE	(0.25)	/* seconds per latency step */
+#define STRESS_MEMRATE_LATENCY_SETTLE	(10000000ULL)	/* nanosecs for load to settle */
+#define STRESS_MEMRATE_LATENCY_CHUNK	(64 * KB)	/* load bytes between rate checks */
+#define STRESS_MEMRATE_LATENCY_CHASES	(1024)	/* pointer chases between time checks */
+#define STRESS_MEMRATE_LATENCY_KNEE	(2.0)	/* knee when latency doubles */
+
 static const stress_help_t help[] = {
 	{ NULL,	"memrate N",             "start N workers exercised memory read/writes" },
 	{ NULL,	"memrate-bytes N",       "size of memory buffer being exercised" },
 	{ NULL, "memrate-discontiguous", "make mmap'd physical pages discontiguous" },
 	{ NULL,	"memrate-flush",         "flush cache before each iteration" },
+	{ NULL,	"memrate-latency",       "measure pointer chase latency against stepped memory load" },
 	{ NULL, "memrate-method M",      "specify read/write memory exercising method" },
 	{ NULL,	"memrate-ops N",         "stop after N memrate bogo operations" },
 	{ NULL,	"memrate-rd-mbs N",      "read rate from buffer in megabytes per second" },
@@ -76,6 +88,32 @@ typedef struct {
 	bool		valid;
 } stress_memrate_stats_t;
 
+/* Per loaded-latency step results */
+typedef struct {
+	double latency;			/* sum of nanosecs per pointer chase */
+	double mb_rate;			/* sum of load MB per sec */
+	uint32_t count;			/* number of measurements */
+} stress_memrate_latency_result_t;
+
+/* Per load generating instance byte count, one per cache line */
+typedef struct {
+	volatile uint64_t bytes;	/* bytes read */
+	uint8_t pad[56];		/* pad to 64 bytes */
+} stress_memrate_latency_load_t;
+
+/* Loaded-latency state shared between all the memrate instances */
+typedef struct {
+	volatile uint64_t mbs;		/* per instance load MB/sec, 0 = idle, ~0 = unthrottled */
+	volatile uint32_t step;		/* bumped on each load rate change */
+	volatile bool done;		/* latency instance has finished */
+	uint32_t instances;		/* number of memrate instances */
+	size_t size;			/* size of mmap'd state */
+	stress_memrate_latency_result_t result[STRESS_MEMRATE_LATENCY_STEPS];
+	stress_memrate_latency_load_t load[];	/* per instance load */
+} stress_memrate_latency_t;
+
+static stress_memrate_latency_t *memrate_latency = MAP_FAILED;
+
 typedef struct {
 	stress_memrate_stats_t *memrate_stats;
 	stress_mmap_stats_t mmap_stats;
@@ -87,6 +125,7 @@ typedef struct {
 	void *end;
 	bool memrate_discontiguous;
 	bool memrate_flush;
+	bool memrate_latency;
 } stress_memrate_context_t;
 
 typedef uint64_t (*stress_memrate_func_t)(const stress_memrate_context_t *context, bool *valid);
@@ -1172,6 +1211,307 @@ static void stress_memrate_dispatch_method(
 	context->memrate_stats[method].valid = valid;
 }
 
+/*
+ *  stress_memrate_init()
+ *	allocate loaded-latency state shared by all the instances
+ */
+static void stress_memrate_init(const uint32_t instances)
+{
+	const size_t size = sizeof(*memrate_latency) +
+		((size_t)instances * sizeof(memrate_latency->load[0]));
+
+	memrate_latency = (stress_memrate_latency_t *)
+		stress_mmap_populate(NULL, size, PROT_READ | PROT_WRITE,
+			MAP_ANONYMOUS | MAP_SHARED, -1, 0);
+	if (memrate_latency == MAP_FAILED)
+		return;
+	stress_memory_anon_name_set(memrate_latency, size, "memrate-latency");
+	(void)shim_memset(memrate_latency, 0, size);
+	memrate_latency->instances = instances;
+	memrate_latency->size = size;
+}
+
+/*
+ *  stress_memrate_deinit()
+ *	free loaded-latency state
+ */
+static void stress_memrate_deinit(void)
+{
+	if (memrate_latency != MAP_FAILED) {
+		(void)munmap((void *)memrate_latency, memrate_latency->size);
+		memrate_latency = MAP_FAILED;
+	}
+}
+
+/*
+ *  stress_memrate_latency_read()
+ *	read 64 bit words from start to end
+ */
+static void OPTIMIZE3 stress_memrate_latency_read(const uint64_t *start, const uint64_t *end)
+{
+	register const uint64_t *ptr;
+
+	for (ptr = start; ptr < end; ptr += 8) {
+		uint64_t v;
+
+		v = *(const volatile uint64_t *)&ptr[0];
+		(void)v;
+		v = *(const volatile uint64_t *)&ptr[1];
+		(void)v;
+		v = *(const volatile uint64_t *)&ptr[2];
+		(void)v;
+		v = *(const volatile uint64_t *)&ptr[3];
+		(void)v;
+		v = *(const volatile uint64_t *)&ptr[4];
+		(void)v;
+		v = *(const volatile uint64_t *)&ptr[5];
+		(void)v;
+		v = *(const volatile uint64_t *)&ptr[6];
+		(void)v;
+		v = *(const volatile uint64_t *)&ptr[7];
+		(void)v;
+	}
+}
+
+/*
+ *  stress_memrate_latency_load()
+ *	generate read memory load at the rate set by the latency
+ *	instance until the latency instance has finished
+ */
+static void stress_memrate_latency_load(
+	stress_args_t *args,
+	const stress_memrate_context_t *context)
+{
+	stress_memrate_latency_load_t *load = &memrate_latency->load[args->instance];
+	uint8_t *ptr = (uint8_t *)context->start;
+	const uint64_t chunk = STRESS_MINIMUM(STRESS_MEMRATE_LATENCY_CHUNK, context->memrate_bytes);
+	uint32_t step = ~0U;
+	uint64_t mbs = 0, bytes = 0;
+	double t_start = 0.0;
+
+	while (!memrate_latency->done && stress_continue(args)) {
+		double ahead;
+
+		/* load rate changed, restart rate accounting */
+		if (step != memrate_latency->step) {
+			step = memrate_latency->step;
+			mbs = memrate_latency->mbs;
+			bytes = 0;
+			t_start = stress_time_now();
+		}
+		if (mbs == 0) {
+			(void)shim_nanosleep_uint64(1000000);
+			continue;
+		}
+
+		if (ptr + chunk > (uint8_t *)context->end)
+			ptr = (uint8_t *)context->start;
+		stress_memrate_latency_read((uint64_t *)ptr, (uint64_t *)(ptr + chunk));
+		ptr += chunk;
+		bytes += chunk;
+		load->bytes += chunk;
+		stress_bogo_inc(args);
+
+		if (mbs == ~0ULL)
+			continue;
+		/* throttle, sleep if ahead of the requested rate */
+		ahead = ((double)bytes / ((double)mbs * MB)) - (stress_time_now() - t_start);
+		if (ahead > 0.0)
+			(void)shim_nanosleep_uint64((uint64_t)(ahead * STRESS_DBL_NANOSECOND));
+	}
+}
+
+/*
+ *  stress_memrate_latency_bytes()
+ *	sum of the bytes read by the load instances
+ */
+static uint64_t stress_memrate_latency_bytes(void)
+{
+	uint64_t bytes = 0;
+	uint32_t i;
+
+	for (i = 1; i < memrate_latency->instances; i++)
+		bytes += memrate_latency->load[i].bytes;
+	return bytes;
+}
+
+/*
+ *  stress_memrate_latency_chase_init()
+ *	link the cache lines of the buffer into a single random
+ *	cycle using Sattolo's algorithm so that each pointer chase
+ *	is dependent on the previous one and defeats prefetching
+ */
+static void **stress_memrate_latency_chase_init(const stress_memrate_context_t *context)
+{
+	void **lines = (void **)context->start;
+	const size_t stride = 64 / sizeof(*lines);
+	const size_t n = (size_t)(((uint8_t *)context->end - (uint8_t *)context->start) / 64);
+	uint32_t *order;
+	size_t i;
+
+	if ((n < 2) || (n > UINT32_MAX))
+		return NULL;
+	order = (uint32_t *)calloc(n, sizeof(*order));
+	if (!order)
+		return NULL;
+	for (i = 0; i < n; i++)
+		order[i] = (uint32_t)i;
+	for (i = n - 1; i > 0; i--) {
+		const size_t j = (size_t)stress_mwc32modn((uint32_t)i);
+		const uint32_t tmp = order[i];
+
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+	for (i = 0; i < n; i++)
+		lines[order[i] * stride] = (void *)&lines[order[(i + 1) % n] * stride];
+
+	free(order);
+	return lines;
+}
+
+/*
+ *  stress_memrate_latency_probe()
+ *	step the load instances through idle, unthrottled and 10%..100%
+ *	of the unthrottled load and measure the dependent pointer chase
+ *	latency and the load bandwidth at each step
+ */
+static void stress_memrate_latency_probe(
+	stress_args_t *args,
+	const stress_memrate_context_t *context)
+{
+	const uint32_t loaders = memrate_latency->instances - 1;
+	void **ptr;
+	double peak_mbs = 0.0;
+
+	ptr = stress_memrate_latency_chase_init(context);
+	if (!ptr) {
+		pr_inf("%s: cannot initialize pointer chase buffer, skipping latency measurements\n",
+			args->name);
+		memrate_latency->done = true;
+		return;
+	}
+
+	do {
+		size_t i;
+
+		for (i = 0; i < STRESS_MEMRATE_LATENCY_STEPS; i++) {
+			stress_memrate_latency_result_t *result = &memrate_latency->result[i];
+			uint64_t bytes1, bytes2, chases = 0;
+			double t1, t2;
+
+			/* no load instances, just measure idle latency */
+			if ((i > STRESS_MEMRATE_LATENCY_IDLE) && (loaders == 0))
+				break;
+			if (i == STRESS_MEMRATE_LATENCY_IDLE) {
+				memrate_latency->mbs = 0;
+			} else if (i == STRESS_MEMRATE_LATENCY_PEAK) {
+				memrate_latency->mbs = ~0ULL;
+			} else {
+				/* peak load too low to step */
+				if (peak_mbs < (double)(loaders * STRESS_MEMRATE_LATENCY_LEVELS))
+					break;
+				memrate_latency->mbs = (uint64_t)((peak_mbs / (double)loaders) *
+					(double)(i - 1) / (double)STRESS_MEMRATE_LATENCY_LEVELS);
+			}
+			memrate_latency->step++;
+			(void)shim_nanosleep_uint64(STRESS_MEMRATE_LATENCY_SETTLE);
+
+			bytes1 = stress_memrate_latency_bytes();
+			t1 = stress_time_now();
+			do {
+				register int j;
+
+				for (j = 0; j < STRESS_MEMRATE_LATENCY_CHASES; j++)
+					ptr = (void **)*ptr;
+				chases += STRESS_MEMRATE_LATENCY_CHASES;
+				t2 = stress_time_now();
+			} while ((t2 - t1) < STRESS_MEMRATE_LATENCY_SLICE);
+			bytes2 = stress_memrate_latency_bytes();
+
+			result->latency += ((t2 - t1) * STRESS_DBL_NANOSECOND) / (double)chases;
+			result->mb_rate += ((double)(bytes2 - bytes1) / (double)MB) / (t2 - t1);
+			result->count++;
+			if (i == STRESS_MEMRATE_LATENCY_PEAK)
+				peak_mbs = result->mb_rate / (double)result->count;
+			stress_bogo_inc(args);
+			if (UNLIKELY(!stress_continue(args)))
+				break;
+		}
+	} while (stress_continue(args));
+
+	stress_put_void_ptr((volatile void *)ptr);
+	memrate_latency->done = true;
+}
+
+/*
+ *  stress_memrate_latency_report()
+ *	report the loaded-latency curve, latency against load bandwidth
+ */
+static void stress_memrate_latency_report(stress_args_t *args)
+{
+	const stress_memrate_latency_result_t *idle = &memrate_latency->result[STRESS_MEMRATE_LATENCY_IDLE];
+	double idle_latency, peak_mb_rate = 0.0;
+	double knee_mb_rate = 0.0, knee_latency = 0.0;
+	size_t i;
+
+	if (idle->count == 0) {
+		pr_inf("%s: no latency measurements, run duration too short\n", args->name);
+		return;
+	}
+	idle_latency = idle->latency / (double)idle->count;
+
+	pr_block_begin();
+	pr_inf("%s: loaded latency, %" PRIu32 " load instance%s:\n", args->name,
+		memrate_latency->instances - 1, (memrate_latency->instances == 2) ? "" : "s");
+	pr_inf("%s: %10s %12s %12s\n", args->name, "load", "MB per sec", "nanosecs");
+	for (i = 0; i < STRESS_MEMRATE_LATENCY_STEPS; i++) {
+		const stress_memrate_latency_result_t *result = &memrate_latency->result[i];
+		double latency, mb_rate;
+		char load[16], str[64];
+
+		if (result->count == 0)
+			continue;
+		latency = result->latency / (double)result->count;
+		mb_rate = result->mb_rate / (double)result->count;
+
+		if (i == STRESS_MEMRATE_LATENCY_IDLE) {
+			(void)shim_strscpy(load, "idle", sizeof(load));
+		} else if (i == STRESS_MEMRATE_LATENCY_PEAK) {
+			(void)shim_strscpy(load, "unthrottled", sizeof(load));
+			peak_mb_rate = mb_rate;
+		} else {
+			(void)snprintf(load, sizeof(load), "%zu%%",
+				((i - 1) * 100) / STRESS_MEMRATE_LATENCY_LEVELS);
+		}
+		pr_inf("%s: %10s %12.2f %12.2f\n", args->name, load, mb_rate, latency);
+
+		(void)snprintf(str, sizeof(str), "%s load latency nanosecs", load);
+		stress_metrics_set(args, str, latency, STRESS_METRIC_GEOMETRIC_MEAN);
+		if (i != STRESS_MEMRATE_LATENCY_IDLE) {
+			(void)snprintf(str, sizeof(str), "%s load MB per sec", load);
+			stress_metrics_set(args, str, mb_rate, STRESS_METRIC_GEOMETRIC_MEAN);
+		}
+
+		/* knee, first stepped load where the latency has doubled */
+		if ((knee_latency == 0.0) && (i > STRESS_MEMRATE_LATENCY_PEAK) &&
+		    (latency >= idle_latency * STRESS_MEMRATE_LATENCY_KNEE)) {
+			knee_mb_rate = mb_rate;
+			knee_latency = latency;
+		}
+	}
+	if (knee_latency > 0.0) {
+		pr_inf("%s: latency knee at %.2f MB per sec, %.2f nanosecs\n",
+			args->name, knee_mb_rate, knee_latency);
+		if (peak_mb_rate > 0.0)
+			stress_metrics_set(args, "latency knee % of unthrottled load",
+				100.0 * knee_mb_rate / peak_mb_rate, STRESS_METRIC_GEOMETRIC_MEAN);
+	} else if (peak_mb_rate > 0.0) {
+		pr_inf("%s: no latency knee found, latency did not double under load\n", args->name);
+	}
+	pr_block_end();
+}
+
 static int stress_memrate_child(stress_args_t *args, void *ctxt)
 {
 	stress_memrate_context_t *context = (stress_memrate_context_t *)ctxt;
@@ -1196,6 +1536,14 @@ static int stress_memrate_child(stress_args_t *args, void *ctxt)
 	context->start = buffer;
 	context->end = buffer_end;
 
+	if (context->memrate_latency) {
+		if (stress_instance_zero(args))
+			stress_memrate_latency_probe(args, context);
+		else
+			stress_memrate_latency_load(args, context);
+		goto unmap;
+	}
+
 #if defined(HAVE_SIGLONGJMP)
 	if (sigsetjmp(jmp_env, 1) != 0)
 		goto tidy;
@@ -1230,6 +1578,7 @@ static int stress_memrate_child(stress_args_t *args, void *ctxt)
 tidy:
 	do_jmp = false;
 #endif
+unmap:
 	(void)munmap(buffer, context->memrate_bytes);
 	return EXIT_SUCCESS;
 }
@@ -1267,15 +1616,29 @@ static int stress_memrate(stress_args_t *args)
 	context->memrate_rd_mbs = ~0ULL;
 	context->memrate_wr_mbs = ~0ULL;
 	context->memrate_flush = false;
+	context->memrate_latency = false;
 	context->memrate_method = 0; 	/* all */
 
 	(void)stress_setting_get("memrate-bytes", &context->memrate_bytes);
 	(void)stress_setting_get("memrate-discontiguous", &context->memrate_discontiguous);
 	(void)stress_setting_get("memrate-flush", &context->memrate_flush);
+	(void)stress_setting_get("memrate-latency", &context->memrate_latency);
 	(void)stress_setting_get("memrate-rd-mbs", &context->memrate_rd_mbs);
 	(void)stress_setting_get("memrate-wr-mbs", &context->memrate_wr_mbs);
 	(void)stress_setting_get("memrate-method", &context->memrate_method);
 
+	if (context->memrate_latency) {
+		if (memrate_latency == MAP_FAILED) {
+			if (stress_instance_zero(args))
+				pr_inf("%s: cannot allocate loaded-latency state, disabling --memrate-latency\n",
+					args->name);
+			context->memrate_latency = false;
+		} else if (stress_instance_zero(args) && (args->instances < 2)) {
+			pr_inf("%s: --memrate-latency needs 2 or more instances to generate "
+				"memory load, just measuring idle latency\n", args->name);
+		}
+	}
+
 	if ((context->memrate_rd_mbs == 0ULL) && (context->memrate_wr_mbs == 0ULL)) {
 		pr_fail("%s: cannot use zero MB rates for read and write\n", args->name);
 		rc = EXIT_FAILURE;
@@ -1326,6 +1689,9 @@ static int stress_memrate(stress_args_t *args)
 
 	stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
 
+	if (context->memrate_latency && stress_instance_zero(args))
+		stress_memrate_latency_report(args);
+
 	rd_mantissa = 1.0;
 	rd_exponent = 0;
 	rd_n = 0.0;
@@ -1406,6 +1772,7 @@ static const stress_opt_t opts[] = {
 	{ OPT_memrate_bytes,         "memrate-bytes",  TYPE_ID_UINT64_BYTES_VM, MIN_MEMRATE_BYTES, MAX_MEMRATE_BYTES, NULL },
 	{ OPT_memrate_discontiguous, "memrate-discontiguous", TYPE_ID_BOOL, 0, 1, NULL },
 	{ OPT_memrate_flush,         "memrate-flush",  TYPE_ID_BOOL, 0, 1, NULL },
+	{ OPT_memrate_latency,       "memrate-latency", TYPE_ID_BOOL, 0, 1, NULL },
 	{ OPT_memrate_rd_mbs,        "memrate-rd-mbs", TYPE_ID_UINT64, 0, 1000000, NULL },
 	{ OPT_memrate_wr_mbs,        "memrate-wr-mbs", TYPE_ID_UINT64, 0, 1000000, NULL },
 	{ OPT_memrate_method,        "memrate-method", TYPE_ID_SIZE_T_METHOD, 0, 0, stress_memmap_method },
@@ -1426,6 +1793,8 @@ static const stress_exercises_t exercises[] = {
 const stressor_info_t stress_memrate_info = {
 	.stressor = stress_memrate,
 	.classifier = CLASS_MEMORY,
+	.init = stress_memrate_init,
+	.deinit = stress_memrate_deinit,
 	.opts = opts,
 	.help = help,
 	.max_metrics_items = SIZEOF_ARRAY(memrate_info) + 3,
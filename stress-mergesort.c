@@ -31,7 +31,7 @@
 
 static const stress_help_t help[] = {
 	{ NULL,	"mergesort N",		"start N workers merge sorting 32 bit random integers" },
-	{ NULL,	"mergesort-method M",	"select sort method [ method-libc | method-nonlibc" },
+	{ NULL,	"mergesort-method M",	"select sort method [ mergesort-libc | mergesort-nonlibc | mergesort-mt | netsort | pdqsort | radix-lsd ]" },
 	{ NULL,	"mergesort-ops N",	"stop after N merge sort bogo operations" },
 	{ NULL,	"mergesort-size N",	"number of 32 bit integers to sort" },
 	{ NULL,	NULL,			NULL }
@@ -231,6 +231,22 @@ static int mergesort_nonlibc(
 	return 0;
 }
 
+static stress_sort_func_t mergesort_engine;
+
+/*
+ *  mergesort_engine_sort()
+ *	sort using the selected core sort engine
+ */
+static int mergesort_engine_sort(
+	void *base,
+	size_t nmemb,
+	size_t size,
+	int (*compar)(const void *, const void *))
+{
+	mergesort_engine(base, nmemb, size, compar);
+	return 0;
+}
+
 static const stress_mergesort_method_t stress_mergesort_methods[] = {
 #if (defined(HAVE_LIB_BSD) && 		\
      defined(HAVE_BSD_STDLIB_H)) ||	\
@@ -243,7 +259,9 @@ static const stress_mergesort_method_t stress_mergesort_methods[] = {
 
 static const char *stress_mergesort_method(const size_t i)
 {
-	return (i < SIZEOF_ARRAY(stress_mergesort_methods)) ? stress_mergesort_methods[i].name : NULL;
+	if (i < SIZEOF_ARRAY(stress_mergesort_methods))
+		return stress_mergesort_methods[i].name;
+	return stress_sort_engine_name(i - SIZEOF_ARRAY(stress_mergesort_methods));
 }
 
 static const stress_opt_t opts[] = {
@@ -283,6 +301,7 @@ static int stress_mergesort(stress_args_t *args)
 	CLOBBERED double duration = 0.0;
 	CLOBBERED double count = 0.0;
 	CLOBBERED double sorted = 0.0;
+	CLOBBERED bool sort_compares = true;
 	mergesort_func_t mergesort_func;
 #if !defined(__OpenBSD__) &&	\
     !defined(__NetBSD__) &&	\
@@ -293,10 +312,18 @@ static int stress_mergesort(stress_args_t *args)
 
 	(void)stress_setting_get("mergesort-method", &mergesort_method);
 
-	mergesort_func = stress_mergesort_methods[mergesort_method].mergesort_func;
+	if (mergesort_method < SIZEOF_ARRAY(stress_mergesort_methods)) {
+		mergesort_func = stress_mergesort_methods[mergesort_method].mergesort_func;
+	} else {
+		const stress_sort_engine_t *engine = stress_sort_engine_get(mergesort_method - SIZEOF_ARRAY(stress_mergesort_methods));
+
+		mergesort_engine = engine->sort;
+		mergesort_func = mergesort_engine_sort;
+		sort_compares = engine->compares;
+	}
 	if (stress_instance_zero(args))
 		pr_inf("%s: using method '%s'\n",
-			args->name, stress_mergesort_methods[mergesort_method].name);
+			args->name, stress_mergesort_method(mergesort_method));
 
 	if (!stress_setting_get("mergesort-size", &mergesort_size)) {
 		if (g_opt_flags & OPT_FLAGS_MAXIMIZE)
@@ -347,7 +374,7 @@ static int stress_mergesort(stress_args_t *args)
 	do {
 		double t;
 
-		stress_sort_data_int32_shuffle(data, n);
+		stress_sort_data_int32(data, n, 0);
 
 		stress_sort_compare_reset();
 		t = stress_time_now();
@@ -446,15 +473,21 @@ static int stress_mergesort(stress_args_t *args)
 tidy:
 #endif
 	stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
-	rate = (duration > 0.0) ? count / duration : 0.0;
-	stress_metrics_set(args, "mergesort comparisons per sec",
-		rate, STRESS_METRIC_HARMONIC_MEAN);
-	rate = (sorted > 0.0) ? count / sorted : 0.0;
-	stress_metrics_set(args, "mergesort comparisons per item",
+	/* radix sorts make no comparisons, just report the sort rate */
+	if (sort_compares) {
+		rate = (duration > 0.0) ? count / duration : 0.0;
+		stress_metrics_set(args, "mergesort comparisons per sec",
+			rate, STRESS_METRIC_HARMONIC_MEAN);
+		rate = (sorted > 0.0) ? count / sorted : 0.0;
+		stress_metrics_set(args, "mergesort comparisons per item",
+			rate, STRESS_METRIC_HARMONIC_MEAN);
+
+		pr_dbg("%s: %.2f mergesort comparisons per sec\n", args->name, rate);
+	}
+	rate = (duration > 0.0) ? sorted / duration : 0.0;
+	stress_metrics_set(args, "mergesort elements sorted per sec",
 		rate, STRESS_METRIC_HARMONIC_MEAN);
 
-	pr_dbg("%s: %.2f mergesort comparisons per sec\n", args->name, rate);
-
 	(void)munmap((void *)data, data_size);
 
 	return rc;
@@ -80,7 +80,7 @@
 #define MMAP_RANDOM_MAX_MAXPAGES	(1024)
 #define MMAP_RANDOM_DEFAULT_MAX_PAGES	(8)
 
-#define MWC_RND_ELEMENT(array)		array[stress_mwc8modn(SIZEOF_ARRAY(array))]
+#define MWC_RND_ELEMENT(array)		array[stress_mwc8modn_buffered(SIZEOF_ARRAY(array))]
 
 #define CLONE_STACK_SIZE		(8 * KB)
 
@@ -733,7 +733,7 @@ static void OPTIMIZE3 stress_mmaprandom_mmap_invalid(mr_ctxt_t *ctxt, const int
 static void OPTIMIZE3 stress_mmaprandom_mmap_anon(mr_ctxt_t *ctxt, const int idx)
 {
 	size_t page_size = ctxt->page_size;
-	size_t pages = stress_mwc32modn(ctxt->maxpages) + 1;
+	size_t pages = stress_mwc32modn_buffered(ctxt->maxpages) + 1;
 	size_t size = page_size * pages, i, j;
 	uint8_t *addr;
 	int prot_flag;
@@ -769,7 +769,7 @@ static void OPTIMIZE3 stress_mmaprandom_mmap_anon(mr_ctxt_t *ctxt, const int idx
 		extra_flags |= new_flags;
 	}
 
-	j = stress_mwc8modn(SIZEOF_ARRAY(mmap_extra_flags));
+	j = stress_mwc8modn_buffered(SIZEOF_ARRAY(mmap_extra_flags));
 	for (;;) {
 		int old_flags;
 
@@ -865,8 +865,8 @@ static void OPTIMIZE3 stress_mmaprandom_mmap_file(mr_ctxt_t *ctxt, const int idx
 	const size_t page_size = ctxt->page_size;
 	size_t i;
 	size_t j;
-	const size_t pages = stress_mwc32modn(ctxt->maxpages) + 1;
-	const off_t offset = stress_mwc32modn(ctxt->maxpages) * page_size;
+	const size_t pages = stress_mwc32modn_buffered(ctxt->maxpages) + 1;
+	const off_t offset = stress_mwc32modn_buffered(ctxt->maxpages) * page_size;
 	const size_t size = page_size * pages;
 	uint8_t *addr;
 	int prot_flag;
@@ -879,7 +879,7 @@ static void OPTIMIZE3 stress_mmaprandom_mmap_file(mr_ctxt_t *ctxt, const int idx
 	mmap_flag = MWC_RND_ELEMENT(mmap_file_flags);
 
 	do {
-		i = stress_mwc8modn(SIZEOF_ARRAY(ctxt->fds));
+		i = stress_mwc8modn_buffered(SIZEOF_ARRAY(ctxt->fds));
 		fd = ctxt->fds[i].fd;
 		mode = ctxt->fds[i].mode;
 	} while (fd == -1);
@@ -895,7 +895,7 @@ static void OPTIMIZE3 stress_mmaprandom_mmap_file(mr_ctxt_t *ctxt, const int idx
 		extra_flags |= MWC_RND_ELEMENT(mmap_extra_flags);
 
 	prot_flag = MWC_RND_ELEMENT(prot_flags);
-	j = stress_mwc8modn(SIZEOF_ARRAY(mmap_extra_flags));
+	j = stress_mwc8modn_buffered(SIZEOF_ARRAY(mmap_extra_flags));
 
 	for (;;) {
 		int old_flags;
@@ -1053,7 +1053,7 @@ static void OPTIMIZE3 stress_mmaprandom_munmap_lo_hi_addr(mr_ctxt_t *ctxt, const
 static void OPTIMIZE3 stress_mmaprandom_shm_sysv(mr_ctxt_t *ctxt, const int idx)
 {
 	size_t page_size = ctxt->page_size;
-	size_t pages = stress_mwc32modn(ctxt->maxpages) + 1;
+	size_t pages = stress_mwc32modn_buffered(ctxt->maxpages) + 1;
 	size_t size = page_size * pages;
 	uint8_t *addr;
 	int prot_flag = 0;
@@ -1115,7 +1115,7 @@ static void OPTIMIZE3 stress_mmaprandom_shm_sysv(mr_ctxt_t *ctxt, const int idx)
 static void OPTIMIZE3 stress_mmaprandom_shm_posix(mr_ctxt_t *ctxt, const int idx)
 {
 	size_t page_size = ctxt->page_size;
-	size_t pages = stress_mwc32modn(ctxt->maxpages) + 1;
+	size_t pages = stress_mwc32modn_buffered(ctxt->maxpages) + 1;
 	size_t size = page_size * pages;
 	uint8_t *addr;
 	int prot_flag = PROT_READ;
@@ -1306,7 +1306,7 @@ static void stress_mmaprandom_mremap(mr_ctxt_t *ctxt, const int idx)
 	if (mr_node->flags & MR_NODE_FLAG_SHM)
 		return;
 
-	pages = stress_mwc32modn(ctxt->maxpages) + 1;
+	pages = stress_mwc32modn_buffered(ctxt->maxpages) + 1;
 	new_size = mr_node->mmap_page_size * pages;
 
 	if (new_size > mr_node->mmap_size) {
@@ -1361,7 +1361,7 @@ static void stress_mmaprandom_remap_file_pages(mr_ctxt_t *ctxt, const int idx)
 
 	size = mr_node->mmap_size;
 	pages = size / mr_node->mmap_page_size;
-	pgoff = stress_mwc32modn(ctxt->maxpages);
+	pgoff = stress_mwc32modn_buffered(ctxt->maxpages);
 	offset = (off_t)pgoff * ctxt->page_size;
 
 	stress_mmaprandom_fallocate(ctxt, mr_node->mmap_fd, offset, pages);
@@ -2096,7 +2096,7 @@ static int stress_mmaprandom_child(stress_args_t *args, void *context)
 	ctxt->pidfd = shim_pidfd_open(getpid(), 0);
 
 	do {
-		const int i = (int)stress_mwc8modn(SIZEOF_ARRAY(mr_funcs));
+		const int i = (int)stress_mwc8modn_buffered(SIZEOF_ARRAY(mr_funcs));
 
 		mr_funcs[i].func(ctxt, i);
 		stress_bogo_inc(args);
@@ -33,13 +33,25 @@
 static const stress_help_t help[] = {
 	{ NULL,	"mutex N",		"start N workers exercising mutex operations" },
 	{ NULL, "mutex-affinity",	"change CPU affinity randomly across locks" },
+	{ NULL, "mutex-lock L",		"select lock type, pthread-mutex, ticket, mcs, clh or cohort" },
 	{ NULL,	"mutex-ops N",		"stop after N mutex bogo operations" },
 	{ NULL, "mutex-procs N",	"select the number of concurrent processes" },
 	{ NULL,	NULL,			NULL }
 };
 
+/*
+ *  stress_mutex_lock()
+ *	return name of the i'th lock type, 0 is a pthread mutex,
+ *	otherwise it is a stress-ng core lock method
+ */
+static const char *stress_mutex_lock(const size_t i)
+{
+	return (i == 0) ? "pthread-mutex" : stress_lock_method(i);
+}
+
 static const stress_opt_t opts[] = {
 	{ OPT_mutex_affinity, "mutex-affinity", TYPE_ID_BOOL, 0, 1, NULL },
+	{ OPT_mutex_lock,     "mutex-lock",     TYPE_ID_SIZE_T_METHOD, 0, 0, stress_mutex_lock },
 	{ OPT_mutex_procs,    "mutex-procs",    TYPE_ID_UINT64, MIN_MUTEX_PROCS, MAX_MUTEX_PROCS, NULL },
 	END_OPT,
 };
@@ -68,6 +80,7 @@ static uint32_t n_cpus;
 #endif
 
 static pthread_mutex_t ALIGN64 mutex;
+static void *lock;		/* core lock, NULL = use pthread mutex */
 
 typedef struct {
 	stress_args_t *args;
@@ -78,8 +91,28 @@ typedef struct {
 	int ret;
 	double lock_duration;
 	double lock_count;
+	double hold_duration;
+	uint64_t acquisitions;
 } pthread_info_t;
 
+/*
+ *  stress_mutex_acquire()
+ *	acquire the pthread mutex or core lock
+ */
+static inline int stress_mutex_acquire(void)
+{
+	return lock ? stress_lock_acquire(lock) : pthread_mutex_lock(&mutex);
+}
+
+/*
+ *  stress_mutex_release()
+ *	release the pthread mutex or core lock
+ */
+static inline int stress_mutex_release(void)
+{
+	return lock ? stress_lock_release(lock) : pthread_mutex_unlock(&mutex);
+}
+
 /*
  *  stress_mutex_exercise()
  *	exercise the mutex
@@ -98,6 +131,7 @@ static void OPTIMIZE3 *stress_mutex_exercise(void *arg)
 
 	do {
 		struct sched_param param;
+		double t_held;
 
 		if ((prio_range > 0) && (prio_max > 0)) {
 			param.sched_priority = prio_min + (int)stress_mwc32modn(prio_range);
@@ -109,7 +143,7 @@ static void OPTIMIZE3 *stress_mutex_exercise(void *arg)
 
 		if (LIKELY(metrics_count > 0)) {
 			/* fast non-metrics lock path */
-			if (UNLIKELY(pthread_mutex_lock(&mutex) != 0)) {
+			if (UNLIKELY(stress_mutex_acquire() != 0)) {
 				pr_fail("%s: pthread_mutex_lock failed, errno=%d (%s)\n",
 					args->name, errno, strerror(errno));
 				break;
@@ -119,7 +153,7 @@ static void OPTIMIZE3 *stress_mutex_exercise(void *arg)
 			double t;
 
 			t = stress_time_now();
-			if (LIKELY(pthread_mutex_lock(&mutex) == 0)) {
+			if (LIKELY(stress_mutex_acquire() == 0)) {
 				pthread_info->lock_duration += stress_time_now() - t;
 				pthread_info->lock_count += 1.0;
 			} else {
@@ -128,6 +162,8 @@ static void OPTIMIZE3 *stress_mutex_exercise(void *arg)
 				break;
 			}
 		}
+		t_held = stress_time_now();
+		pthread_info->acquisitions++;
 		metrics_count++;
 		if (UNLIKELY(metrics_count > 1000))
 			metrics_count = 0;
@@ -148,11 +184,12 @@ static void OPTIMIZE3 *stress_mutex_exercise(void *arg)
 		stress_bogo_inc(args);
 		(void)shim_sched_yield();
 
-		if (UNLIKELY(pthread_mutex_unlock(&mutex) != 0)) {
+		if (UNLIKELY(stress_mutex_release() != 0)) {
 			pr_fail("%s: pthread_mutex_unlock failed, errno=%d (%s)\n",
 				args->name, errno, strerror(errno));
 			break;
 		}
+		pthread_info->hold_duration += stress_time_now() - t_held;
 	} while (stress_continue(args));
 
 	return &g_nowt;
@@ -173,7 +210,12 @@ static int stress_mutex(stress_args_t *args)
 	bool mutex_affinity = false;
 	double duration = 0.0;
 	double count = 0.0;
-	double rate;
+	double rate, t_start, t_end;
+	double hold_sum = 0.0, hold_sum_sq = 0.0, fairness;
+	uint64_t acquisitions = 0;
+	size_t mutex_lock = 0, n_pthreads = 0;
+	const char *lock_type;
+	char str[64];
 #if defined(HAVE_PTHREAD_MUTEXATTR)
 	int mutexattr_ret;
 	pthread_mutexattr_t mutexattr;
@@ -183,6 +225,7 @@ static int stress_mutex(stress_args_t *args)
 		return EXIT_NO_RESOURCE;
 
 	(void)stress_setting_get("mutex-affinity", &mutex_affinity);
+	(void)stress_setting_get("mutex-lock", &mutex_lock);
 	if (!stress_setting_get("mutex-procs", &mutex_procs)) {
 		if (g_opt_flags & OPT_FLAGS_MAXIMIZE)
 			mutex_procs = MAX_MUTEX_PROCS;
@@ -220,6 +263,20 @@ static int stress_mutex(stress_args_t *args)
 	}
 #endif
 
+	lock = NULL;
+	if (mutex_lock > 0) {
+		lock = stress_lock_create_method("mutex", mutex_lock);
+		if (!lock) {
+			pr_inf_skip("%s: cannot create %s lock, skipping stressor\n",
+				args->name, stress_mutex_lock(mutex_lock));
+			(void)pthread_mutex_destroy(&mutex);
+			return EXIT_NO_RESOURCE;
+		}
+	}
+	lock_type = stress_mutex_lock(mutex_lock);
+	if (stress_instance_zero(args))
+		pr_dbg("%s: using %s locks\n", args->name, lock_type);
+
 #if defined(HAVE_PTHREAD_SETAFFINITY_NP)
 	n_cpus = stress_affinity_cpus_get(&cpus, true);
 #endif
@@ -231,6 +288,7 @@ static int stress_mutex(stress_args_t *args)
 	for (i = 0; i < mutex_procs; i++)
 		pthread_info[i].ret = -1;
 
+	t_start = stress_time_now();
 	for (i = 0; i < mutex_procs; i++) {
 		pthread_info[i].args = args;
 		pthread_info[i].prio_min = prio_min;
@@ -238,6 +296,8 @@ static int stress_mutex(stress_args_t *args)
 		pthread_info[i].mutex_affinity = mutex_affinity;
 		pthread_info[i].lock_duration = 0.0;
 		pthread_info[i].lock_count = 0.0;
+		pthread_info[i].hold_duration = 0.0;
+		pthread_info[i].acquisitions = 0;
 		pthread_info[i].ret = pthread_create(&pthread_info[i].pthread, NULL,
                                 stress_mutex_exercise, (void *)&pthread_info[i]);
 		if ((pthread_info[i].ret) && (pthread_info[i].ret != EAGAIN)) {
@@ -253,6 +313,9 @@ static int stress_mutex(stress_args_t *args)
 
 	if (!created) {
 		pr_inf("%s: could not create any pthreads\n", args->name);
+		if (lock)
+			(void)stress_lock_destroy(lock);
+		(void)pthread_mutex_destroy(&mutex);
 #if defined(HAVE_PTHREAD_SETAFFINITY_NP)
 		stress_affinity_cpus_free(&cpus);
 #endif
@@ -262,6 +325,7 @@ static int stress_mutex(stress_args_t *args)
 	/* Wait for termination */
 	while (stress_continue(args))
 		(void)shim_pause();
+	t_end = stress_time_now();
 
 	stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
 
@@ -273,13 +337,31 @@ static int stress_mutex(stress_args_t *args)
 
 		duration += pthread_info[i].lock_duration;
 		count += pthread_info[i].lock_count;
+		acquisitions += pthread_info[i].acquisitions;
+
+		hold_sum += pthread_info[i].hold_duration;
+		hold_sum_sq += pthread_info[i].hold_duration * pthread_info[i].hold_duration;
+		n_pthreads++;
 	}
+	if (lock)
+		(void)stress_lock_destroy(lock);
+	lock = NULL;
 	(void)pthread_mutex_destroy(&mutex);
 
 	rate = (count > 0.0) ? (duration / count) : 0.0;
 	stress_metrics_set(args, "nanosecs per mutex",
 		rate * STRESS_DBL_NANOSECOND, STRESS_METRIC_HARMONIC_MEAN);
 
+	rate = (t_end > t_start) ? (double)acquisitions / (t_end - t_start) : 0.0;
+	(void)snprintf(str, sizeof(str), "%s acquisitions per sec", lock_type);
+	stress_metrics_set(args, str, rate, STRESS_METRIC_HARMONIC_MEAN);
+
+	/* Jain's fairness index of hold times, 1.0 = all pthreads equal */
+	fairness = (hold_sum_sq > 0.0) ?
+		(hold_sum * hold_sum) / ((double)n_pthreads * hold_sum_sq) : 0.0;
+	(void)snprintf(str, sizeof(str), "%s hold time fairness", lock_type);
+	stress_metrics_set(args, str, fairness, STRESS_METRIC_GEOMETRIC_MEAN);
+
 #if defined(HAVE_PTHREAD_SETAFFINITY_NP)
 	stress_affinity_cpus_free(&cpus);
 #endif
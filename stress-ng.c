@@ -20,6 +20,7 @@
 #include "stress-ng.h"
 #include "core-affinity.h"
 #include "core-attribute.h"
+#include "core-baseline.h"
 #include "core-bitops.h"
 #include "core-builtin.h"
 #include "core-clocksource.h"
@@ -34,6 +35,7 @@
 #include "core-klog.h"
 #include "core-limit.h"
 #include "core-madvise.h"
+#include "core-metrics-stream.h"
 #include "core-mlock.h"
 #include "core-mmap.h"
 #include "core-numa.h"
@@ -45,6 +47,7 @@
 #include "core-put.h"
 #include "core-rapl.h"
 #include "core-resctrl.h"
+#include "core-sampler.h"
 #include "core-shared-cache.h"
 #include "core-shared-heap.h"
 #include "core-signal.h"
@@ -64,6 +67,10 @@
 
 #include <sys/times.h>
 
+#if defined(HAVE_SYS_PRCTL_H)
+#include <sys/prctl.h>
+#endif
+
 #if defined(HAVE_SYS_UTSNAME_H)
 #include <sys/utsname.h>
 #endif
@@ -79,11 +86,24 @@
 #define DEFAULT_SEQUENTIAL	(0)	/* Disabled */
 #define DEFAULT_PARALLEL	(0)	/* Disabled */
 #define DEFAULT_TIMEOUT		(60 * 60 * 24)
+#define DEFAULT_SCALE_SEARCH_TIMEOUT (10)
 #define DEFAULT_BACKOFF		(0)
+
+#if defined(HAVE_LIB_RT) &&		\
+    defined(HAVE_TIMER_CREATE) &&	\
+    defined(HAVE_TIMER_DELETE) &&	\
+    defined(HAVE_TIMER_SETTIME) &&	\
+    defined(SIGURG)
+#define STRESS_WARMUP
+#endif
+#define FAST_LAUNCH_LAUNCHERS_MAX (64)	/* max --fast-launch launcher processes */
 #define DEFAULT_CACHE_LEVEL     (3)
 
 #define STRESS_REPORT_EXIT_SIGNALED		(1)
 
+#define SCALE_SEARCH_POINTS_MAX		(32)	/* --scale-search curve points */
+#define SCALE_SEARCH_REFINE_MAX		(8)	/* --scale-search refinement steps */
+
 /* stress_stressor_info ignore value. 2 bits */
 #define STRESS_STRESSOR_NOT_IGNORED		(0)
 #define STRESS_STRESSOR_UNSUPPORTED		(1)
@@ -129,17 +149,55 @@ typedef struct stress_feature_tree {
 	const char *name;		/* feature name */
 } stress_feature_tree_t;
 
+/* per stressor metrics sampled at the end of each --repeat run */
+typedef struct stress_repeat {
+	struct stress_repeat *next;	/* next stressor in list */
+	const stress_list_item_t *item;	/* stressor */
+	uint64_t counter_total;		/* bogo-ops total of previous runs */
+	double duration_total;		/* run time total of previous runs */
+	double usr_sys_total;		/* usr+sys time total of previous runs */
+	size_t n_metrics;		/* number of metrics sampled */
+	uint32_t n_samples;		/* number of runs sampled */
+	double *samples;		/* n_metrics x repeats samples */
+} stress_repeat_t;
+
+/* --scale-search instances and aggregate bogo-ops/s curve point */
+typedef struct {
+	int32_t instances;		/* number of instances */
+	double rate;			/* aggregate bogo-ops/s */
+} stress_scale_point_t;
+
+/* --scale-search scaling curve */
+typedef struct {
+	const stress_list_item_t *item;	/* stressor being scaled */
+	int32_t max_instances;		/* user specified number of instances */
+	uint64_t bogo_max_ops;		/* user specified bogo-ops for all instances */
+	size_t n_points;		/* number of points in curve */
+	stress_scale_point_t points[SCALE_SEARCH_POINTS_MAX];
+} stress_scale_search_t;
+
 static stress_stressor_list_t stress_stressor_list;
+static stress_repeat_t *stress_repeat_head;
+static stress_scale_search_t scale_search;
 
 /* Various option settings and flags */
 static pid_t main_pid;				/* stress-ng main pid */
 static bool *sigalarmed = NULL;			/* pointer to stressor stats->sigalarmed */
+static double warmup_rusage_utime = 0.0;	/* user time at end of --warmup */
+static double warmup_rusage_stime = 0.0;	/* system time at end of --warmup */
+#if defined(STRESS_WARMUP)
+static stress_stats_t * volatile warmup_stats = NULL; /* stats of instance in --warmup */
+static int32_t warmup_ticks_per_sec;		/* ticks per sec for --warmup rusage */
+#endif
 static int32_t opt_sequential = DEFAULT_SEQUENTIAL; /* # of sequential stressors */
 static int32_t opt_parallel = DEFAULT_PARALLEL;	/* # of parallel stressors */
 static int32_t opt_permute = DEFAULT_PARALLEL;	/* # of permuted stressors */
 static int32_t ionice_class = UNDEFINED;	/* ionice class */
 static int32_t ionice_level = UNDEFINED;	/* ionice level */
 static uint32_t opt_pause = 0;			/* pause between stressor invocations */
+static uint32_t opt_warmup = 0;			/* --warmup seconds, 0 = no warm-up */
+static uint32_t opt_repeat = 1;			/* number of times to run stressors */
+static double opt_repeat_ci_width = 10.0;	/* --repeat CI width warning threshold, % */
 
 /* Globals */
 stress_list_item_t *g_item_current;		/* current stressor item */
@@ -182,6 +240,8 @@ static const stress_opt_flag_t opt_flags[] = {
 	{ OPT_change_cpu,	OPT_FLAGS_CHANGE_CPU, 0 },
 	{ OPT_dry_run,		OPT_FLAGS_DRY_RUN, 0 },
 	{ OPT_exercised,	OPT_FLAGS_EXERCISED, 0 },
+	{ OPT_fairness,		OPT_FLAGS_FAIRNESS | OPT_FLAGS_METRICS, PR_LOG_FLAGS_METRICS },
+	{ OPT_fast_launch,	OPT_FLAGS_FAST_LAUNCH | OPT_FLAGS_SYNC_START, 0 },
 	{ OPT_ftrace,		OPT_FLAGS_FTRACE, 0 },
 	{ OPT_ignite_cpu,	OPT_FLAGS_IGNITE_CPU, 0 },
 	{ OPT_interrupts,	OPT_FLAGS_INTERRUPTS, 0 },
@@ -190,6 +250,7 @@ static const stress_opt_flag_t opt_flags[] = {
 	{ OPT_keep_name, 	OPT_FLAGS_KEEP_NAME, 0 },
 	{ OPT_klog_check,	OPT_FLAGS_KLOG_CHECK, 0 },
 	{ OPT_ksm,		OPT_FLAGS_KSM, 0 },
+	{ OPT_latency_histogram,	OPT_FLAGS_LATENCY_HISTOGRAM | OPT_FLAGS_METRICS, PR_LOG_FLAGS_METRICS },
 	{ OPT_log_brief,	0, PR_LOG_FLAGS_BRIEF },
 	{ OPT_log_lockless,	0, PR_LOG_FLAGS_LOCKLESS },
 	{ OPT_make_it_fail,	OPT_FLAGS_MAKE_IT_FAIL, 0 },
@@ -207,10 +268,12 @@ static const stress_opt_flag_t opt_flags[] = {
 #if defined(STRESS_PERF_STATS) && 	\
     defined(HAVE_LINUX_PERF_EVENT_H)
 	{ OPT_perf_stats,	OPT_FLAGS_PERF_STATS, 0 },
+	{ OPT_perf_topdown,	OPT_FLAGS_PERF_TOPDOWN, 0 },
 #endif
 	{ OPT_progress,		OPT_FLAGS_PROGRESS, 0 },
 	{ OPT_randprocname,	OPT_FLAGS_RANDPROCNAME, 0 },
 	{ OPT_rapl,		OPT_FLAGS_RAPL | OPT_FLAGS_RAPL_REQUIRED, 0 },
+	{ OPT_scale_search,	OPT_FLAGS_SCALE_SEARCH | OPT_FLAGS_METRICS, PR_LOG_FLAGS_METRICS },
 	{ OPT_sched_reclaim,	OPT_FLAGS_SCHED_RECLAIM, 0 },
 	{ OPT_settings,		OPT_FLAGS_SETTINGS, 0 },
 	{ OPT_skip_silent,	0, PR_LOG_FLAGS_SKIP_SILENT },
@@ -354,6 +417,7 @@ static const stress_help_t help_generic[] = {
 	{ NULL,		"autogroup",		"set /proc/self/autogroup when nice(2) is used" },
 	{ "a N",	"all N",		"start N workers of each stress test" },
 	{ "b N",	"backoff N",		"wait of N microseconds before work starts" },
+	{ NULL,		"baseline file",	"compare metrics against a baseline stress-ng YAML file" },
 	{ NULL,		"buddystat S",		"show Linux buddy allocator info every S seconds" },
 	{ NULL,		"buildinfo",		"show build information" },
 	{ NULL,		"c-states",		"report CPU C-state residencies" },
@@ -367,6 +431,8 @@ static const stress_help_t help_generic[] = {
 	{ NULL,		"exercise-feature list","select stressors by a list of stress features" },
 	{ NULL,		"exercise-library list","select stressors by a list of libraries used" },
 	{ NULL,		"exercise-syscall list","select stressors by a list of system calls heavily used" },
+	{ NULL,		"fairness",		"report per instance bogo-op rate fairness of each stressor" },
+	{ NULL,		"fast-launch",		"fork stressors in parallel and start them together" },
 	{ NULL,		"ftrace",		"enable kernel function call tracing" },
 	{ "h",		"help",			"show help" },
 	{ NULL,		"ignite-cpu",		"alter kernel controls to make CPU run hot" },
@@ -380,9 +446,11 @@ static const stress_help_t help_generic[] = {
 	{ "k",		"keep-name",		"keep stress worker names to be 'stress-ng'" },
 	{ "K",		"klog-check",		"check kernel message log for errors" },
 	{ NULL,		"ksm",			"enable kernel samepage merging" },
+	{ NULL,		"latency-histogram",	"report per stressor bogo-op latency percentiles" },
 	{ NULL,		"limit-as N",		"set size limit on process's address space usage" },
 	{ NULL,		"limit-data N",		"set size limit on process's data segment usage" },
 	{ NULL,		"limit-stack N",	"set size limit on process's stack usage" },
+	{ NULL,		"lock-method M",	"select lock method for stressor shared locks" },
 	{ NULL,		"log-brief",		"less verbose log messages" },
 	{ "L",		"log-file filename",	"log messages to a log file" },
 	{ NULL,		"log-lockless",		"log messages without message locking" },
@@ -392,6 +460,8 @@ static const stress_help_t help_generic[] = {
 	{ NULL,		"mbind",		"set NUMA memory binding to specific nodes" },
 	{ "M",		"metrics",		"print pseudo metrics of activity" },
 	{ NULL,		"metrics-brief",	"enable metrics and only show non-zero results" },
+	{ NULL,		"metrics-interval S",	"sample bogo-op rates every S seconds for --metrics-stream" },
+	{ NULL,		"metrics-stream file",	"stream interval bogo-op rates to CSV or JSON lines file" },
 	{ NULL,		"minimize",		"enable minimal stress options" },
 	{ NULL,		"no-madvise",		"don't use random madvise options for each mmap" },
 	{ NULL,		"no-madvise-opts list",	"specify a list of madvise advice not to use" },
@@ -408,6 +478,8 @@ static const stress_help_t help_generic[] = {
 #if defined(STRESS_PERF_STATS) &&	\
     defined(HAVE_LINUX_PERF_EVENT_H)
 	{ NULL,		"perf",			"display perf statistics" },
+	{ NULL,		"perf-interval N",	"sample IPC, cache and branch miss rates every N milliseconds" },
+	{ NULL,		"perf-topdown",		"report top-down frontend, backend, bad speculation and retiring breakdown" },
 #endif
 	{ NULL,		"permute N",		"run permutations of stressors with N stressors per permutation" },
 	{ NULL,		"progress",		"show run progress" },
@@ -416,7 +488,12 @@ static const stress_help_t help_generic[] = {
 	{ NULL,		"randprocname",		"randomize stressor process name" },
 	{ NULL,		"rapl",			"report RAPL power domain measurements over entire run (Linux x86 only)" },
 	{ NULL,		"raplstat S",		"show RAPL power domain stats every S seconds (Linux x86 only)" },
+	{ NULL,		"regress-threshold N",	"fail --baseline metrics that regress by more than N%" },
+	{ NULL,		"repeat N",		"run the stressors N times and report metrics confidence intervals" },
+	{ NULL,		"repeat-ci-width N",	"warn if --repeat 95% confidence intervals are wider than N% of the mean" },
 	{ NULL,		"resctrl list",		"specify resource control cache partioning" },
+	{ NULL,		"sampler N",		"sample bogo-op counters at N Hz and report window bogo-op rates" },
+	{ NULL,		"scale-search",		"find the peak throughput instance count of a stressor" },
 	{ NULL,		"sched type",		"set scheduler type" },
 	{ NULL,		"sched-prio N",		"set scheduler priority level N" },
 	{ NULL,		"sched-period N",	"set period for SCHED_DEADLINE to N nanosecs (Linux only)" },
@@ -429,6 +506,8 @@ static const stress_help_t help_generic[] = {
 	{ NULL,		"skip-silent",		"silently skip unimplemented stressors" },
 	{ NULL,		"smart",		"show changes in S.M.A.R.T. data" },
 	{ NULL,		"sn",			"use scientific notation for metrics" },
+	{ NULL,		"sort-data D",		"select sort and search stressor input data distribution" },
+	{ NULL,		"stall-detect N",	"report stressor instances with no bogo-op progress for N ms" },
 	{ NULL,		"status S",		"show stress-ng progress status every S seconds" },
 	{ NULL,		"stderr",		"all output to stderr" },
 	{ NULL,		"stdout",		"all output to stdout (now the default)" },
@@ -454,6 +533,7 @@ static const stress_help_t help_generic[] = {
 	{ "V",		"version",		"show version" },
 	{ NULL,		"vmstat S",		"show memory and process statistics every S seconds" },
 	{ NULL,		"vmstat-units U",	"vmstat memory units, one of k | m | g | t | p | e" },
+	{ NULL,		"warmup S",		"exclude the first S seconds of each stressor from the metrics" },
 	{ "w",		"with list",		"specify stressors to run with --all, --seq, --permute" },
 	{ "x",		"exclude list",		"list of stressors to exclude (not run)" },
 	{ "w",		"with list",		"list of stressors to invoke (use with --seq or --all)" },
@@ -1076,6 +1156,7 @@ static const char * PURE stress_exit_status_to_string(const int status)
 		{ EXIT_SIGNALED,		"killed by signal" },
 		{ EXIT_BY_SYS_EXIT,		"stressor terminated using _exit()" },
 		{ EXIT_METRICS_UNTRUSTWORTHY,	"metrics may be untrustworthy" },
+		{ EXIT_BASELINE_REGRESSION,	"metrics regressed against baseline" },
 	};
 	size_t i;
 
@@ -1342,6 +1423,11 @@ static void stress_stressors_wait(
 	int32_t reap_count = 0;
 
 	stress_sync_start_cont_list(s_pids_head);
+	stress_sampler_start(stressors_list);
+#if defined(STRESS_PERF_STATS) &&	\
+    defined(HAVE_LINUX_PERF_EVENT_H)
+	stress_perf_interval_start(stressors_list);
+#endif
 
 #if defined(HAVE_SCHED_GETAFFINITY) &&	\
     NEED_GLIBC(2,3,0)
@@ -1364,6 +1450,11 @@ static void stress_stressors_wait(
 		if (stats)
 			reap_count--;
 	}
+	stress_sampler_stop();
+#if defined(STRESS_PERF_STATS) &&	\
+    defined(HAVE_LINUX_PERF_EVENT_H)
+	stress_perf_interval_stop();
+#endif
 
 	if (g_opt_flags & OPT_FLAGS_IGNITE_CPU)
 		stress_ignite_cpu_stop();
@@ -1569,7 +1660,12 @@ static void stress_rusage_get(const int who, stress_stats_t *stats)
 }
 #endif
 
-static void stress_rusage_stats_get(const int32_t ticks_per_sec, stress_stats_t *stats)
+/*
+ *  stress_rusage_times_get()
+ *	get the user and system times of the stressor instance
+ *	and its children
+ */
+static void stress_rusage_times_get(const int32_t ticks_per_sec, stress_stats_t *stats)
 {
 #if defined(HAVE_GETRUSAGE)
 	(void)ticks_per_sec;
@@ -1591,10 +1687,137 @@ static void stress_rusage_stats_get(const int32_t ticks_per_sec, stress_stats_t
 			(double)(t.tms_stime + t.tms_cstime) / (double)ticks_per_sec;
 	}
 #endif
+}
+
+/*
+ *  stress_rusage_stats_get()
+ *	get the user and system times of the stressor instance,
+ *	excluding the --warmup phase, and accumulate the totals
+ */
+static void stress_rusage_stats_get(const int32_t ticks_per_sec, stress_stats_t *stats)
+{
+	stress_rusage_times_get(ticks_per_sec, stats);
+	stats->rusage_utime -= warmup_rusage_utime;
+	stats->rusage_stime -= warmup_rusage_stime;
 	stats->rusage_utime_total += stats->rusage_utime;
 	stats->rusage_stime_total += stats->rusage_stime;
 }
 
+#if defined(STRESS_WARMUP)
+/*
+ *  stress_warmup_handler()
+ *	end of the --warmup phase, snapshot the bogo-op counter,
+ *	start time and rusage times and restart the perf counters
+ *	so that only the post warm-up deltas are reported
+ */
+static void MLOCKED_TEXT stress_warmup_handler(int signum)
+{
+	const int saved_errno = errno;
+	stress_stats_t *stats = warmup_stats;
+
+	(void)signum;
+
+	if (!stats)
+		return;
+	warmup_stats = NULL;
+
+	stats->args.bogo.count.counter_warmup = stats->args.bogo.count.counter;
+	stats->start = stress_time_now();
+	stress_rusage_times_get(warmup_ticks_per_sec, stats);
+	warmup_rusage_utime = stats->rusage_utime;
+	warmup_rusage_stime = stats->rusage_stime;
+#if defined(STRESS_PERF_STATS) &&	\
+    defined(HAVE_LINUX_PERF_EVENT_H)
+	if (g_opt_flags & (OPT_FLAGS_PERF_STATS | OPT_FLAGS_PERF_TOPDOWN))
+		(void)stress_perf_enable(&stats->sp);
+#endif
+	errno = saved_errno;
+}
+
+/*
+ *  stress_warmup_begin()
+ *	start a --warmup timer for a stressor instance, returns
+ *	true if the timer was started
+ */
+static bool stress_warmup_begin(
+	const char *name,
+	stress_stats_t *stats,
+	const int32_t ticks_per_sec,
+	timer_t *timerid)
+{
+	struct sigevent sev;
+	struct itimerspec timer;
+	struct sigaction action;
+
+	if (!opt_warmup)
+		return false;
+	/*
+	 *  SA_RESTART so the timer does not interrupt blocking
+	 *  system calls in the stressor with EINTR
+	 */
+	(void)shim_memset(&action, 0, sizeof(action));
+	action.sa_handler = stress_warmup_handler;
+	(void)sigemptyset(&action.sa_mask);
+	action.sa_flags = SA_RESTART;
+	if (sigaction(SIGURG, &action, NULL) < 0) {
+		pr_dbg("%s: cannot install warm-up SIGURG handler, errno=%d (%s), "
+			"metrics include the warm-up phase\n",
+			name, errno, strerror(errno));
+		return false;
+	}
+
+	(void)shim_memset(&sev, 0, sizeof(sev));
+	sev.sigev_notify = SIGEV_SIGNAL;
+	sev.sigev_signo = SIGURG;
+	sev.sigev_value.sival_ptr = timerid;
+	if (timer_create(CLOCK_REALTIME, &sev, timerid) < 0) {
+		pr_dbg("%s: cannot create warm-up timer, errno=%d (%s), "
+			"metrics include the warm-up phase\n",
+			name, errno, strerror(errno));
+		return false;
+	}
+	warmup_ticks_per_sec = ticks_per_sec;
+	warmup_stats = stats;
+
+	(void)shim_memset(&timer, 0, sizeof(timer));
+	timer.it_value.tv_sec = (time_t)opt_warmup;
+	if (timer_settime(*timerid, 0, &timer, NULL) < 0) {
+		warmup_stats = NULL;
+		(void)timer_delete(*timerid);
+		return false;
+	}
+	/* latencies and sampler windows are not recorded in the warm-up */
+	stress_latency_warmup(stats->latency, opt_warmup);
+	stats->sampler.t_warmup = stress_time_now() + (double)opt_warmup;
+	return true;
+}
+
+/*
+ *  stress_warmup_end()
+ *	stop the --warmup timer with signals blocked and remove
+ *	the warm-up bogo-ops from the bogo-op counter
+ */
+static void stress_warmup_end(const char *name, stress_args_t *args, timer_t timerid)
+{
+	(void)timer_delete(timerid);
+	if (warmup_stats) {
+		struct sigaction action;
+
+		warmup_stats = NULL;
+		if ((sigaction(SIGURG, NULL, &action) == 0) &&
+		    (action.sa_handler != stress_warmup_handler)) {
+			pr_inf("%s: stressor replaced the warm-up SIGURG handler, "
+				"metrics include the warm-up phase\n", name);
+		} else {
+			pr_dbg("%s: finished before the end of the %" PRIu32 " second warm-up, "
+				"metrics include the warm-up phase\n", name, opt_warmup);
+		}
+		return;
+	}
+	args->bogo.count.counter -= args->bogo.count.counter_warmup;
+}
+#endif
+
 /*
  *  stress_log_time()
  *	log start/end of stressor run, name is stressor, whence is the time and
@@ -1618,6 +1841,24 @@ static void stress_log_time(const char *name, const double whence, const char *t
 	}
 }
 
+/*
+ *  stress_cpu_node_get()
+ *	get CPU and NUMA node the process is currently on,
+ *	node is set to -1 if it cannot be determined
+ */
+static void stress_cpu_node_get(int32_t *cpu, int32_t *node)
+{
+	unsigned int c, n;
+
+	if (shim_getcpu(&c, &n, NULL) < 0) {
+		*cpu = (int32_t)stress_cpu_get();
+		*node = -1;
+		return;
+	}
+	*cpu = (int32_t)c;
+	*node = (int32_t)n;
+}
+
 /*
  *  stress_child_run()
  *	invoke a stressor in a child process
@@ -1639,6 +1880,10 @@ static int MLOCKED_TEXT stress_child_run(
 	double finish = 0.0;
 	double run_duration;
 	stress_args_t *args;
+#if defined(STRESS_WARMUP)
+	timer_t warmup_timerid;
+	bool warmup = false;
+#endif
 
 	sigalarmed = &stats->sigalarmed;
 
@@ -1676,13 +1921,13 @@ static int MLOCKED_TEXT stress_child_run(
 		stress_interrupts_start(stats->interrupts);
 #if defined(STRESS_PERF_STATS) &&	\
     defined(HAVE_LINUX_PERF_EVENT_H)
-	if (g_opt_flags & OPT_FLAGS_PERF_STATS)
+	if (g_opt_flags & (OPT_FLAGS_PERF_STATS | OPT_FLAGS_PERF_TOPDOWN))
 		(void)stress_perf_open(&stats->sp);
 #endif
 	(void)shim_usleep((useconds_t)(backoff * started_instances));
 #if defined(STRESS_PERF_STATS) &&	\
     defined(HAVE_LINUX_PERF_EVENT_H)
-	if (g_opt_flags & OPT_FLAGS_PERF_STATS)
+	if (g_opt_flags & (OPT_FLAGS_PERF_STATS | OPT_FLAGS_PERF_TOPDOWN))
 		(void)stress_perf_enable(&stats->sp);
 #endif
 	stress_yield_sleep_ms();
@@ -1697,6 +1942,7 @@ static int MLOCKED_TEXT stress_child_run(
 		args->bogo.max_ops = g_item_current->bogo_max_ops ?
 			g_item_current->bogo_max_ops : NEVER_END_OPS;
 		args->bogo.count.counter = 0;
+		args->bogo.count.counter_warmup = 0;
 		args->bogo.possibly_oom_killed = false;
 		args->name = name;
 		args->instance = (uint32_t)instance;
@@ -1713,6 +1959,8 @@ static int MLOCKED_TEXT stress_child_run(
 		stress_set_oom_adjustment(args, false);
 
 		(void)shim_memset(*checksum, 0, sizeof(**checksum));
+		stress_latency_reset(stats->latency);
+		stats->sampler.t_warmup = 0.0;
 		stats->start = stress_time_now();
 #if defined(STRESS_RAPL)
 		if (g_opt_flags & OPT_FLAGS_RAPL)
@@ -1723,10 +1971,21 @@ static int MLOCKED_TEXT stress_child_run(
 
 		(void)stress_resctrl_set(name, instance, child_pid);
 
+		if (g_opt_flags & OPT_FLAGS_FAIRNESS)
+			stress_cpu_node_get(&stats->cpu_start, &stats->numa_node);
+#if defined(STRESS_WARMUP)
+		warmup = stress_warmup_begin(name, stats, ticks_per_sec, &warmup_timerid);
+#endif
 		rc = info->stressor(args);
+		if (g_opt_flags & OPT_FLAGS_FAIRNESS)
+			stress_cpu_node_get(&stats->cpu_end, &stats->numa_node);
 		stress_sync_state_store(&stats->s_pid, STRESS_SYNC_START_FLAG_FINISHED);
 		stress_signals_block();
 		(void)alarm(0);
+#if defined(STRESS_WARMUP)
+		if (warmup)
+			stress_warmup_end(name, args, warmup_timerid);
+#endif
 		if (g_opt_flags & OPT_FLAGS_INTERRUPTS) {
 			stress_interrupts_stop(stats->interrupts);
 			stress_interrupts_check_failure(name, stats->interrupts, instance, &rc);
@@ -1787,7 +2046,7 @@ static int MLOCKED_TEXT stress_child_run(
 	}
 #if defined(STRESS_PERF_STATS) &&	\
     defined(HAVE_LINUX_PERF_EVENT_H)
-	if (g_opt_flags & OPT_FLAGS_PERF_STATS) {
+	if (g_opt_flags & (OPT_FLAGS_PERF_STATS | OPT_FLAGS_PERF_TOPDOWN)) {
 		(void)stress_perf_disable(&stats->sp);
 		(void)stress_perf_close(&stats->sp);
 	}
@@ -1837,6 +2096,309 @@ child_exit:
 	return rc;
 }
 
+/*
+ *  stress_run_instance()
+ *	run a stressor instance in a newly forked child
+ */
+static void NORETURN MLOCKED_TEXT stress_run_instance(
+	stress_checksum_t **checksum,
+	stress_stats_t *const stats,
+	const double fork_time_start,
+	const int64_t backoff,
+	const int32_t ticks_per_sec,
+	const int32_t instance,
+	const int32_t started_instances,
+	const size_t page_size)
+{
+	pid_t child_pid;
+	int rc;
+
+	stress_proc_state_set(g_item_current->stressor->name, STRESS_STATE_INIT);
+	child_pid = getpid();
+	stats->s_pid.reaped = false;
+	stats->s_pid.pid = child_pid;
+	if (g_opt_flags & OPT_FLAGS_C_STATES)
+		stress_cpuidle_read_cstates_begin(&stats->cstates);
+	if (g_opt_flags & OPT_FLAGS_IOS)
+		stress_fs_io_stats_begin(&stats->io_stats);
+
+	stress_make_it_fail_set();
+
+	rc = stress_child_run(checksum,
+			stats, fork_time_start,
+			backoff, ticks_per_sec,
+			instance, started_instances,
+			page_size, child_pid);
+	if (g_opt_flags & OPT_FLAGS_C_STATES)
+		stress_cpuidle_read_cstates_end(&stats->cstates);
+	if (g_opt_flags & OPT_FLAGS_IOS)
+		stress_fs_io_stats_end(&stats->io_stats);
+	_exit(rc);
+}
+
+#if defined(HAVE_PRCTL) &&		\
+    defined(HAVE_SYS_PRCTL_H) &&	\
+    defined(PR_SET_CHILD_SUBREAPER)
+/* --fast-launch stressor instance to be forked */
+typedef struct {
+	stress_list_item_t *item;	/* stressor */
+	stress_stats_t *stats;		/* instance stats */
+	stress_checksum_t *checksum;	/* instance checksum */
+	int32_t instance;		/* stressor instance number */
+} stress_launch_t;
+
+/*
+ *  stress_run_stats_prefault()
+ *	populate the page table entries of the shared stats of
+ *	an instance so that the first writes to the stats when
+ *	the stressor is running do not page fault
+ */
+static void stress_run_stats_prefault(stress_stats_t *stats, const size_t page_size)
+{
+	const uintptr_t begin = (uintptr_t)stats & ~(page_size - 1);
+	const uintptr_t end = ((uintptr_t)(stats + 1) + page_size - 1) & ~(page_size - 1);
+
+#if defined(MADV_POPULATE_WRITE)
+	if (shim_madvise((void *)begin, (size_t)(end - begin), MADV_POPULATE_WRITE) == 0)
+		return;
+#endif
+	stress_mmap_populate_forward((void *)begin, (size_t)(end - begin), PROT_READ);
+}
+
+/*
+ *  stress_run_fast_launcher()
+ *	fork every step'th instance starting from instance first,
+ *	each child waits until it has been re-parented to the main
+ *	stress-ng process before it runs the stressor so that it
+ *	can be waited for and parent death signals work as normal.
+ *	Returns EXIT_FAILURE if a fork failed, EXIT_SUCCESS otherwise
+ */
+static int stress_run_fast_launcher(
+	stress_launch_t *launch,
+	const size_t n,
+	const size_t first,
+	const size_t step,
+	const int64_t backoff,
+	const int32_t ticks_per_sec,
+	const size_t page_size,
+	const pid_t parent_pid,
+	const double time_start)
+{
+	size_t k;
+
+#if !defined(STRESS_TERMINATE_PREMATURELY)
+	(void)time_start;
+#endif
+
+	for (k = first; k < n; k += step) {
+		stress_launch_t *l = &launch[k];
+		double fork_time_start;
+		pid_t pid;
+
+#if defined(STRESS_TERMINATE_PREMATURELY)
+		if (g_opt_timeout && (stress_time_now() - time_start > (double)g_opt_timeout))
+			break;
+#endif
+again:
+		if (!stress_continue_flag())
+			break;
+		g_item_current = l->item;
+		fork_time_start = stress_time_now();
+		pid = fork();
+		if (pid < 0) {
+			if (errno == EAGAIN) {
+				(void)shim_usleep(100000);
+				goto again;
+			}
+			pr_err("cannot fork, errno=%d (%s)\n",
+				errno, strerror(errno));
+			return EXIT_FAILURE;
+		} else if (pid == 0) {
+			stress_checksum_t *checksum = l->checksum;
+
+			while (getppid() != parent_pid) {
+				/* main stress-ng process has gone */
+				if (getppid() == 1)
+					_exit(EXIT_FAILURE);
+				(void)shim_usleep(1000);
+			}
+			stress_run_stats_prefault(l->stats, page_size);
+			stress_run_instance(&checksum, l->stats, fork_time_start,
+				backoff, ticks_per_sec, l->instance, (int32_t)k, page_size);
+		}
+		l->stats->s_pid.pid = pid;
+	}
+	return EXIT_SUCCESS;
+}
+
+/*
+ *  stress_run_fast_launch()
+ *	--fast-launch, fork the stressor instances in parallel from
+ *	launcher processes, one per online CPU. The main process is
+ *	made a child subreaper so the instances are re-parented to it
+ *	when the launchers exit. The instances are then released
+ *	together by the --sync-start barrier. Returns -1 if the
+ *	stressors need to be started the normal way, 1 if a
+ *	stressor could not be forked and 0 if all were forked.
+ */
+static int stress_run_fast_launch(
+	stress_list_item_t *stressors_list,
+	stress_checksum_t **checksum,
+	const int64_t backoff,
+	const int32_t ticks_per_sec,
+	const size_t page_size,
+	stress_pid_t **s_pids_head,
+	int32_t *started_instances,
+	const double time_start)
+{
+	const pid_t parent_pid = getpid();
+	stress_list_item_t *item;
+	stress_launch_t *launch;
+	stress_checksum_t *cs = *checksum;
+	pid_t *launchers;
+	size_t n = 0, k, l, n_launchers;
+	int32_t cpus;
+	bool fork_failed = false;
+
+	if (g_opt_flags & OPT_FLAGS_DRY_RUN)
+		return -1;
+
+	for (item = stressors_list; item; item = item->next) {
+		if (!item->ignore.run && !item->ignore.permute)
+			n += (size_t)item->instances;
+	}
+	if (n == 0)
+		return -1;
+
+	cpus = stress_cpus_online_get();
+	n_launchers = (cpus > 1) ? (size_t)cpus : 1;
+	if (n_launchers > FAST_LAUNCH_LAUNCHERS_MAX)
+		n_launchers = FAST_LAUNCH_LAUNCHERS_MAX;
+	if (n_launchers > n)
+		n_launchers = n;
+
+	launch = (stress_launch_t *)calloc(n, sizeof(*launch));
+	launchers = (pid_t *)calloc(n_launchers, sizeof(*launchers));
+	if (!launch || !launchers) {
+		pr_inf("fast-launch: cannot allocate launch data, starting stressors one at a time\n");
+		free(launchers);
+		free(launch);
+		return -1;
+	}
+	if (prctl(PR_SET_CHILD_SUBREAPER, 1) < 0) {
+		pr_inf("fast-launch: cannot set child subreaper, errno=%d (%s), "
+			"starting stressors one at a time\n", errno, strerror(errno));
+		free(launchers);
+		free(launch);
+		return -1;
+	}
+
+	stress_memory_compact();
+
+	for (n = 0, item = stressors_list; item; item = item->next) {
+		int32_t j;
+
+		if (item->ignore.run || item->ignore.permute) {
+			cs += item->instances;
+			continue;
+		}
+		for (j = 0; j < item->instances; j++, cs++, n++) {
+			stress_stats_t *const stats = item->stats[j];
+
+			stress_sync_start_init(&stats->s_pid);
+			stats->args.bogo.count.counter_ready = true;
+			stats->args.bogo.count.counter = 0;
+			stats->checksum = cs;
+			stats->item = item;
+			stats->s_pid.reaped = false;
+			stats->s_pid.wait_status = 0;
+			stats->cpu_start = -1;
+			stats->cpu_end = -1;
+			stats->numa_node = -1;
+
+			launch[n].item = item;
+			launch[n].stats = stats;
+			launch[n].checksum = cs;
+			launch[n].instance = j;
+		}
+	}
+	*checksum = cs;
+
+	for (l = 0; l < n_launchers; l++) {
+		launchers[l] = fork();
+		if (launchers[l] == 0) {
+			_exit(stress_run_fast_launcher(launch, n, l, n_launchers,
+				backoff, ticks_per_sec, page_size, parent_pid, time_start));
+		} else if (launchers[l] < 0) {
+			/* no launcher, fork this share of instances directly */
+			if (stress_run_fast_launcher(launch, n, l, n_launchers,
+					backoff, ticks_per_sec, page_size, parent_pid,
+					time_start) != EXIT_SUCCESS)
+				fork_failed = true;
+		}
+	}
+	for (l = 0; l < n_launchers; l++) {
+		int status = 0;
+
+		if (launchers[l] <= 0)
+			continue;
+		while ((waitpid(launchers[l], &status, 0) < 0) && (errno == EINTR))
+			;
+		if (!WIFEXITED(status) || (WEXITSTATUS(status) != EXIT_SUCCESS))
+			fork_failed = true;
+	}
+	(void)prctl(PR_SET_CHILD_SUBREAPER, 0);
+
+	for (k = 0; k < n; k++) {
+		stress_stats_t *const stats = launch[k].stats;
+
+		if (stats->s_pid.pid > 0) {
+			stats->s_pid.reaped = false;
+			stats->signalled = false;
+			(*started_instances)++;
+			stress_sync_start_s_pid_list_add(s_pids_head, &stats->s_pid);
+			stress_stats_hash_table_add(stats);
+		} else {
+			stats->s_pid.reaped = true;
+		}
+	}
+	pr_dbg("fast-launch: %zu instance%s forked by %zu launcher%s\n",
+		n, n == 1 ? "" : "s", n_launchers, n_launchers == 1 ? "" : "s");
+	free(launchers);
+	free(launch);
+
+	return fork_failed ? 1 : 0;
+}
+#else
+static int stress_run_fast_launch(
+	stress_list_item_t *stressors_list,
+	stress_checksum_t **checksum,
+	const int64_t backoff,
+	const int32_t ticks_per_sec,
+	const size_t page_size,
+	stress_pid_t **s_pids_head,
+	int32_t *started_instances,
+	const double time_start)
+{
+	static bool warned = false;
+
+	(void)stressors_list;
+	(void)checksum;
+	(void)backoff;
+	(void)ticks_per_sec;
+	(void)page_size;
+	(void)s_pids_head;
+	(void)started_instances;
+	(void)time_start;
+
+	if (!warned) {
+		pr_inf("fast-launch: not supported on this system, starting stressors one at a time\n");
+		warned = true;
+	}
+	return -1;
+}
+#endif
+
 /*
  *  stress_run()
  *	kick off and run stressors
@@ -1876,6 +2438,31 @@ static void MLOCKED_TEXT stress_run(
 	}
 	pr_dbg("starting stressor%s\n", n_stressors > 1 ? "s" : "");
 
+	if (g_opt_flags & OPT_FLAGS_FAST_LAUNCH) {
+		switch (stress_run_fast_launch(stressors_list, checksum, backoff, ticks_per_sec,
+					       page_size, &s_pids_head, &started_instances, time_start)) {
+		case 0:
+			/* Forced early abort during startup? */
+			if (!stress_continue_flag()) {
+				pr_dbg("abort signal during startup, cleaning up\n");
+				stress_stressors_kill(SIGALRM, true);
+				goto wait_for_stressors;
+			}
+			goto launched;
+		case 1:
+			/*
+			 *  a stressor could not be forked, instances killed
+			 *  before they reach the --sync-start barrier never
+			 *  get ready, so stop waiting for them too
+			 */
+			stress_continue_set_flag(false);
+			stress_stressors_kill(SIGALRM, false);
+			goto wait_for_stressors;
+		default:
+			break;
+		}
+	}
+
 	/*
 	 *  Work through the list of stressors to run
 	 */
@@ -1893,8 +2480,6 @@ static void MLOCKED_TEXT stress_run(
 		for (j = 0; j < g_item_current->instances; j++, (*checksum)++) {
 			double fork_time_start;
 			pid_t pid;
-			pid_t child_pid;
-			int rc;
 			stress_stats_t *const stats = g_item_current->stats[j];
 
 #if defined(STRESS_TERMINATE_PREMATURELY)
@@ -1908,6 +2493,9 @@ static void MLOCKED_TEXT stress_run(
 			stats->item = g_item_current;
 			stats->s_pid.reaped = false;
 			stats->s_pid.wait_status = 0;
+			stats->cpu_start = -1;
+			stats->cpu_end = -1;
+			stats->numa_node = -1;
 
 			if (g_opt_flags & OPT_FLAGS_DRY_RUN) {
 				stats->s_pid.reaped = true;
@@ -1935,27 +2523,8 @@ again:
 				goto wait_for_stressors;
 			case 0:
 				/* Child */
-				stress_proc_state_set(g_item_current->stressor->name, STRESS_STATE_INIT);
-				child_pid = getpid();
-				stats->s_pid.reaped = false;
-				stats->s_pid.pid = child_pid;
-				if (g_opt_flags & OPT_FLAGS_C_STATES)
-					stress_cpuidle_read_cstates_begin(&stats->cstates);
-				if (g_opt_flags & OPT_FLAGS_IOS)
-					stress_fs_io_stats_begin(&stats->io_stats);
-
-				stress_make_it_fail_set();
-
-				rc = stress_child_run(checksum,
-						stats, fork_time_start,
-						backoff, ticks_per_sec,
-						j, started_instances,
-						page_size, child_pid);
-				if (g_opt_flags & OPT_FLAGS_C_STATES)
-					stress_cpuidle_read_cstates_end(&stats->cstates);
-				if (g_opt_flags & OPT_FLAGS_IOS)
-					stress_fs_io_stats_end(&stats->io_stats);
-				_exit(rc);
+				stress_run_instance(checksum, stats, fork_time_start,
+					backoff, ticks_per_sec, j, started_instances, page_size);
 			default:
 				if (pid > -1) {
 					stats->s_pid.pid = pid;
@@ -1982,6 +2551,7 @@ again:
 			(void)stress_child_wait(WNOHANG, success, resource_success, metrics_success);
 		}
 	}
+launched:
 	if (!handler_set) {
 		(void)stress_handler_set("stress-ng", false);
 		handler_set = true;
@@ -2387,6 +2957,41 @@ static void stress_exercise_dump(FILE *yaml)
 	pr_block_end();
 }
 
+/*
+ *  stress_latency_metrics_dump()
+ *	output per stressor bogo-op latency percentiles
+ */
+static void stress_latency_metrics_dump(void)
+{
+	stress_list_item_t *item;
+	bool header = false;
+
+	for (item = stress_stressor_list.head; item; item = item->next) {
+		stress_latency_percentiles_t lp;
+
+		if (item->ignore.run || item->ignore.permute)
+			continue;
+		if (!stress_latency_percentiles(item, &lp))
+			continue;
+
+		if (!header) {
+			pr_metrics("bogo-op latency (nanoseconds):\n");
+			pr_metrics("%-13s %12s %12s %12s %12s %12s %12s\n",
+				"stressor", "bogo ops", "p50", "p90", "p99", "p99.9", "max");
+			header = true;
+		}
+		if (g_opt_flags & OPT_FLAGS_SN) {
+			pr_metrics("%-13s %12" PRIu64 " %12.4e %12.4e %12.4e %12.4e %12.4e\n",
+				item->stressor->name, lp.count,
+				lp.p50, lp.p90, lp.p99, lp.p99_9, lp.max);
+		} else {
+			pr_metrics("%-13s %12" PRIu64 " %12.0f %12.0f %12.0f %12.0f %12.0f\n",
+				item->stressor->name, lp.count,
+				lp.p50, lp.p90, lp.p99, lp.p99_9, lp.max);
+		}
+	}
+}
+
 /*
  *  stress_metrics_dump()
  *	output metrics
@@ -2550,6 +3155,39 @@ static void stress_metrics_dump(FILE *yaml)
 			pr_yaml(yaml, "      cpu-usage-per-instance: %f\n", cpu_usage);
 			pr_yaml(yaml, "      max-rss: %ld\n", maxrss);
 		}
+		stress_baseline_metric(name, "bogo-ops", (double)c_total);
+		stress_baseline_metric(name, "bogo-ops-per-second-usr-sys-time", bogo_rate);
+		stress_baseline_metric(name, "bogo-ops-per-second-real-time", bogo_rate_r_time);
+		stress_baseline_metric(name, "wall-clock-time", r_total);
+		stress_baseline_metric(name, "user-time", u_time);
+		stress_baseline_metric(name, "system-time", s_time);
+		stress_baseline_metric(name, "cpu-usage-per-instance", cpu_usage);
+		stress_baseline_metric(name, "max-rss", (double)maxrss);
+
+		if (g_opt_flags & OPT_FLAGS_LATENCY_HISTOGRAM) {
+			stress_latency_percentiles_t lp;
+
+			if (stress_latency_percentiles(item, &lp)) {
+				if (g_opt_flags & OPT_FLAGS_SN) {
+					pr_yaml(yaml, "      latency-p50-nsec: %e\n", lp.p50);
+					pr_yaml(yaml, "      latency-p90-nsec: %e\n", lp.p90);
+					pr_yaml(yaml, "      latency-p99-nsec: %e\n", lp.p99);
+					pr_yaml(yaml, "      latency-p99.9-nsec: %e\n", lp.p99_9);
+					pr_yaml(yaml, "      latency-max-nsec: %e\n", lp.max);
+				} else {
+					pr_yaml(yaml, "      latency-p50-nsec: %.0f\n", lp.p50);
+					pr_yaml(yaml, "      latency-p90-nsec: %.0f\n", lp.p90);
+					pr_yaml(yaml, "      latency-p99-nsec: %.0f\n", lp.p99);
+					pr_yaml(yaml, "      latency-p99.9-nsec: %.0f\n", lp.p99_9);
+					pr_yaml(yaml, "      latency-max-nsec: %.0f\n", lp.max);
+				}
+				stress_baseline_metric(name, "latency-p50-nsec", lp.p50);
+				stress_baseline_metric(name, "latency-p90-nsec", lp.p90);
+				stress_baseline_metric(name, "latency-p99-nsec", lp.p99);
+				stress_baseline_metric(name, "latency-p99.9-nsec", lp.p99_9);
+				stress_baseline_metric(name, "latency-max-nsec", lp.max);
+			}
+		}
 
 		mi = item->metrics_info;
 		for (i = 0; i < mi->num_metrics_items; i++) {
@@ -2567,6 +3205,7 @@ static void stress_metrics_dump(FILE *yaml)
 			} else {
 				pr_yaml(yaml, "      %s: %f\n", stress_description_yamlify(description), metric);
 			}
+			stress_baseline_metric(name, stress_description_yamlify(description), metric);
 		}
 
 		/*
@@ -2755,6 +3394,8 @@ static void stress_metrics_dump(FILE *yaml)
 			}
 		}
 	}
+	if (g_opt_flags & OPT_FLAGS_LATENCY_HISTOGRAM)
+		stress_latency_metrics_dump();
 	pr_block_end();
 }
 
@@ -2811,27 +3452,411 @@ static void stress_ios_dump(FILE *yaml)
 }
 
 /*
- *  stress_times_dump()
- *	output the run times
+ *  stress_fairness_dump()
+ *	output per instance bogo-op rates and fairness metrics,
+ *	coefficient of variation, min/max ratio and Jain's
+ *	fairness index, of all the instances of each stressor
  */
-static void stress_times_dump(
-	FILE *yaml,
-	const int32_t ticks_per_sec,
-	const double duration)
+static void stress_fairness_dump(FILE *yaml)
 {
-	stress_load_average_info_t load_average_info;
-	struct tms buf;
-	double total_cpu_time = stress_cpus_configured_get() * duration;
-	double u_time;
-	double s_time;
-	double t_time;
-	double u_pc;
-	double s_pc;
-	double t_pc;
-	int rc;
-
-	if (!(g_opt_flags & OPT_FLAGS_TIMES))
-		return;
+	stress_list_item_t *item;
+	bool pr_heading = false;
+
+	pr_block_begin();
+	for (item = stress_stressor_list.head; item; item = item->next) {
+		int32_t i;
+		double sum = 0.0, sum_sq = 0.0;
+		double rate_min = DBL_MAX, rate_max = 0.0;
+		double mean, stddev, cv, ratio, jain;
+		int32_t n = 0;
+
+		if (item->ignore.run || item->ignore.permute)
+			continue;
+		if (!item->stats)
+			continue;
+
+		for (i = 0; i < item->instances; i++) {
+			const stress_stats_t *const stats = item->stats[i];
+			double rate;
+
+			if (!stats->completed || (stats->duration_total <= 0.0))
+				continue;
+			rate = (double)stats->counter_total / stats->duration_total;
+			sum += rate;
+			sum_sq += rate * rate;
+			if (rate_min > rate)
+				rate_min = rate;
+			if (rate_max < rate)
+				rate_max = rate;
+			n++;
+		}
+		if (n == 0)
+			continue;
+
+		mean = sum / (double)n;
+		stddev = sqrt(STRESS_MAXIMUM(0.0, (sum_sq / (double)n) - (mean * mean)));
+		cv = (mean > 0.0) ? stddev / mean : 0.0;
+		ratio = (rate_max > 0.0) ? rate_min / rate_max : 0.0;
+		jain = (sum_sq > 0.0) ? (sum * sum) / ((double)n * sum_sq) : 0.0;
+
+		if (!pr_heading) {
+			pr_metrics("fairness of per instance bogo-ops/s (real time):\n");
+			pr_metrics("%-13s %9s %12s %12s %12s %8s %9s %9s\n",
+				"stressor", "instances", "min", "mean", "max",
+				"CV", "min/max", "Jain's");
+			pr_yaml(yaml, "fairness:\n");
+			pr_heading = true;
+		}
+		pr_metrics("%-13s %9" PRId32 " %12.2f %12.2f %12.2f %8.4f %9.4f %9.4f\n",
+			item->stressor->name, n, rate_min, mean, rate_max, cv, ratio, jain);
+
+		pr_yaml(yaml, "    - stressor: %s\n", item->stressor->name);
+		pr_yaml(yaml, "      bogo-ops-per-second-min: %f\n", rate_min);
+		pr_yaml(yaml, "      bogo-ops-per-second-mean: %f\n", mean);
+		pr_yaml(yaml, "      bogo-ops-per-second-max: %f\n", rate_max);
+		pr_yaml(yaml, "      coefficient-of-variation: %f\n", cv);
+		pr_yaml(yaml, "      min-max-ratio: %f\n", ratio);
+		pr_yaml(yaml, "      jains-fairness-index: %f\n", jain);
+		pr_yaml(yaml, "      instances:\n");
+		for (i = 0; i < item->instances; i++) {
+			const stress_stats_t *const stats = item->stats[i];
+
+			if (!stats->completed || (stats->duration_total <= 0.0))
+				continue;
+			pr_yaml(yaml, "          - instance: %" PRId32 "\n", i);
+			pr_yaml(yaml, "            bogo-ops-per-second: %f\n",
+				(double)stats->counter_total / stats->duration_total);
+			pr_yaml(yaml, "            cpu-start: %" PRId32 "\n", stats->cpu_start);
+			pr_yaml(yaml, "            cpu-end: %" PRId32 "\n", stats->cpu_end);
+			pr_yaml(yaml, "            numa-node: %" PRId32 "\n", stats->numa_node);
+		}
+		pr_yaml(yaml, "\n");
+	}
+	pr_block_end();
+}
+
+/*
+ *  stress_repeat_n_metrics()
+ *	number of sampled metrics of a stressor, bounded by the
+ *	number of sample slots allocated for it
+ */
+static size_t stress_repeat_n_metrics(const stress_repeat_t *r)
+{
+	const size_t n = 2 + r->item->metrics_info->num_metrics_items;
+
+	return (n < r->n_metrics) ? n : r->n_metrics;
+}
+
+/*
+ *  stress_repeat_sample()
+ *	sample the per stressor bogo-op rates and miscellaneous
+ *	metrics of the run that just completed. The stats totals
+ *	accumulate over all the runs, so the metrics of a run are
+ *	derived from the change in the totals since the previous run
+ */
+static void stress_repeat_sample(void)
+{
+	stress_list_item_t *item;
+
+	for (item = stress_stressor_list.head; item; item = item->next) {
+		stress_repeat_t *r, **tail;
+		uint64_t counter_total = 0, counter;
+		double duration_total = 0.0, usr_sys_total = 0.0;
+		double duration, usr_sys, r_time;
+		int32_t j, completed = 0;
+		size_t i, idx;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+
+		for (tail = &stress_repeat_head, r = stress_repeat_head; r; tail = &r->next, r = r->next) {
+			if (r->item == item)
+				break;
+		}
+		if (!r) {
+			r = (stress_repeat_t *)calloc(1, sizeof(*r));
+			if (!r) {
+				pr_inf("repeat: cannot allocate %s metrics, skipping\n",
+					item->stressor->name);
+				continue;
+			}
+			/*
+			 *  stressors register metrics lazily, so size for the
+			 *  maximum number of metrics rather than the number
+			 *  registered so far
+			 */
+			r->n_metrics = 2 + item->metrics_info->max_metrics_items;
+			r->samples = (double *)calloc(r->n_metrics * opt_repeat, sizeof(*r->samples));
+			if (!r->samples) {
+				pr_inf("repeat: cannot allocate %s metrics, skipping\n",
+					item->stressor->name);
+				free(r);
+				continue;
+			}
+			r->item = item;
+			*tail = r;
+		}
+
+		for (j = 0; j < item->instances; j++) {
+			const stress_stats_t *const stats = item->stats[j];
+
+			counter_total += stats->counter_total;
+			duration_total += stats->duration_total;
+			usr_sys_total += stats->rusage_utime_total + stats->rusage_stime_total;
+			if (stats->completed)
+				completed++;
+		}
+		counter = counter_total - r->counter_total;
+		duration = duration_total - r->duration_total;
+		usr_sys = usr_sys_total - r->usr_sys_total;
+		r->counter_total = counter_total;
+		r->duration_total = duration_total;
+		r->usr_sys_total = usr_sys_total;
+
+		if ((completed == 0) || (duration <= 0.0) || (r->n_samples >= opt_repeat))
+			continue;
+
+		/* Real time in terms of average wall clock time of all procs */
+		r_time = duration / (double)completed;
+		idx = r->n_samples;
+		r->samples[idx] = (double)counter / r_time;
+		r->samples[opt_repeat + idx] = (usr_sys > 0.0) ? (double)counter / usr_sys : 0.0;
+		for (i = 0; i < stress_repeat_n_metrics(r) - 2; i++) {
+			double total = 0.0;
+
+			for (j = 0; j < item->instances; j++)
+				total += item->stats[j]->metrics_values[i];
+			r->samples[((i + 2) * opt_repeat) + idx] = total / (double)completed;
+		}
+		r->n_samples++;
+	}
+}
+
+/*
+ *  stress_repeat_reset()
+ *	clear the per instance completion state before a repeated
+ *	run so a run does not inherit the state of the previous run
+ */
+static void stress_repeat_reset(void)
+{
+	stress_list_item_t *item;
+
+	for (item = stress_stressor_list.head; item; item = item->next) {
+		int32_t j;
+
+		if (item->ignore.run || !item->stats)
+			continue;
+		for (j = 0; j < item->instances; j++)
+			item->stats[j]->completed = false;
+	}
+}
+
+/*
+ *  stress_repeat_stats()
+ *	compute mean, sample standard deviation and 95% confidence
+ *	interval half width of n samples using Student's t distribution
+ */
+static void stress_repeat_stats(
+	const double *samples,
+	const uint32_t n,
+	double *mean,
+	double *stddev,
+	double *ci_half)
+{
+	/* two-tailed 95% t critical values for 1..30 degrees of freedom */
+	static const double t_95[] = {
+		12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+		2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+		2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042,
+	};
+	double sum = 0.0, sum_sq = 0.0, t;
+	uint32_t i;
+
+	for (i = 0; i < n; i++)
+		sum += samples[i];
+	*mean = sum / (double)n;
+	for (i = 0; i < n; i++) {
+		const double d = samples[i] - *mean;
+
+		sum_sq += d * d;
+	}
+	*stddev = sqrt(sum_sq / (double)(n - 1));
+	t = ((n - 1) <= SIZEOF_ARRAY(t_95)) ? t_95[n - 2] : 1.960;
+	*ci_half = t * *stddev / sqrt((double)n);
+}
+
+/*
+ *  stress_repeat_metric_name()
+ *	YAML name of the nth sampled metric of a stressor
+ */
+static const char *stress_repeat_metric_name(const stress_repeat_t *r, const size_t m)
+{
+	switch (m) {
+	case 0:
+		return "bogo-ops-per-second-real-time";
+	case 1:
+		return "bogo-ops-per-second-usr-sys-time";
+	default:
+		return stress_description_yamlify(r->item->metrics_info->metrics_desc[m - 2].description);
+	}
+}
+
+/*
+ *  stress_repeat_dump()
+ *	output the mean, standard deviation, 95% confidence interval
+ *	and coefficient of variation of each metric over the --repeat
+ *	runs and warn about metrics with too wide a confidence interval
+ */
+static void stress_repeat_dump(FILE *yaml)
+{
+	const stress_repeat_t *r;
+	uint32_t wide = 0;
+	bool pr_heading = false;
+
+	if (!stress_repeat_head)
+		return;
+
+	pr_block_begin();
+	for (r = stress_repeat_head; r; r = r->next) {
+		size_t m;
+
+		if (r->n_samples < 2)
+			continue;
+
+		if (!pr_heading) {
+			pr_metrics("metrics over %" PRIu32 " repeated runs (95%% confidence interval):\n",
+				opt_repeat);
+			pr_metrics("%-13s %-34s %12s %12s %12s %12s %8s\n",
+				"stressor", "metric", "mean", "std dev",
+				"CI low", "CI high", "CV %");
+			pr_yaml(yaml, "repeat:\n");
+			pr_yaml(yaml, "    repeats: %" PRIu32 "\n", opt_repeat);
+			pr_yaml(yaml, "    stressors:\n");
+			pr_heading = true;
+		}
+		pr_yaml(yaml, "      - stressor: %s\n", r->item->stressor->name);
+		pr_yaml(yaml, "        runs: %" PRIu32 "\n", r->n_samples);
+		pr_yaml(yaml, "        metrics:\n");
+
+		for (m = 0; m < stress_repeat_n_metrics(r); m++) {
+			const char *name = stress_repeat_metric_name(r, m);
+			double mean, stddev, ci_half, cv;
+
+			stress_repeat_stats(r->samples + (m * opt_repeat), r->n_samples,
+				&mean, &stddev, &ci_half);
+			cv = (mean != 0.0) ? 100.0 * stddev / fabs(mean) : 0.0;
+			if ((mean != 0.0) && (200.0 * ci_half / fabs(mean) > opt_repeat_ci_width))
+				wide++;
+
+			pr_metrics("%-13s %-34.34s %12.2f %12.2f %12.2f %12.2f %8.2f\n",
+				r->item->stressor->name, name, mean, stddev,
+				mean - ci_half, mean + ci_half, cv);
+			pr_yaml(yaml, "          - metric: %s\n", name);
+			pr_yaml(yaml, "            mean: %f\n", mean);
+			pr_yaml(yaml, "            stddev: %f\n", stddev);
+			pr_yaml(yaml, "            ci95-low: %f\n", mean - ci_half);
+			pr_yaml(yaml, "            ci95-high: %f\n", mean + ci_half);
+			pr_yaml(yaml, "            coefficient-of-variation-percent: %f\n", cv);
+		}
+	}
+	if (pr_heading)
+		pr_yaml(yaml, "\n");
+
+	/* and warn about the noisy metrics */
+	for (r = stress_repeat_head; wide && r; r = r->next) {
+		size_t m;
+
+		if (r->n_samples < 2)
+			continue;
+		for (m = 0; m < stress_repeat_n_metrics(r); m++) {
+			double mean, stddev, ci_half, width;
+
+			stress_repeat_stats(r->samples + (m * opt_repeat), r->n_samples,
+				&mean, &stddev, &ci_half);
+			if (mean == 0.0)
+				continue;
+			width = 200.0 * ci_half / fabs(mean);
+			if (width > opt_repeat_ci_width)
+				pr_warn("repeat: %s %s 95%% confidence interval width is %.2f%% "
+					"of the mean, above the %.2f%% threshold, try more repeats "
+					"or a longer run time\n",
+					r->item->stressor->name, stress_repeat_metric_name(r, m),
+					width, opt_repeat_ci_width);
+		}
+	}
+	pr_block_end();
+}
+
+/*
+ *  stress_repeat_free()
+ *	free --repeat metrics samples
+ */
+static void stress_repeat_free(void)
+{
+	stress_repeat_t *r = stress_repeat_head;
+
+	while (r) {
+		stress_repeat_t *next = r->next;
+
+		free(r->samples);
+		free(r);
+		r = next;
+	}
+	stress_repeat_head = NULL;
+}
+
+/*
+ *  stress_repeat_opts()
+ *	parse --repeat and --repeat-ci-width options, returns -1
+ *	if the CI width threshold is invalid
+ */
+static int stress_repeat_opts(void)
+{
+	char *str;
+
+	if (stress_setting_get("repeat", &opt_repeat) && (opt_repeat > 1)) {
+		/* --repeat implies --metrics */
+		g_opt_flags |= OPT_FLAGS_METRICS;
+		g_pr_log_flags |= PR_LOG_FLAGS_METRICS;
+	}
+	if (stress_setting_get("repeat-ci-width", &str)) {
+		char *end;
+
+		errno = 0;
+		opt_repeat_ci_width = strtod(str, &end);
+		if ((errno == 0) && (end != str) && (*end == '%'))
+			end++;
+		if ((errno != 0) || (end == str) || (*end != '\0') || (opt_repeat_ci_width <= 0.0)) {
+			(void)fprintf(stderr, "repeat-ci-width: invalid threshold '%s', "
+				"expecting a positive percentage, e.g. 10%%\n", str);
+			return -1;
+		}
+	}
+	return 0;
+}
+
+/*
+ *  stress_times_dump()
+ *	output the run times
+ */
+static void stress_times_dump(
+	FILE *yaml,
+	const int32_t ticks_per_sec,
+	const double duration)
+{
+	stress_load_average_info_t load_average_info;
+	struct tms buf;
+	double total_cpu_time = stress_cpus_configured_get() * duration;
+	double u_time;
+	double s_time;
+	double t_time;
+	double u_pc;
+	double s_pc;
+	double t_pc;
+	int rc;
+
+	if (!(g_opt_flags & OPT_FLAGS_TIMES))
+		return;
 
 	if (times(&buf) == (clock_t)-1) {
 		pr_err("cannot get run time information, errno=%d (%s)\n",
@@ -3384,6 +4409,9 @@ static inline size_t stressor_stats_size(void)
 			total += 8 + (sizeof(stress_metrics_desc_t) * n);
 			/* add in per stressor info, 1 per instance */
 			total += 8 + sizeof(stress_metrics_info_t);
+			/* add in latency histograms, 1 per instance */
+			if (g_opt_flags & OPT_FLAGS_LATENCY_HISTOGRAM)
+				total += item->instances * (8 + sizeof(stress_latency_t));
 		}
 	}
 	return total;
@@ -3464,6 +4492,13 @@ static inline int stress_stats_buffers_setup(void)
 				mi->metrics_desc[j].description[0] = '\0';
 				mi->metrics_desc[j].mean_type = 0;
 			}
+			stats->latency = NULL;
+			if (g_opt_flags & OPT_FLAGS_LATENCY_HISTOGRAM) {
+				stats->latency = (stress_latency_t *)stress_shared_heap_malloc(sizeof(*stats->latency));
+				if (!stats->latency)
+					return -1;
+				(void)shim_memset(stats->latency, 0, sizeof(*stats->latency));
+			}
 		}
 	}
 	return 0;
@@ -3977,6 +5012,7 @@ static void stress_stressor_option(const char *opt, const uint64_t opt_flag, int
 
 static const stress_opt_t main_opts[] = {
 	{ OPT_all,              "all",              TYPE_ID_INT32_CPU_PERCENT, -STRESS_PROCS_MAX, STRESS_PROCS_MAX, NULL },
+	{ OPT_baseline,         "baseline",         TYPE_ID_STR, 0, 0, NULL },
 	{ OPT_backoff,          "backoff",          TYPE_ID_INT64, 0, 10000000, NULL },
 	{ OPT_buddystat,        "buddystat",        TYPE_ID_INT32_TIME, 1, 3600, NULL },
 	{ OPT_cache_level,      "cache-level",      TYPE_ID_INT16, 1, 5, NULL },
@@ -3996,18 +5032,26 @@ static const stress_opt_t main_opts[] = {
 	{ OPT_limit_as,         "limit-as",         TYPE_ID_UINT64_BYTES, 1 * MB, RLIM_INFINITY, NULL },
 	{ OPT_limit_data,       "limit-data",       TYPE_ID_UINT64_BYTES, 1 * MB, RLIM_INFINITY, NULL },
 	{ OPT_limit_stack,      "limit-stack",      TYPE_ID_UINT64_BYTES, 1 * MB, RLIM_INFINITY, NULL },
+	{ OPT_lock_method,      "lock-method",      TYPE_ID_SIZE_T_METHOD, 0, 0, stress_lock_method },
 	{ OPT_log_file,         "log-file",         TYPE_ID_STR, 0, 0, NULL },
 	{ OPT_max_fd,           "max-fd",           TYPE_ID_CALLBACK, 16, 0xffffffffffffffffULL, stress_fs_max_fd },
 	{ OPT_mbind,            "mbind",            TYPE_ID_STR, 0, 0, NULL },
+	{ OPT_metrics_interval, "metrics-interval", TYPE_ID_INT32_TIME, 1, 3600, NULL },
+	{ OPT_metrics_stream,   "metrics-stream",   TYPE_ID_STR, 0, 0, NULL },
 	{ OPT_no_madvise,       "no-madvise",       TYPE_ID_BOOL, 0, 1, NULL },
 	{ OPT_no_madvise_opts,	"no-madvise-opts",  TYPE_ID_STR, 0, 0, NULL },
 	{ OPT_oom_avoid_bytes,  "oom-avoid-bytes",  TYPE_ID_SIZE_T_BYTES_VM, 4096, 0xffffffffffffffffULL, NULL },
 	{ OPT_pause,            "pause",            TYPE_ID_UINT32_TIME, 0, 0xffffffffULL, NULL },
+	{ OPT_perf_interval,    "perf-interval",    TYPE_ID_UINT32, 10, 3600000, NULL },
 	{ OPT_permute,          "permute",          TYPE_ID_INT32_CPU_PERCENT, -STRESS_PROCS_MAX, STRESS_PROCS_MAX, NULL },
 	{ OPT_quiet,            "quiet",            TYPE_ID_BOOL, 0, 1, NULL },
 	{ OPT_raplstat,         "raplstat",         TYPE_ID_INT32_TIME, 1, 3600, NULL },
 	{ OPT_random,           "random",           TYPE_ID_INT32_CPU_PERCENT, -STRESS_PROCS_MAX, STRESS_PROCS_MAX, NULL },
+	{ OPT_regress_threshold, "regress-threshold", TYPE_ID_STR, 0, 0, NULL },
+	{ OPT_repeat,           "repeat",           TYPE_ID_UINT32, 1, 1000000, NULL },
+	{ OPT_repeat_ci_width,  "repeat-ci-width",  TYPE_ID_STR, 0, 0, NULL },
 	{ OPT_resctrl,          "resctrl",          TYPE_ID_STR, 0, 0, NULL },
+	{ OPT_sampler,          "sampler",          TYPE_ID_UINT32, 1, 10000, NULL },
 	{ OPT_sched,            "sched",            TYPE_ID_STR, 0, 0, NULL },
 	{ OPT_sched_deadline,   "sched-deadline",   TYPE_ID_UINT64, 0, 1000000000000000ULL, NULL },
 	{ OPT_sched_runtime,    "sched-runtime",    TYPE_ID_UINT64, 0, 1000000000000000ULL, NULL },
@@ -4015,6 +5059,8 @@ static const stress_opt_t main_opts[] = {
 	{ OPT_sched_prio,       "sched-prio",       TYPE_ID_INT32, 1, 99, NULL },
 	{ OPT_seed,             "seed",             TYPE_ID_UINT64, 0, 0xffffffffffffffffULL, NULL },
 	{ OPT_sequential,       "sequential",       TYPE_ID_INT32_CPU_PERCENT, -STRESS_PROCS_MAX, STRESS_PROCS_MAX, NULL },
+	{ OPT_sort_data,        "sort-data",        TYPE_ID_SIZE_T_METHOD, 0, 0, stress_sort_data_method },
+	{ OPT_stall_detect,     "stall-detect",     TYPE_ID_UINT32, 1, 3600000, NULL },
 	{ OPT_status,           "status",           TYPE_ID_INT32, 1, 3600, NULL },
 	{ OPT_taskset,          "taskset",          TYPE_ID_STR, 0, 0, NULL },
 	{ OPT_temp_path,        "temp-path",        TYPE_ID_STR, 0, 0, NULL },
@@ -4023,6 +5069,7 @@ static const stress_opt_t main_opts[] = {
 	{ OPT_timer_slack,      "timer-slack",      TYPE_ID_UINT32, 0, 0xffffffffULL, NULL },
 	{ OPT_vmstat,           "vmstat",           TYPE_ID_INT32_TIME, 1, 3600, NULL },
 	{ OPT_vmstat_units,     "vmstat-units",     TYPE_ID_STR, 0, 0, NULL },
+	{ OPT_warmup,           "warmup",           TYPE_ID_UINT32_TIME, 1, 86400, NULL },
 	{ OPT_with,             "with",             TYPE_ID_STR, 0, 0, NULL },
 	{ OPT_yaml,             "yaml",             TYPE_ID_STR, 0, 0, NULL },
 	END_OPT,
@@ -4394,6 +5441,268 @@ static inline void stress_permute_run(
 	}
 }
 
+/*
+ *  stress_scale_search_stressor()
+ *	return the stressor to be scaled by --scale-search, NULL
+ *	if there isn't exactly one stressor to run
+ */
+static stress_list_item_t *stress_scale_search_stressor(void)
+{
+	stress_list_item_t *item, *found = NULL;
+
+	for (item = stress_stressor_list.head; item; item = item->next) {
+		if (item->ignore.run)
+			continue;
+		if (found)
+			return NULL;
+		found = item;
+	}
+	return found;
+}
+
+/*
+ *  stress_scale_search_setup()
+ *	save the stressor to be scaled by --scale-search along with
+ *	the user specified bogo-ops before the bogo-ops are shared
+ *	between the instances
+ */
+static void stress_scale_search_setup(void)
+{
+	stress_list_item_t *item = stress_scale_search_stressor();
+
+	if (!item)
+		return;
+	scale_search.item = item;
+	scale_search.bogo_max_ops = item->bogo_max_ops;
+}
+
+/*
+ *  stress_scale_search_instances_run()
+ *	run the stressor with the given number of instances, the
+ *	user specified bogo-ops are shared between the instances and
+ *	the stats of previous runs are reset so that the metrics are
+ *	just for this run, returns the aggregate bogo-ops/s
+ */
+static double stress_scale_search_instances_run(
+	const int32_t ticks_per_sec,
+	stress_list_item_t *item,
+	const int32_t instances,
+	double *duration,
+	bool *success,
+	bool *resource_success,
+	bool *metrics_success)
+{
+	stress_checksum_t *checksum = g_shared->checksum.checksums;
+	stress_list_item_t *next;
+	const size_t n_metrics = item->metrics_info ? item->metrics_info->max_metrics_items : 0;
+	double rate = 0.0;
+	int32_t j;
+
+	for (j = 0; j < scale_search.max_instances; j++) {
+		stress_stats_t *const stats = item->stats[j];
+		size_t i;
+
+		stats->completed = false;
+		stats->counter_total = 0;
+		stats->duration_total = 0.0;
+		stats->rusage_utime_total = 0.0;
+		stats->rusage_stime_total = 0.0;
+		stats->rusage_maxrss = 0;
+		for (i = 0; i < n_metrics; i++)
+			stats->metrics_values[i] = 0.0;
+	}
+	item->instances = instances;
+	item->bogo_max_ops = (scale_search.bogo_max_ops + (uint64_t)(instances - 1)) / (uint64_t)instances;
+
+	next = item->next;
+	item->next = NULL;
+	stress_run(ticks_per_sec, 1, item, duration, success, resource_success,
+		metrics_success, &checksum);
+	item->next = next;
+	stress_metrics_check(success);
+
+	for (j = 0; j < instances; j++) {
+		const stress_stats_t *const stats = item->stats[j];
+
+		if (stats->completed && (stats->duration > 0.0))
+			rate += (double)stats->args.bogo.count.counter / stats->duration;
+	}
+	return rate;
+}
+
+/*
+ *  stress_scale_search_step()
+ *	run the stressor with the given number of instances and
+ *	add the aggregate bogo-ops/s to the scaling curve, the
+ *	curve is kept sorted by the number of instances
+ */
+static void stress_scale_search_step(
+	const int32_t ticks_per_sec,
+	stress_list_item_t *item,
+	const int32_t instances,
+	double *duration,
+	bool *success,
+	bool *resource_success,
+	bool *metrics_success)
+{
+	double rate;
+	size_t i;
+
+	if (!stress_continue_flag() || (scale_search.n_points >= SIZEOF_ARRAY(scale_search.points)))
+		return;
+	for (i = 0; i < scale_search.n_points; i++) {
+		if (scale_search.points[i].instances == instances)
+			return;
+	}
+
+	pr_inf("scale-search: running %" PRId32 " %s instance%s\n",
+		instances, item->stressor->name, instances == 1 ? "" : "s");
+	rate = stress_scale_search_instances_run(ticks_per_sec, item, instances,
+		duration, success, resource_success, metrics_success);
+
+	for (i = scale_search.n_points; (i > 0) && (scale_search.points[i - 1].instances > instances); i--)
+		scale_search.points[i] = scale_search.points[i - 1];
+	scale_search.points[i].instances = instances;
+	scale_search.points[i].rate = rate;
+	scale_search.n_points++;
+}
+
+/*
+ *  stress_scale_search_peak()
+ *	index of the scaling curve point with the highest bogo-ops/s
+ */
+static size_t stress_scale_search_peak(void)
+{
+	size_t i, peak = 0;
+
+	for (i = 1; i < scale_search.n_points; i++) {
+		if (scale_search.points[i].rate > scale_search.points[peak].rate)
+			peak = i;
+	}
+	return peak;
+}
+
+/*
+ *  stress_scale_search_run()
+ *	run a stressor with 1, 2, 4 .. N instances, where N is the
+ *	number of instances specified for the stressor, and then
+ *	refine the instance count around the peak throughput by
+ *	bisecting the gaps to the neighbouring points of the curve,
+ *	the stressor metrics are those of the peak instance count
+ */
+static void stress_scale_search_run(
+	const int32_t ticks_per_sec,
+	double *duration,
+	bool *success,
+	bool *resource_success,
+	bool *metrics_success)
+{
+	stress_list_item_t *item = stress_scale_search_stressor();
+	int32_t max_instances, n, last;
+	size_t refine;
+
+	if (!item || (item != scale_search.item))
+		return;
+	/* the instances the stats were allocated for, runs may reduce item->instances */
+	if (scale_search.max_instances == 0)
+		scale_search.max_instances = item->instances;
+	max_instances = scale_search.max_instances;
+
+	for (n = 1; n < max_instances; n *= 2)
+		stress_scale_search_step(ticks_per_sec, item, n, duration, success, resource_success, metrics_success);
+	stress_scale_search_step(ticks_per_sec, item, max_instances, duration, success, resource_success, metrics_success);
+
+	for (refine = 0; refine < SCALE_SEARCH_REFINE_MAX; refine++) {
+		const size_t peak = stress_scale_search_peak();
+		const int32_t peak_instances = scale_search.points[peak].instances;
+		const size_t n_points = scale_search.n_points;
+
+		if ((peak + 1 < n_points) &&
+		    (scale_search.points[peak + 1].instances - peak_instances > 1)) {
+			n = (peak_instances + scale_search.points[peak + 1].instances) / 2;
+			stress_scale_search_step(ticks_per_sec, item, n, duration, success, resource_success, metrics_success);
+		}
+		if ((peak > 0) &&
+		    (peak_instances - scale_search.points[peak - 1].instances > 1)) {
+			n = (scale_search.points[peak - 1].instances + peak_instances) / 2;
+			stress_scale_search_step(ticks_per_sec, item, n, duration, success, resource_success, metrics_success);
+		}
+		/* no more gaps to bisect around the peak */
+		if (n_points == scale_search.n_points)
+			break;
+	}
+
+	/* re-run the peak if a later run overwrote its stressor metrics */
+	last = item->instances;
+	if (scale_search.n_points > 0) {
+		n = scale_search.points[stress_scale_search_peak()].instances;
+		if ((n != last) && stress_continue_flag()) {
+			pr_inf("scale-search: re-running %" PRId32 " %s instance%s at peak throughput for the metrics\n",
+				n, item->stressor->name, n == 1 ? "" : "s");
+			(void)stress_scale_search_instances_run(ticks_per_sec, item, n,
+				duration, success, resource_success, metrics_success);
+		}
+	}
+}
+
+/*
+ *  stress_scale_search_dump()
+ *	output the --scale-search scaling curve, the knee is the
+ *	number of instances after which each extra instance adds
+ *	less than half the throughput of a single instance
+ */
+static void stress_scale_search_dump(FILE *yaml)
+{
+	const char *name;
+	double rate_one;
+	size_t i, peak;
+	int32_t knee;
+
+	if (!scale_search.item || (scale_search.n_points == 0))
+		return;
+
+	name = scale_search.item->stressor->name;
+	rate_one = scale_search.points[0].rate;
+	peak = stress_scale_search_peak();
+	knee = scale_search.points[scale_search.n_points - 1].instances;
+	for (i = 0; i + 1 < scale_search.n_points; i++) {
+		const stress_scale_point_t *p1 = &scale_search.points[i];
+		const stress_scale_point_t *p2 = &scale_search.points[i + 1];
+		const double gain = (p2->rate - p1->rate) / (double)(p2->instances - p1->instances);
+
+		if (gain < 0.5 * rate_one) {
+			knee = p1->instances;
+			break;
+		}
+	}
+
+	pr_block_begin();
+	pr_metrics("scale-search: %s aggregate bogo-ops/s (real time) scaling:\n", name);
+	pr_metrics("%9s %14s %9s %12s\n", "instances", "bogo ops/s", "speedup", "efficiency %");
+	pr_yaml(yaml, "scale-search:\n");
+	pr_yaml(yaml, "    stressor: %s\n", name);
+	pr_yaml(yaml, "    curve:\n");
+	for (i = 0; i < scale_search.n_points; i++) {
+		const stress_scale_point_t *p = &scale_search.points[i];
+		const double speedup = (rate_one > 0.0) ? p->rate / rate_one : 0.0;
+
+		pr_metrics("%9" PRId32 " %14.2f %9.2f %12.2f\n",
+			p->instances, p->rate, speedup, 100.0 * speedup / (double)p->instances);
+		pr_yaml(yaml, "      - instances: %" PRId32 "\n", p->instances);
+		pr_yaml(yaml, "        bogo-ops-per-second-real-time: %f\n", p->rate);
+		pr_yaml(yaml, "        speedup: %f\n", speedup);
+	}
+	pr_metrics("scale-search: %s knee at %" PRId32 " instance%s, peak %.2f bogo-ops/s at %" PRId32 " instance%s\n",
+		name, knee, knee == 1 ? "" : "s",
+		scale_search.points[peak].rate, scale_search.points[peak].instances,
+		scale_search.points[peak].instances == 1 ? "" : "s");
+	pr_yaml(yaml, "    knee-instances: %" PRId32 "\n", knee);
+	pr_yaml(yaml, "    peak-instances: %" PRId32 "\n", scale_search.points[peak].instances);
+	pr_yaml(yaml, "    peak-bogo-ops-per-second-real-time: %f\n", scale_search.points[peak].rate);
+	pr_yaml(yaml, "\n");
+	pr_block_end();
+}
+
 /*
  *  stress_executable_mlock()
  *	try to mlock image into memory so it
@@ -4444,29 +5753,30 @@ static inline void stress_yaml_close(FILE *yaml)
 
 /*
  *  stress_global_lock_create()
- *	create global locks
+ *	create global locks, these always use the default
+ *	lock method and not the --lock-method lock method
  */
 static int stress_global_lock_create(void)
 {
 #if defined(STRESS_PERF_STATS) &&	\
     defined(HAVE_LINUX_PERF_EVENT_H)
-	g_shared->perf.lock = stress_lock_create("perf");
+	g_shared->perf.lock = stress_lock_create_method("perf", 0);
 	if (!g_shared->perf.lock) {
 		pr_err("failed to create perf lock\n");
 		return -1;
 	}
 #endif
-	g_shared->warn_once.lock = stress_lock_create("warn-once");
+	g_shared->warn_once.lock = stress_lock_create_method("warn-once", 0);
 	if (!g_shared->warn_once.lock) {
 		pr_err("failed to create warn_once lock\n");
 		return -1;
 	}
-	g_shared->net_port_map.lock = stress_lock_create("net-port");
+	g_shared->net_port_map.lock = stress_lock_create_method("net-port", 0);
 	if (!g_shared->net_port_map.lock) {
 		pr_err("failed to create net_port_map lock\n");
 		return -1;
 	}
-	g_shared->metrics.lock = stress_lock_create("metrics");
+	g_shared->metrics.lock = stress_lock_create_method("metrics", 0);
 	if (!g_shared->metrics.lock) {
 		pr_err("failed to create metrics lock\n");
 		return -1;
@@ -4526,6 +5836,7 @@ int main(int argc, char **argv, char **envp)
 	bool success = true;			/* assume successful run */
 	bool resource_success = true;		/* assume we have enough resources */
 	bool metrics_success = true;		/* assume metrics are sane */
+	bool baseline_success = true;		/* assume no baseline regressions */
 	bool no_madvise = false;		/* don't disable madvise */
 	bool quiet = false;			/* --quiet option */
 	char *optstr;				/* option string */
@@ -4629,6 +5940,19 @@ int main(int argc, char **argv, char **envp)
 		g_opt_flags |= OPT_FLAGS_RAPL_REQUIRED;
 	if (stress_setting_get("thermalstat", &discarded))
 		g_opt_flags |= OPT_FLAGS_TZ_INFO;
+	/* --baseline implies --metrics */
+	if (stress_setting_get("baseline", &optstr)) {
+		g_opt_flags |= OPT_FLAGS_METRICS;
+		g_pr_log_flags |= PR_LOG_FLAGS_METRICS;
+	}
+	if (stress_baseline_load() < 0) {
+		ret = EXIT_FAILURE;
+		goto exit_stressors_free;
+	}
+	if (stress_repeat_opts() < 0) {
+		ret = EXIT_FAILURE;
+		goto exit_stressors_free;
+	}
 
 	if (stress_setting_get("ionice-class", &optstr))
 		ionice_class = stress_io_priority_ionice_class_get(optstr);
@@ -4653,6 +5977,7 @@ int main(int argc, char **argv, char **envp)
 		goto exit_stressors_free;
 	}
 	(void)stress_setting_get("pause", &opt_pause);
+	(void)stress_setting_get("warmup", &opt_warmup);
 	(void)stress_setting_get("timeout", &g_opt_timeout);
 	(void)stress_setting_get("no-madvise", &no_madvise);
 	if (no_madvise)
@@ -4708,6 +6033,20 @@ int main(int argc, char **argv, char **envp)
 		goto exit_stressors_free;
 	}
 
+	/* Sanity check --scale-search option */
+	if (g_opt_flags & OPT_FLAGS_SCALE_SEARCH) {
+		if ((g_opt_flags & (OPT_FLAGS_RANDOM | OPT_FLAGS_SEQUENTIAL | OPT_FLAGS_ALL | OPT_FLAGS_PERMUTE)) ||
+		    (opt_repeat > 1)) {
+			(void)fprintf(stderr, "cannot invoke --scale-search with the --random, --sequential, "
+				"--all, --permute or --repeat options\n");
+			ret = EXIT_FAILURE;
+			goto exit_stressors_free;
+		}
+		/* timeout is per scaling step, so default to something shorter */
+		if (g_opt_timeout == TIMEOUT_NOT_SET)
+			g_opt_timeout = DEFAULT_SCALE_SEARCH_TIMEOUT;
+	}
+
 	/* Allocate CPU C-states */
 	stress_cpuidle_init();
 
@@ -4758,7 +6097,7 @@ int main(int argc, char **argv, char **envp)
 	stress_ftrace_start();
 #if defined(STRESS_PERF_STATS) &&	\
     defined(HAVE_LINUX_PERF_EVENT_H)
-	if (g_opt_flags & OPT_FLAGS_PERF_STATS)
+	if (g_opt_flags & (OPT_FLAGS_PERF_STATS | OPT_FLAGS_PERF_TOPDOWN))
 		stress_perf_init();
 #endif
 
@@ -4786,6 +6125,8 @@ int main(int argc, char **argv, char **envp)
 	} else if (g_opt_flags & OPT_FLAGS_PERMUTE) {
 		stress_sequential_setup(opt_class, opt_permute);
 	} else {
+		if (g_opt_flags & OPT_FLAGS_SCALE_SEARCH)
+			stress_scale_search_setup();
 		stress_parallel_setup(opt_class, opt_parallel);
 	}
 	/*
@@ -4809,6 +6150,23 @@ int main(int argc, char **argv, char **envp)
 		stress_setting_show();
 		goto exit_logging_close;
 	}
+	if ((g_opt_flags & OPT_FLAGS_SCALE_SEARCH) && !stress_scale_search_stressor()) {
+		pr_err("scale-search: just one stressor can be scaled at a time\n");
+		ret = EXIT_FAILURE;
+		goto exit_logging_close;
+	}
+	if (opt_warmup) {
+#if defined(STRESS_WARMUP)
+		if (g_opt_timeout && (opt_warmup >= g_opt_timeout)) {
+			pr_inf("warmup: %" PRIu32 " second warm-up is not shorter than the run time, "
+				"metrics include the warm-up phase\n", opt_warmup);
+			opt_warmup = 0;
+		}
+#else
+		pr_inf("warmup: not supported, no POSIX timers, metrics include the warm-up phase\n");
+		opt_warmup = 0;
+#endif
+	}
 
 	/*
 	 *  Allocate shared memory segment for shared data
@@ -4889,6 +6247,9 @@ int main(int argc, char **argv, char **envp)
 	/* Start klog monitoring process */
 	stress_klog_start();
 
+	/* Start --metrics-stream process */
+	stress_metrics_stream_start(stress_stressor_list.head);
+
 	/* Sanity check clock source */
 	stress_clocksource_check();
 
@@ -4908,12 +6269,23 @@ int main(int argc, char **argv, char **envp)
 	stress_setting_dbg("global");
 
 	/* And run stressors! */
-	if (g_opt_flags & OPT_FLAGS_SEQUENTIAL) {
-		stress_sequential_run(ticks_per_sec, n_stressors, &duration, &success, &resource_success, &metrics_success);
-	} else if (g_opt_flags & OPT_FLAGS_PERMUTE) {
-		stress_permute_run(ticks_per_sec, &duration, &success, &resource_success, &metrics_success);
-	} else {
-		stress_parallel_run(ticks_per_sec, n_stressors, &duration, &success, &resource_success, &metrics_success);
+	for (i = 0; (i < (size_t)opt_repeat) && stress_continue_flag(); i++) {
+		if (opt_repeat > 1) {
+			pr_inf("repeat %zu of %" PRIu32 "\n", i + 1, opt_repeat);
+			stress_repeat_reset();
+		}
+
+		if (g_opt_flags & OPT_FLAGS_SCALE_SEARCH) {
+			stress_scale_search_run(ticks_per_sec, &duration, &success, &resource_success, &metrics_success);
+		} else if (g_opt_flags & OPT_FLAGS_SEQUENTIAL) {
+			stress_sequential_run(ticks_per_sec, n_stressors, &duration, &success, &resource_success, &metrics_success);
+		} else if (g_opt_flags & OPT_FLAGS_PERMUTE) {
+			stress_permute_run(ticks_per_sec, &duration, &success, &resource_success, &metrics_success);
+		} else {
+			stress_parallel_run(ticks_per_sec, n_stressors, &duration, &success, &resource_success, &metrics_success);
+		}
+		if (opt_repeat > 1)
+			stress_repeat_sample();
 	}
 
 	/* Free hash table */
@@ -4929,6 +6301,9 @@ int main(int argc, char **argv, char **envp)
 	if (g_opt_flags & OPT_FLAGS_THRASH)
 		stress_thrash_stop();
 
+	/* Stop --metrics-stream process */
+	stress_metrics_stream_stop();
+
 	yaml = stress_yaml_open(yaml_filename);
 
 	/* Show what's been exercised */
@@ -4939,18 +6314,44 @@ int main(int argc, char **argv, char **envp)
 	if (g_opt_flags & OPT_FLAGS_METRICS)
 		stress_metrics_dump(yaml);
 
+	/* Dump --scale-search scaling curve */
+	stress_scale_search_dump(yaml);
+
+	/* Dump --repeat metrics confidence intervals */
+	stress_repeat_dump(yaml);
+	stress_repeat_free();
+
+	/* Compare metrics against --baseline */
+	baseline_success = stress_baseline_report(yaml);
+	stress_baseline_free();
+
 	if (g_opt_flags & OPT_FLAGS_IOS)
 		stress_ios_dump(yaml);
 
+	if (g_opt_flags & OPT_FLAGS_FAIRNESS)
+		stress_fairness_dump(yaml);
+
+	/* Dump --sampler window throughput */
+	stress_sampler_dump(yaml, stress_stressor_list.head);
+
 	/* Dump problematic interrupt counter info */
 	if (g_opt_flags & OPT_FLAGS_INTERRUPTS)
 		stress_interrupts_dump(yaml, stress_stressor_list.head);
 
+	/* Dump --stall-detect bogo-op counter stalls */
+	stress_sampler_stalls_dump(yaml, stress_stressor_list.head);
+
 #if defined(STRESS_PERF_STATS) &&	\
     defined(HAVE_LINUX_PERF_EVENT_H)
 	/* Dump perf statistics */
 	if (g_opt_flags & OPT_FLAGS_PERF_STATS)
 		stress_perf_stat_dump(yaml, stress_stressor_list.head, duration);
+	/* Dump --perf-topdown top-down level 1 breakdown */
+	if (g_opt_flags & OPT_FLAGS_PERF_TOPDOWN)
+		stress_perf_topdown_dump(yaml, stress_stressor_list.head);
+	/* Dump --perf-interval hardware counter rates */
+	stress_perf_interval_dump(yaml);
+	stress_perf_interval_free();
 #endif
 
 #if defined(STRESS_THERMAL_ZONES)
@@ -4990,6 +6391,9 @@ exit_resctrl:
 	/* Stop kernel log process */
 	stress_klog_stop(&success);
 
+	/* Stop --metrics-stream process, if not already stopped */
+	stress_metrics_stream_stop();
+
 	/* Stop and log S.M.A.R.T. stats deltas */
 	stress_smart_stop();
 
@@ -5042,6 +6446,8 @@ exit_resctrl:
 		exit(EXIT_NO_RESOURCE);
 	if (!metrics_success)
 		exit(EXIT_METRICS_UNTRUSTWORTHY);
+	if (!baseline_success)
+		exit(EXIT_BASELINE_REGRESSION);
 	exit(ret);
 
 	/* Error cleanup paths */
@@ -5060,6 +6466,7 @@ exit_logging_close:
 
 exit_stressors_free:
 	stress_stressors_free();
+	stress_baseline_free();
 
 exit_settings_free:
 	stress_setting_free();
@@ -207,6 +207,7 @@ typedef struct stress_pid {
 /* Bogo-op counter state */
 typedef struct {
 	uint64_t counter;		/* bogo-op counter */
+	uint64_t counter_warmup;	/* bogo-op counter offset at end of --warmup */
 	bool counter_ready;		/* ready flag */
 	bool run_ok;			/* stressor run w/o issues */
 	bool force_killed;		/* true if sent SIGKILL */
@@ -281,6 +282,7 @@ typedef struct stress_list_item {
 #include "core-asm-generic.h"
 #include "core-opts.h"
 #include "core-parse-opts.h"
+#include "core-latency.h"
 #include "core-perf.h"
 #include "core-setting.h"
 #include "core-signal.h"
@@ -290,6 +292,7 @@ typedef struct stress_list_item {
 #include "core-memory.h"
 #include "core-mwc.h"
 #include "core-rapl.h"
+#include "core-sampler.h"
 #include "core-sched.h"
 #include "core-stressors.h"
 #include "core-sync.h"
@@ -332,6 +335,7 @@ do {				\
 #define EXIT_SIGNALED			(5)
 #define EXIT_BY_SYS_EXIT		(6)
 #define EXIT_METRICS_UNTRUSTWORTHY	(7)
+#define EXIT_BASELINE_REGRESSION	(8)
 
 /*
  *  Stressor run states
@@ -651,6 +655,11 @@ typedef struct stress_stats {
 	long int rusage_maxrss;		/* rusage max RSS, 0 = unused */
 	stress_pid_t s_pid;		/* stressor pid */
 	double *metrics_values;		/* pointer to array of metrics values */
+	stress_latency_t *latency;	/* bogo-op latency histogram, NULL = unused */
+	stress_sampler_t sampler;	/* --sampler window throughput */
+	int32_t cpu_start;		/* CPU instance started on, -1 = unknown */
+	int32_t cpu_end;		/* CPU instance finished on, -1 = unknown */
+	int32_t numa_node;		/* NUMA node instance finished on, -1 = unknown */
 	bool sigalarmed;		/* set true if signalled with SIGALRM */
 	bool signalled;			/* set true if signalled with a kill */
 	bool completed;			/* true if stressor completed */
@@ -659,10 +668,10 @@ typedef struct stress_stats {
 /* Shared heap info */
 typedef struct shared_heap {
 	void *str_list_head;		/* list of heap strings */
-	void *lock;			/* heap global lock */
+	void *lock;			/* heap lock, used if atomics not available */
 	void *heap;			/* mmap'd heap */
 	size_t heap_size;		/* heap size */
-	size_t offset;			/* next free offset in current slab */
+	size_t offset;			/* next free offset in heap */
 	bool out_of_memory;		/* true if allocation failed */
 } shared_heap_t;
 
@@ -760,6 +769,10 @@ typedef struct {
 	struct {
 		void *lock;		/* metrics lock */
 	} metrics;
+	struct {
+		double rate;		/* total bogo-ops/sec of last window */
+		bool enabled;		/* true if sampler thread is enabled */
+	} sampler;
 	stress_stats_t stats[];		/* Shared statistics */
 } stress_shared_t;
 
@@ -831,6 +844,8 @@ static inline void ALWAYS_INLINE stress_bogo_add(stress_args_t *args, const uint
 	args->bogo.count.counter += inc;
 	stress_asm_mb();
 	args->bogo.count.counter_ready = true;
+	if (UNLIKELY(g_opt_flags & OPT_FLAGS_LATENCY_HISTOGRAM))
+		stress_latency_record(args, inc);
 }
 
 /*
@@ -848,6 +863,8 @@ static inline void ALWAYS_INLINE stress_bogo_inc(stress_args_t *args)
 	args->bogo.count.counter++;
 	stress_asm_mb();
 	args->bogo.count.counter_ready = true;
+	if (UNLIKELY(g_opt_flags & OPT_FLAGS_LATENCY_HISTOGRAM))
+		stress_latency_record(args, 1);
 }
 
 /*
@@ -878,11 +895,15 @@ static inline void ALWAYS_INLINE stress_bogo_ready(stress_args_t *args)
  */
 static inline void ALWAYS_INLINE stress_bogo_set(stress_args_t *args, const uint64_t val)
 {
+	const uint64_t prev = args->bogo.count.counter;
+
 	args->bogo.count.counter_ready = false;
 	stress_asm_mb();
 	args->bogo.count.counter = val;
 	stress_asm_mb();
 	args->bogo.count.counter_ready = true;
+	if (UNLIKELY(g_opt_flags & OPT_FLAGS_LATENCY_HISTOGRAM))
+		stress_latency_record(args, val > prev ? val - prev : 0);
 }
 
 /*
@@ -18,7 +18,10 @@
  */
 #include "stress-ng.h"
 #include "core-builtin.h"
+#include "core-cpu.h"
+#include "core-cpu-cache.h"
 #include "core-mmap.h"
+#include "core-put.h"
 
 #define MIN_NEXT_PTRS_4K_PAGES		(64)
 #define MAX_NEXT_PTRS_4K_PAGES		(256 * 1024)
@@ -27,10 +30,31 @@
 
 #define PTRS_PER_4K_PAGE		(PAGE_SIZE_4K / sizeof(void *))	/* Must be power of 2 */
 
+#define MIN_PTR_CHASE_SWEEP_MAX		(64 * KB)
+#define MAX_PTR_CHASE_SWEEP_MAX		(64 * GB)
+#define DEFAULT_PTR_CHASE_SWEEP_MAX	(1 * GB)
+
+#define PTR_CHASE_SWEEP_MIN		(4 * KB)	/* smallest working set */
+#define PTR_CHASE_SWEEP_SIZES		(64)		/* max working set sizes */
+#define PTR_CHASE_SWEEP_LINE		(64)		/* bytes per pointer */
+#define PTR_CHASE_SWEEP_HUGEPAGE	(2 * MB)	/* hugepage alignment */
+#define PTR_CHASE_SWEEP_SLICE		(0.02)		/* seconds per measurement */
+#define PTR_CHASE_SWEEP_WARM		(1U << 20)	/* max warm up pointer chases */
+#define PTR_CHASE_SWEEP_LEVELS		(8)		/* max latency transitions */
+#define PTR_CHASE_SWEEP_STEP		(1.30)		/* latency rise that starts a transition */
+#define PTR_CHASE_SWEEP_RISE		(1.10)		/* latency rise that continues a transition */
+#define PTR_CHASE_SWEEP_TLB		(1.15)		/* 4K over hugepage latency for TLB misses */
+
+#define PTR_CHASE_SWEEP_4K		(0)		/* 4K page backed sweep */
+#define PTR_CHASE_SWEEP_HUGE		(1)		/* hugepage backed sweep */
+
 static const stress_help_t help[] = {
 	{ NULL,	"ptr-chase N",	 	"start N workers that chase pointers around many nodes" },
 	{ NULL,	"ptr-chase-ops N",	"stop after N bogo pointer chase operations" },
+	{ NULL,	"ptr-chase-hugepages",	"also sweep with hugepage backed memory for TLB miss costs" },
 	{ NULL,	"ptr-chase-pages N",	"N is the number of pages for nodes of pointers" },
+	{ NULL,	"ptr-chase-sweep",	"measure latency over working set sizes from 4K upwards" },
+	{ NULL,	"ptr-chase-sweep-max N","largest working set size for --ptr-chase-sweep" },
 	{ NULL,	NULL,		 	NULL }
 };
 
@@ -39,11 +63,453 @@ typedef struct stress_ptrs {
 	struct stress_ptrs *next[PTRS_PER_4K_PAGE];
 } stress_ptrs_t;
 
+/* Working set sweep mapping and latency results */
+typedef struct {
+	void *mapping;			/* mmap'd buffer */
+	void **buf;			/* buffer, hugepage aligned */
+	size_t mapping_size;		/* size of mapping */
+	double latency[PTR_CHASE_SWEEP_SIZES];	/* sum of nanosecs per pointer */
+	uint32_t count[PTR_CHASE_SWEEP_SIZES];	/* number of measurements */
+} stress_ptr_chase_sweep_t;
+
+/* Latency transition between two working set sizes */
+typedef struct {
+	size_t size;			/* largest working set before transition */
+	double from;			/* plateau latency before transition */
+	double to;			/* latency after transition */
+} stress_ptr_chase_level_t;
+
 static const stress_opt_t opts[] = {
-	{ OPT_ptr_chase_pages, "ptr-chase-pages", TYPE_ID_UINT64, MIN_NEXT_PTRS_4K_PAGES, MAX_NEXT_PTRS_4K_PAGES, NULL },
+	{ OPT_ptr_chase_hugepages, "ptr-chase-hugepages", TYPE_ID_BOOL, 0, 1, NULL },
+	{ OPT_ptr_chase_pages,     "ptr-chase-pages",     TYPE_ID_UINT64, MIN_NEXT_PTRS_4K_PAGES, MAX_NEXT_PTRS_4K_PAGES, NULL },
+	{ OPT_ptr_chase_sweep,     "ptr-chase-sweep",     TYPE_ID_BOOL, 0, 1, NULL },
+	{ OPT_ptr_chase_sweep_max, "ptr-chase-sweep-max", TYPE_ID_UINT64_BYTES_VM, MIN_PTR_CHASE_SWEEP_MAX, MAX_PTR_CHASE_SWEEP_MAX, NULL },
 	END_OPT,
 };
 
+/*
+ *  stress_ptr_chase_sweep_sizes()
+ *	fill sizes with working set sizes of 4K, 6K, 8K, 12K, 16K..
+ *	up to max, returns number of sizes
+ */
+static size_t stress_ptr_chase_sweep_sizes(size_t *sizes, const size_t max)
+{
+	size_t n = 0, size;
+
+	for (size = PTR_CHASE_SWEEP_MIN; (size <= max) && (n < PTR_CHASE_SWEEP_SIZES); size <<= 1) {
+		sizes[n++] = size;
+		if ((size + (size >> 1) <= max) && (n < PTR_CHASE_SWEEP_SIZES))
+			sizes[n++] = size + (size >> 1);
+	}
+	return n;
+}
+
+/*
+ *  stress_ptr_chase_size_str()
+ *	exact working set size as a string, e.g. 6K, 12M, 1G
+ */
+static char *stress_ptr_chase_size_str(char *str, const size_t len, const uint64_t size)
+{
+	if ((size >= GB) && ((size % GB) == 0))
+		(void)snprintf(str, len, "%" PRIu64 "G", (uint64_t)(size / GB));
+	else if ((size >= MB) && ((size % MB) == 0))
+		(void)snprintf(str, len, "%" PRIu64 "M", (uint64_t)(size / MB));
+	else
+		(void)snprintf(str, len, "%" PRIu64 "K", (uint64_t)(size / KB));
+	return str;
+}
+
+/*
+ *  stress_ptr_chase_thp_available()
+ *	return true if transparent hugepages can be enabled
+ *	with madvise(), false if THP is disabled or not supported
+ */
+static bool stress_ptr_chase_thp_available(void)
+{
+	char buf[128];
+
+	if (stress_fs_file_read("/sys/kernel/mm/transparent_hugepage/enabled", buf, sizeof(buf)) <= 0)
+		return false;
+	return strstr(buf, "[never]") == NULL;
+}
+
+/*
+ *  stress_ptr_chase_sweep_mmap()
+ *	mmap a hugepage aligned buffer of size bytes backed by 4K
+ *	pages or by transparent hugepages, returns -1 if the mmap
+ *	failed and 1 if the hugepage backing could not be enabled
+ */
+static int stress_ptr_chase_sweep_mmap(
+	stress_ptr_chase_sweep_t *sweep,
+	const size_t size,
+	const bool hugepages)
+{
+	uintptr_t addr;
+
+	sweep->mapping_size = size + PTR_CHASE_SWEEP_HUGEPAGE;
+	sweep->mapping = mmap(NULL, sweep->mapping_size, PROT_READ | PROT_WRITE,
+				MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+	if (sweep->mapping == MAP_FAILED)
+		return -1;
+	stress_memory_anon_name_set(sweep->mapping, sweep->mapping_size, "pointer-sweep");
+
+	addr = ((uintptr_t)sweep->mapping + PTR_CHASE_SWEEP_HUGEPAGE - 1) & ~(uintptr_t)(PTR_CHASE_SWEEP_HUGEPAGE - 1);
+	sweep->buf = (void **)addr;
+#if defined(HAVE_MADVISE) &&	\
+    defined(MADV_HUGEPAGE) &&	\
+    defined(MADV_NOHUGEPAGE)
+	if (hugepages)
+		return (madvise(sweep->mapping, sweep->mapping_size, MADV_HUGEPAGE) < 0) ? 1 : 0;
+	(void)madvise(sweep->mapping, sweep->mapping_size, MADV_NOHUGEPAGE);
+	return 0;
+#else
+	if (hugepages) {
+		errno = ENOSYS;
+		return 1;
+	}
+	return 0;
+#endif
+}
+
+/*
+ *  stress_ptr_chase_sweep_measure()
+ *	link the size / 64 pointers of buf into one random cycle using
+ *	Sattolo's algorithm and measure the average nanosecs per dependent
+ *	pointer chase, returns -1.0 if the pointer cycle is broken
+ */
+static double stress_ptr_chase_sweep_measure(void **buf, uint32_t *order, const size_t size)
+{
+	const size_t stride = PTR_CHASE_SWEEP_LINE / sizeof(*buf);
+	const size_t n = size / PTR_CHASE_SWEEP_LINE;
+	register void **ptr = buf;
+	uint64_t chases = 0;
+	size_t i, warm;
+	double t1, t2;
+
+	for (i = 0; i < n; i++)
+		order[i] = (uint32_t)i;
+	for (i = n - 1; i > 0; i--) {
+		const size_t j = (size_t)stress_mwc32modn((uint32_t)i);
+		const uint32_t tmp = order[i];
+
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+	for (i = 0; i < n; i++)
+		buf[order[i] * stride] = (void *)&buf[order[(i + 1) % n] * stride];
+
+	/* warm up, a full cycle must return to the start */
+	warm = (n <= PTR_CHASE_SWEEP_WARM) ? n : PTR_CHASE_SWEEP_WARM;
+	for (i = 0; i < warm; i++)
+		ptr = (void **)*ptr;
+	if ((n <= PTR_CHASE_SWEEP_WARM) && (ptr != buf))
+		return -1.0;
+
+	t1 = stress_time_now();
+	do {
+		for (i = 0; i < 256; i++)
+			ptr = (void **)*ptr;
+		chases += 256;
+		t2 = stress_time_now();
+	} while ((t2 - t1) < PTR_CHASE_SWEEP_SLICE);
+	stress_put_void_ptr((volatile void *)ptr);
+
+	return ((t2 - t1) * STRESS_DBL_NANOSECOND) / (double)chases;
+}
+
+/*
+ *  stress_ptr_chase_sweep_levels()
+ *	find the working set sizes where the latency steps up, a
+ *	transition starts when latency rises by 30% over the current
+ *	plateau and continues while latency keeps rising by 10% or more
+ */
+static size_t stress_ptr_chase_sweep_levels(
+	const size_t *sizes,
+	const double *latency,
+	const size_t n_sizes,
+	stress_ptr_chase_level_t *levels)
+{
+	size_t i, n = 0;
+	double base;
+	bool rising = false;
+
+	if (n_sizes < 2)
+		return 0;
+
+	base = latency[0];
+	for (i = 1; i < n_sizes; i++) {
+		if (rising) {
+			if (latency[i] >= latency[i - 1] * PTR_CHASE_SWEEP_RISE) {
+				levels[n - 1].to = latency[i];
+				continue;
+			}
+			rising = false;
+			base = latency[i - 1];
+		}
+		if ((latency[i] >= base * PTR_CHASE_SWEEP_STEP) && (n < PTR_CHASE_SWEEP_LEVELS)) {
+			levels[n].size = sizes[i - 1];
+			levels[n].from = base;
+			levels[n].to = latency[i];
+			n++;
+			rising = true;
+		}
+	}
+	return n;
+}
+
+/*
+ *  stress_ptr_chase_sweep_report()
+ *	report the latency of each working set size, the latency
+ *	transitions cross-checked against the cache sizes and the
+ *	4K page TLB reach and TLB miss cost
+ */
+static void stress_ptr_chase_sweep_report(
+	stress_args_t *args,
+	const size_t *sizes,
+	const size_t n_sizes,
+	const stress_ptr_chase_sweep_t *sweeps,
+	const bool hugepages)
+{
+	const stress_ptr_chase_sweep_t *sweep = &sweeps[hugepages ? PTR_CHASE_SWEEP_HUGE : PTR_CHASE_SWEEP_4K];
+	double latency[PTR_CHASE_SWEEP_SIZES], latency_4k[PTR_CHASE_SWEEP_SIZES];
+	stress_ptr_chase_level_t levels[PTR_CHASE_SWEEP_LEVELS];
+	stress_cpu_cache_cpus_t *cpu_caches;
+	size_t i, n, n_levels, tlb_size = 0;
+	char str[32], metric[64];
+
+	/* only use sizes measured with all the page backings */
+	for (n = 0; n < n_sizes; n++) {
+		if ((sweeps[PTR_CHASE_SWEEP_4K].count[n] == 0) || (sweep->count[n] == 0))
+			break;
+		latency[n] = sweep->latency[n] / (double)sweep->count[n];
+		latency_4k[n] = sweeps[PTR_CHASE_SWEEP_4K].latency[n] / (double)sweeps[PTR_CHASE_SWEEP_4K].count[n];
+	}
+	if (n == 0) {
+		pr_inf("%s: no working set sizes measured, run duration too short\n", args->name);
+		return;
+	}
+	n_levels = stress_ptr_chase_sweep_levels(sizes, latency, n, levels);
+
+	pr_block_begin();
+	if (hugepages)
+		pr_inf("%s: %12s %12s %12s %12s\n", args->name, "working set", "4K ns/load", "huge ns/load", "TLB ns/load");
+	else
+		pr_inf("%s: %12s %12s\n", args->name, "working set", "4K ns/load");
+	for (i = 0; i < n; i++) {
+		(void)stress_ptr_chase_size_str(str, sizeof(str), (uint64_t)sizes[i]);
+		if (hugepages) {
+			pr_inf("%s: %12s %12.2f %12.2f %12.2f\n", args->name, str,
+				latency_4k[i], latency[i], latency_4k[i] - latency[i]);
+			/* first size where 4K pages run out of TLB reach */
+			if ((tlb_size == 0) && (latency_4k[i] >= latency[i] * PTR_CHASE_SWEEP_TLB))
+				tlb_size = (i > 0) ? sizes[i - 1] : sizes[i];
+		} else {
+			pr_inf("%s: %12s %12.2f\n", args->name, str, latency_4k[i]);
+		}
+	}
+
+	for (i = 0; i < n_levels; i++) {
+		(void)stress_ptr_chase_size_str(str, sizeof(str), (uint64_t)levels[i].size);
+		pr_inf("%s: latency level %zu up to %s working set, %.2f ns/load, rising to %.2f ns/load\n",
+			args->name, i + 1, str, levels[i].from, levels[i].to);
+		(void)snprintf(metric, sizeof(metric), "level %zu nanosec per pointer", i + 1);
+		stress_metrics_set(args, metric, levels[i].from, STRESS_METRIC_HARMONIC_MEAN);
+	}
+	if (n_levels > 0) {
+		(void)snprintf(metric, sizeof(metric), "level %zu nanosec per pointer", n_levels + 1);
+		stress_metrics_set(args, metric, latency[n - 1], STRESS_METRIC_HARMONIC_MEAN);
+	}
+
+	/* cross-check latency levels against the cache sizes */
+	cpu_caches = stress_cpu_cache_details_get();
+	if (cpu_caches) {
+		const uint16_t max_level = stress_cpu_cache_max_level_get(cpu_caches);
+		uint16_t level;
+
+		for (level = 1; level <= max_level; level++) {
+			const stress_cpu_cache_t *cache = stress_cpu_cache_get(cpu_caches, level, CACHE_TYPE_DATA);
+			char cache_str[32];
+			size_t j;
+
+			if (!cache || !cache->size)
+				continue;
+			(void)stress_ptr_chase_size_str(cache_str, sizeof(cache_str), cache->size);
+			for (j = 0; j < n_levels; j++) {
+				if ((levels[j].size >= cache->size / 2) && (levels[j].size <= cache->size * 2))
+					break;
+			}
+			if (j < n_levels) {
+				(void)stress_ptr_chase_size_str(str, sizeof(str), (uint64_t)levels[j].size);
+				pr_inf("%s: L%" PRIu16 " cache size %s matches latency level %zu transition at %s\n",
+					args->name, level, cache_str, j + 1, str);
+			} else if (cache->size * 2 <= sizes[n - 1]) {
+				pr_inf("%s: L%" PRIu16 " cache size %s has no matching latency transition\n",
+					args->name, level, cache_str);
+			}
+		}
+		stress_cpu_cache_free(cpu_caches);
+	}
+
+	if (hugepages) {
+		const double tlb_cost = latency_4k[n - 1] - latency[n - 1];
+
+		if (tlb_size) {
+			uint32_t entries = 0;
+			uint8_t level = 0;
+
+			(void)stress_ptr_chase_size_str(str, sizeof(str), (uint64_t)tlb_size);
+			pr_inf("%s: 4K page TLB reach exceeded after %s working set\n", args->name, str);
+			if (stress_cpu_is_x86()) {
+				stress_cpu_x86_dtlb_entries(&entries, &level);
+				if (entries) {
+					char tlb_str[32];
+
+					(void)stress_ptr_chase_size_str(tlb_str, sizeof(tlb_str), (uint64_t)entries * PAGE_SIZE_4K);
+					pr_inf("%s: L%" PRIu8 " data TLB %" PRIu32 " entries, 4K page TLB reach %s\n",
+						args->name, level, entries, tlb_str);
+				}
+			}
+		}
+		(void)stress_ptr_chase_size_str(str, sizeof(str), (uint64_t)sizes[n - 1]);
+		pr_inf("%s: TLB miss cost %.2f ns/load at %s working set\n", args->name, tlb_cost, str);
+		stress_metrics_set(args, "TLB miss nanosec per pointer", tlb_cost, STRESS_METRIC_HARMONIC_MEAN);
+	}
+	pr_block_end();
+}
+
+/*
+ *  stress_ptr_chase_sweep()
+ *	measure dependent pointer chase latency over working sets
+ *	from 4K to the --ptr-chase-sweep-max size in log steps,
+ *	this only runs on instance 0 as other instances sharing
+ *	the caches and memory bandwidth distort the latencies
+ */
+static int stress_ptr_chase_sweep(stress_args_t *args)
+{
+	uint64_t sweep_max = DEFAULT_PTR_CHASE_SWEEP_MAX;
+	stress_ptr_chase_sweep_t sweeps[2];
+	stress_memory_info_t info;
+	size_t sizes[PTR_CHASE_SWEEP_SIZES];
+	size_t n_sizes, max, i, backings;
+	bool hugepages = false;
+	uint32_t *order;
+	int rc = EXIT_SUCCESS;
+
+	if (!stress_instance_zero(args)) {
+		pr_dbg("%s: --ptr-chase-sweep only runs on instance 0, instance %" PRIu32 " is idle\n",
+			args->name, args->instance);
+		stress_proc_state_set(args->name, STRESS_STATE_SYNC_WAIT);
+		stress_sync_start_wait(args);
+		stress_proc_state_set(args->name, STRESS_STATE_RUN);
+
+		/* Wait for termination */
+		while (stress_continue(args))
+			(void)shim_pause();
+		stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
+		return EXIT_SUCCESS;
+	}
+	if (args->instances > 1)
+		pr_inf("%s: --ptr-chase-sweep only runs on instance 0, the other instances are idle\n",
+			args->name);
+
+	(void)stress_setting_get("ptr-chase-hugepages", &hugepages);
+	(void)stress_setting_get("ptr-chase-sweep-max", &sweep_max);
+	max = (size_t)sweep_max;
+	if (hugepages && !stress_ptr_chase_thp_available()) {
+		pr_inf("%s: transparent hugepages not available, skipping hugepage sweep and TLB miss cost\n",
+			args->name);
+		hugepages = false;
+	}
+	backings = hugepages ? 2 : 1;
+
+	/* limit the buffers and order indices to half of the free memory */
+	if ((stress_memory_info_get(&info) == 0) && (info.freemem > 0)) {
+		const size_t free_max = ((info.freemem / 2) / ((backings * 16) + 1)) * 16;
+
+		if (max > free_max) {
+			char max_str[32], free_str[32];
+
+			max = STRESS_MAXIMUM(free_max, MIN_PTR_CHASE_SWEEP_MAX);
+			(void)stress_ptr_chase_size_str(max_str, sizeof(max_str), (uint64_t)sweep_max);
+			(void)stress_ptr_chase_size_str(free_str, sizeof(free_str), (uint64_t)max);
+			pr_inf("%s: reducing --ptr-chase-sweep-max from %s to %s to fit into free memory\n",
+				args->name, max_str, free_str);
+		}
+	}
+
+	n_sizes = stress_ptr_chase_sweep_sizes(sizes, max);
+	max = sizes[n_sizes - 1];
+
+	order = (uint32_t *)calloc(max / PTR_CHASE_SWEEP_LINE, sizeof(*order));
+	if (!order) {
+		pr_inf_skip("%s: failed to allocate %zu pointer order indices%s, skipping stressor\n",
+			args->name, max / PTR_CHASE_SWEEP_LINE, stress_memory_free_get());
+		return EXIT_NO_RESOURCE;
+	}
+	(void)shim_memset(sweeps, 0, sizeof(sweeps));
+	for (i = 0; i < backings; i++) {
+		const int ret = stress_ptr_chase_sweep_mmap(&sweeps[i], max, i == PTR_CHASE_SWEEP_HUGE);
+
+		if (ret < 0) {
+			pr_inf_skip("%s: mmap %zu bytes failed%s, errno=%d (%s), skipping stressor\n",
+				args->name, max, stress_memory_free_get(), errno, strerror(errno));
+			rc = EXIT_NO_RESOURCE;
+			goto tidy;
+		}
+		if (ret > 0) {
+			pr_inf("%s: madvise MADV_HUGEPAGE failed, errno=%d (%s), skipping hugepage sweep and TLB miss cost\n",
+				args->name, errno, strerror(errno));
+			(void)munmap(sweeps[i].mapping, sweeps[i].mapping_size);
+			sweeps[i].mapping = NULL;
+			hugepages = false;
+			backings = 1;
+		}
+	}
+	{
+		const size_t sz = (backings * max) + ((max / PTR_CHASE_SWEEP_LINE) * sizeof(*order));
+
+		stress_memory_usage_get(args, sz, sz);
+	}
+
+	stress_proc_state_set(args->name, STRESS_STATE_SYNC_WAIT);
+	stress_sync_start_wait(args);
+	stress_proc_state_set(args->name, STRESS_STATE_RUN);
+
+	do {
+		size_t j;
+
+		for (i = 0; i < backings; i++) {
+			for (j = 0; j < n_sizes; j++) {
+				const double latency = stress_ptr_chase_sweep_measure(sweeps[i].buf, order, sizes[j]);
+
+				if (latency < 0.0) {
+					pr_fail("%s: pointer chase over %zu bytes did not return to the start\n",
+						args->name, sizes[j]);
+					rc = EXIT_FAILURE;
+					goto deinit;
+				}
+				sweeps[i].latency[j] += latency;
+				sweeps[i].count[j]++;
+				stress_bogo_inc(args);
+				if (UNLIKELY(!stress_continue(args)))
+					goto deinit;
+			}
+		}
+	} while (stress_continue(args));
+
+deinit:
+	stress_ptr_chase_sweep_report(args, sizes, n_sizes, sweeps, hugepages);
+	stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
+tidy:
+	for (i = 0; i < backings; i++) {
+		if (sweeps[i].mapping && (sweeps[i].mapping != MAP_FAILED))
+			(void)munmap(sweeps[i].mapping, sweeps[i].mapping_size);
+	}
+	free(order);
+
+	return rc;
+}
+
 /*
  *  stress_ptr_chase()
  *	stress list
@@ -67,6 +533,11 @@ static int stress_ptr_chase(stress_args_t *args)
 	double t_start;
 	double duration;
 	int rc = EXIT_NO_RESOURCE;
+	bool ptr_chase_sweep = false;
+
+	(void)stress_setting_get("ptr-chase-sweep", &ptr_chase_sweep);
+	if (ptr_chase_sweep)
+		return stress_ptr_chase_sweep(args);
 
 	if (!stress_setting_get("ptr-chase-pages", &ptr_chase_pages)) {
 		if (g_opt_flags & OPT_FLAGS_MAXIMIZE)
@@ -209,6 +680,7 @@ const stressor_info_t stress_ptr_chase_info = {
 	.stressor = stress_ptr_chase,
 	.classifier = CLASS_CPU_CACHE | CLASS_CPU | CLASS_MEMORY | CLASS_SEARCH,
 	.opts = opts,
+	.max_metrics_items = PTR_CHASE_SWEEP_LEVELS + 3,
 	.verify = VERIFY_ALWAYS,
 	.help = help,
 	.exercises = exercises,
@@ -42,7 +42,7 @@ typedef void (*qsort_func_t)(void *base, size_t nmemb, size_t size, comp_func_t
 
 static const stress_help_t help[] = {
 	{ "Q N", "qsort N",		"start N workers qsorting 32 bit random integers" },
-	{ NULL,	"qsort-method M",	"select qsort method [ qsort-libc | qsort_bm ]" },
+	{ NULL,	"qsort-method M",	"select qsort method [ qsort-libc | qsort-bm | mergesort-mt | netsort | pdqsort | radix-lsd ]" },
 	{ NULL,	"qsort-ops N",		"stop after N qsort bogo operations" },
 	{ NULL,	"qsort-size N",		"number of 32 bit integers to sort" },
 	{ NULL,	NULL,			NULL }
@@ -75,6 +75,13 @@ static const stress_qsort_method_t stress_qsort_methods[] = {
 	{ "qsort-bm",		qsort_bm },
 };
 
+static const char *stress_qsort_method(const size_t i)
+{
+	if (i < SIZEOF_ARRAY(stress_qsort_methods))
+		return stress_qsort_methods[i].name;
+	return stress_sort_engine_name(i - SIZEOF_ARRAY(stress_qsort_methods));
+}
+
 static inline bool OPTIMIZE3 stress_qsort_verify_forward(
 	stress_args_t *args,
 	const int32_t *data,
@@ -153,6 +160,7 @@ static int OPTIMIZE3 stress_qsort(stress_args_t *args)
 	CLOBBERED double count = 0.0;
 	CLOBBERED double sorted = 0.0;
 	CLOBBERED int rc = EXIT_SUCCESS;
+	CLOBBERED bool sort_compares = true;
 	qsort_func_t qsort_func;
 #if defined(HAVE_SIGLONGJMP)
 	struct sigaction old_action;
@@ -200,10 +208,17 @@ static int OPTIMIZE3 stress_qsort(stress_args_t *args)
 
 	stress_sort_data_int32_init(data, n);
 
-	qsort_func = stress_qsort_methods[qsort_method].qsort_func;
+	if (qsort_method < SIZEOF_ARRAY(stress_qsort_methods)) {
+		qsort_func = stress_qsort_methods[qsort_method].qsort_func;
+	} else {
+		const stress_sort_engine_t *engine = stress_sort_engine_get(qsort_method - SIZEOF_ARRAY(stress_qsort_methods));
+
+		qsort_func = engine->sort;
+		sort_compares = engine->compares;
+	}
 	if (stress_instance_zero(args))
 		pr_inf("%s: using method '%s'\n",
-			args->name, stress_qsort_methods[qsort_method].name);
+			args->name, stress_qsort_method(qsort_method));
 
 	stress_proc_state_set(args->name, STRESS_STATE_SYNC_WAIT);
 	stress_sync_start_wait(args);
@@ -212,7 +227,7 @@ static int OPTIMIZE3 stress_qsort(stress_args_t *args)
 	do {
 		double t;
 
-		stress_sort_data_int32_shuffle(data, n);
+		stress_sort_data_int32(data, n, 0);
 
 		stress_sort_compare_reset();
 		t = stress_time_now();
@@ -270,25 +285,26 @@ static int OPTIMIZE3 stress_qsort(stress_args_t *args)
 tidy:
 #endif
 	stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
-	rate = (duration > 0.0) ? count / duration : 0.0;
-	stress_metrics_set(args, "qsort comparisons per sec",
-		rate, STRESS_METRIC_HARMONIC_MEAN);
-	rate = (sorted > 0.0) ? count / sorted : 0.0;
-	stress_metrics_set(args, "qsort comparisons per item",
+	/* radix sorts make no comparisons, just report the sort rate */
+	if (sort_compares) {
+		rate = (duration > 0.0) ? count / duration : 0.0;
+		stress_metrics_set(args, "qsort comparisons per sec",
+			rate, STRESS_METRIC_HARMONIC_MEAN);
+		rate = (sorted > 0.0) ? count / sorted : 0.0;
+		stress_metrics_set(args, "qsort comparisons per item",
+			rate, STRESS_METRIC_HARMONIC_MEAN);
+
+		pr_dbg("%s: %.2f qsort comparisons per sec\n", args->name, rate);
+	}
+	rate = (duration > 0.0) ? sorted / duration : 0.0;
+	stress_metrics_set(args, "qsort elements sorted per sec",
 		rate, STRESS_METRIC_HARMONIC_MEAN);
 
-	pr_dbg("%s: %.2f qsort comparisons per sec\n", args->name, rate);
-
 	(void)munmap((void *)data, data_size);
 
 	return rc;
 }
 
-static const char *stress_qsort_method(const size_t i)
-{
-	return (i < SIZEOF_ARRAY(stress_qsort_methods)) ? stress_qsort_methods[i].name : NULL;
-}
-
 static const stress_opt_t opts[] = {
 	{ OPT_qsort_size,   "qsort-size",   TYPE_ID_UINT64, MIN_QSORT_SIZE, MAX_QSORT_SIZE, NULL },
 	{ OPT_qsort_method, "qsort-method", TYPE_ID_SIZE_T_METHOD, 0, 0, stress_qsort_method },
@@ -1121,8 +1121,8 @@ static int stress_sparse_method_test(
 
 	t1 = stress_time_now();
 	for (i = 0; LIKELY(stress_continue_flag() && (i < sparsematrix_items)); i++) {
-		register const uint32_t x = stress_mwc32modn(sparsematrix_size);
-		register const uint32_t y = stress_mwc32modn(sparsematrix_size);
+		register const uint32_t x = stress_mwc32modn_buffered(sparsematrix_size);
+		register const uint32_t y = stress_mwc32modn_buffered(sparsematrix_size);
 		uint32_t gv;
 		uint32_t v = value_map(x, y);
 
@@ -1148,8 +1148,8 @@ static int stress_sparse_method_test(
 	stress_mwc_seed_set(w, z);
 	t1 = stress_time_now();
 	for (i = 0; LIKELY(stress_continue_flag() && (i < sparsematrix_items)); i++) {
-		register const uint32_t x = stress_mwc32modn(sparsematrix_size);
-		register const uint32_t y = stress_mwc32modn(sparsematrix_size);
+		register const uint32_t x = stress_mwc32modn_buffered(sparsematrix_size);
+		register const uint32_t y = stress_mwc32modn_buffered(sparsematrix_size);
 		uint32_t gv;
 		uint32_t v = value_map(x, y);
 
@@ -1172,8 +1172,8 @@ static int stress_sparse_method_test(
 	/* Random fetches, most probably all zero unset values */
 	t1 = stress_time_now();
 	for (i = 0; LIKELY(stress_continue_flag() && (i < sparsematrix_items)); i++) {
-		const uint32_t x = stress_mwc32modn(sparsematrix_size);
-		const uint32_t y = stress_mwc32modn(sparsematrix_size);
+		const uint32_t x = stress_mwc32modn_buffered(sparsematrix_size);
+		const uint32_t y = stress_mwc32modn_buffered(sparsematrix_size);
 
 		(void)info->get(handle, x, y);
 	}
@@ -1183,8 +1183,8 @@ static int stress_sparse_method_test(
 
 	stress_mwc_seed_set(w, z);
 	for (i = 0; LIKELY(stress_continue_flag() && (i < sparsematrix_items)); i++) {
-		const uint32_t x = stress_mwc32modn(sparsematrix_size);
-		const uint32_t y = stress_mwc32modn(sparsematrix_size);
+		const uint32_t x = stress_mwc32modn_buffered(sparsematrix_size);
+		const uint32_t y = stress_mwc32modn_buffered(sparsematrix_size);
 		uint32_t v = value_map(x, y);
 		(void)v;
 
@@ -31,12 +31,14 @@
  */
 #include "stress-ng.h"
 #include "core-builtin.h"
+#include "core-affinity.h"
 #include "core-cpu.h"
 #include "core-cpu-cache.h"
 #include "core-mmap.h"
 #include "core-nt-store.h"
 #include "core-numa.h"
 #include "core-pragma.h"
+#include "core-pthread.h"
 #include "core-signal.h"
 #include "core-target-clones.h"
 
@@ -52,6 +54,18 @@
 
 #define STORE(dst, src)			dst = src
 
+#if defined(HAVE_LIB_PTHREAD) &&	\
+    defined(HAVE_SCHED_SETAFFINITY) &&	\
+    defined(HAVE_CPU_SET_T)
+#define HAVE_STREAM_NUMA
+#endif
+
+#define STREAM_NUMA_SLICE	(100000000ULL)	/* nanosecs per bandwidth measurement */
+#define STREAM_NUMA_STEPS	(16)	/* thread count steps, 1, 2, 4.. */
+#define STREAM_NUMA_SATURATED	(0.95)	/* saturated at 95% of peak bandwidth */
+#define STREAM_NUMA_METRIC_NODES (16)	/* cpu nodes reported as metrics */
+#define STREAM_NUMA_METRICS	(3 * STREAM_NUMA_METRIC_NODES)
+
 typedef struct {
 	const char *name;
 	const int advice;
@@ -63,7 +77,9 @@ static const stress_help_t help[] = {
 	{ NULL,	"stream-index N",	"specify number of indices into the data (0..3)" },
 	{ NULL,	"stream-l3-size N",	"specify the L3 cache size of the CPU" },
 	{ NULL,	"stream-madvise M",	"specify mmap'd stream buffer madvise advice" },
+	{ NULL,	"stream-method M",	"specify stream kernel store and vector width method" },
 	{ NULL,	"stream-mlock",		"attempt to mlock pages into memory" },
+	{ NULL,	"stream-numa",		"measure NUMA cpu node to memory node bandwidth matrix" },
 	{ NULL, "stream-prefetch",	"use prefetching (where available)" },
 	{ NULL,	"stream-ops N",		"stop after N bogo stream operations" },
 	{ NULL,	NULL,                   NULL }
@@ -1163,6 +1179,666 @@ static int OPTIMIZE3 TARGET_CLONES stress_stream_verify(
 	return EXIT_SUCCESS;
 }
 
+typedef void (*stress_stream_func_t)(
+	double *const RESTRICT a,
+	double *const RESTRICT b,
+	double *const RESTRICT c,
+	const double q,
+	const uint64_t n,
+	double *const RESTRICT rd_bytes,
+	double *const RESTRICT wr_bytes,
+	double *const RESTRICT fp_ops);
+
+/* --stream-method copy, scale, add and triad kernel variants */
+typedef struct {
+	const char *name;		/* method name */
+	const stress_stream_func_t func;	/* kernels, NULL = default or all */
+	bool (*supported)(void);	/* NULL if always supported */
+} stress_stream_method_info_t;
+
+/* Per method rate accounting */
+typedef struct {
+	double dt;			/* time spent in kernels */
+	double rd_bytes;		/* bytes read */
+	double wr_bytes;		/* bytes written */
+} stress_stream_method_stats_t;
+
+/*
+ *  stress_stream_scalar()
+ *	plain C scalar store kernels
+ */
+static void stress_stream_scalar(
+	double *const RESTRICT a,
+	double *const RESTRICT b,
+	double *const RESTRICT c,
+	const double q,
+	const uint64_t n,
+	double *const RESTRICT rd_bytes,
+	double *const RESTRICT wr_bytes,
+	double *const RESTRICT fp_ops)
+{
+	stress_stream_copy_index0(c, a, n, rd_bytes, wr_bytes, fp_ops);
+	stress_stream_scale_index0(b, c, q, n, rd_bytes, wr_bytes, fp_ops);
+	stress_stream_add_index0(c, b, a, n, rd_bytes, wr_bytes, fp_ops);
+	stress_stream_triad_index0(a, b, c, q, n, rd_bytes, wr_bytes, fp_ops);
+}
+
+#if defined(HAVE_NT_STORE_DOUBLE)
+/*
+ *  stress_stream_nt()
+ *	scalar non-temporal store kernels
+ */
+static void stress_stream_nt(
+	double *const RESTRICT a,
+	double *const RESTRICT b,
+	double *const RESTRICT c,
+	const double q,
+	const uint64_t n,
+	double *const RESTRICT rd_bytes,
+	double *const RESTRICT wr_bytes,
+	double *const RESTRICT fp_ops)
+{
+	stress_stream_copy_index0_nt(c, a, n, rd_bytes, wr_bytes, fp_ops);
+	stress_stream_scale_index0_nt(b, c, q, n, rd_bytes, wr_bytes, fp_ops);
+	stress_stream_add_index0_nt(c, b, a, n, rd_bytes, wr_bytes, fp_ops);
+	stress_stream_triad_index0_nt(a, b, c, q, n, rd_bytes, wr_bytes, fp_ops);
+}
+#endif
+
+#if defined(HAVE_VECMATH)
+/*
+ *  256 and 512 bit vectors are built for AVX2 and AVX-512F so they
+ *  run at their full width, other targets would split them into
+ *  narrower vector operations, so they are just for x86
+ */
+#if defined(STRESS_ARCH_X86) &&		\
+    (defined(HAVE_COMPILER_GCC) ||	\
+     defined(HAVE_COMPILER_CLANG) ||	\
+     defined(HAVE_COMPILER_ICX)) &&	\
+    !defined(HAVE_COMPILER_ICC)
+#define TARGET_AVX2		__attribute__ ((target("avx2")))
+#define TARGET_AVX512F		__attribute__ ((target("avx512f")))
+#define HAVE_STREAM_VEC_WIDE
+#endif
+
+typedef double stress_double_w128_t __attribute__ ((vector_size(128 / 8)));
+typedef double stress_double_w256_t __attribute__ ((vector_size(256 / 8)));
+typedef double stress_double_w512_t __attribute__ ((vector_size(512 / 8)));
+
+#define VEC_STORE(dst, src)	*(dst) = src
+
+#if defined(HAVE_NT_STORE128)
+/* non-temporal store of a vector as 128 bit non-temporal stores */
+#define VEC_NT_STORE(dst, src)					\
+do {								\
+	union {							\
+		__typeof__(src) v;				\
+		__uint128_t u[sizeof(src) / sizeof(__uint128_t)]; \
+	} vu_;							\
+	size_t i_;						\
+								\
+	vu_.v = src;						\
+	for (i_ = 0; i_ < SIZEOF_ARRAY(vu_.u); i_++)		\
+		stress_nt_store128((__uint128_t *)(dst) + i_, vu_.u[i_]); \
+} while (0)
+#endif
+
+/*
+ *  Copy, scale, add and triad kernels using vec_t wide vectors, the
+ *  vector width and the target decides which SIMD instructions the
+ *  compiler uses. n is always a multiple of 8 doubles so there is no
+ *  scalar tail to handle.
+ */
+#define STRESS_STREAM_VEC(name, vec_t, vec_store, target)	\
+static void target OPTIMIZE3 name(				\
+	double *const RESTRICT a,				\
+	double *const RESTRICT b,				\
+	double *const RESTRICT c,				\
+	const double q,						\
+	const uint64_t n,					\
+	double *const RESTRICT rd_bytes,			\
+	double *const RESTRICT wr_bytes,			\
+	double *const RESTRICT fp_ops)				\
+{								\
+	vec_t *const RESTRICT va = (vec_t *)a;			\
+	vec_t *const RESTRICT vb = (vec_t *)b;			\
+	vec_t *const RESTRICT vc = (vec_t *)c;			\
+	const uint64_t vn = n / (sizeof(vec_t) / sizeof(double)); \
+	register uint64_t i;					\
+	vec_t vq;						\
+								\
+	for (i = 0; i < sizeof(vec_t) / sizeof(double); i++)	\
+		vq[i] = q;					\
+								\
+	for (i = 0; i < vn; i++)				\
+		vec_store(&vc[i], va[i]);			\
+	for (i = 0; i < vn; i++)				\
+		vec_store(&vb[i], vq * vc[i]);			\
+	for (i = 0; i < vn; i++)				\
+		vec_store(&vc[i], vb[i] + va[i]);		\
+	for (i = 0; i < vn; i++)				\
+		vec_store(&va[i], vb[i] + (vc[i] * vq));	\
+								\
+	*rd_bytes += (double)n * (double)sizeof(double) * 6.0;	\
+	*wr_bytes += (double)n * (double)sizeof(double) * 4.0;	\
+	*fp_ops += (double)n * 4.0;				\
+}
+
+STRESS_STREAM_VEC(stress_stream_vec128, stress_double_w128_t, VEC_STORE, TARGET_CLONES)
+#if defined(HAVE_STREAM_VEC_WIDE)
+STRESS_STREAM_VEC(stress_stream_vec256, stress_double_w256_t, VEC_STORE, TARGET_AVX2)
+STRESS_STREAM_VEC(stress_stream_vec512, stress_double_w512_t, VEC_STORE, TARGET_AVX512F)
+#endif
+#if defined(HAVE_NT_STORE128)
+STRESS_STREAM_VEC(stress_stream_vec128nt, stress_double_w128_t, VEC_NT_STORE, TARGET_CLONES)
+#if defined(HAVE_STREAM_VEC_WIDE)
+STRESS_STREAM_VEC(stress_stream_vec256nt, stress_double_w256_t, VEC_NT_STORE, TARGET_AVX2)
+STRESS_STREAM_VEC(stress_stream_vec512nt, stress_double_w512_t, VEC_NT_STORE, TARGET_AVX512F)
+#endif
+#endif
+#endif
+
+#if defined(HAVE_NT_STORE_DOUBLE) ||	\
+    (defined(HAVE_VECMATH) &&		\
+     defined(HAVE_NT_STORE128))
+/*
+ *  stress_stream_nt_supported()
+ *	non-temporal stores are x86 SSE2 movnti/movntdq, other
+ *	architectures use the compiler's non-temporal store builtin
+ */
+static bool stress_stream_nt_supported(void)
+{
+#if defined(STRESS_ARCH_X86)
+	return stress_cpu_x86_has_sse2();
+#else
+	return true;
+#endif
+}
+#endif
+
+#if defined(HAVE_STREAM_VEC_WIDE)
+/*
+ *  stress_stream_vec256_supported()
+ *	256 bit vector kernels need AVX2
+ */
+static bool stress_stream_vec256_supported(void)
+{
+	return stress_cpu_x86_has_avx2();
+}
+
+/*
+ *  stress_stream_vec512_supported()
+ *	512 bit vector kernels need AVX-512F
+ */
+static bool stress_stream_vec512_supported(void)
+{
+	return stress_cpu_x86_has_avx512_f();
+}
+
+#if defined(HAVE_NT_STORE128)
+/*
+ *  stress_stream_vec256nt_supported()
+ *	256 bit vector non-temporal kernels need AVX2 and SSE2
+ */
+static bool stress_stream_vec256nt_supported(void)
+{
+	return stress_stream_vec256_supported() && stress_stream_nt_supported();
+}
+
+/*
+ *  stress_stream_vec512nt_supported()
+ *	512 bit vector non-temporal kernels need AVX-512F and SSE2
+ */
+static bool stress_stream_vec512nt_supported(void)
+{
+	return stress_stream_vec512_supported() && stress_stream_nt_supported();
+}
+#endif
+#endif
+
+static const stress_stream_method_info_t stream_methods[] = {
+	{ "default",	NULL,				NULL },
+	{ "all",	NULL,				NULL },
+	{ "scalar",	stress_stream_scalar,		NULL },
+#if defined(HAVE_NT_STORE_DOUBLE)
+	{ "nt",		stress_stream_nt,		stress_stream_nt_supported },
+#endif
+#if defined(HAVE_VECMATH)
+	{ "vec128",	stress_stream_vec128,		NULL },
+#if defined(HAVE_STREAM_VEC_WIDE)
+	{ "vec256",	stress_stream_vec256,		stress_stream_vec256_supported },
+	{ "vec512",	stress_stream_vec512,		stress_stream_vec512_supported },
+#endif
+#if defined(HAVE_NT_STORE128)
+	{ "vec128nt",	stress_stream_vec128nt,		stress_stream_nt_supported },
+#if defined(HAVE_STREAM_VEC_WIDE)
+	{ "vec256nt",	stress_stream_vec256nt,		stress_stream_vec256nt_supported },
+	{ "vec512nt",	stress_stream_vec512nt,		stress_stream_vec512nt_supported },
+#endif
+#endif
+#endif
+};
+
+#define STREAM_METHOD_DEFAULT	(0)
+#define STREAM_METHOD_ALL	(1)
+
+/*
+ *  stress_stream_method_supported()
+ *	return true if stream method i can run on this CPU
+ */
+static bool stress_stream_method_supported(const size_t i)
+{
+	return stream_methods[i].func &&
+	       (!stream_methods[i].supported || stream_methods[i].supported());
+}
+
+/*
+ *  stress_stream_method_next()
+ *	find the next supported method after method i for --stream-method all
+ */
+static size_t stress_stream_method_next(const size_t i)
+{
+	size_t j;
+
+	for (j = 1; j <= SIZEOF_ARRAY(stream_methods); j++) {
+		const size_t k = (i + j) % SIZEOF_ARRAY(stream_methods);
+
+		if (stress_stream_method_supported(k))
+			return k;
+	}
+	return STREAM_METHOD_DEFAULT;
+}
+
+/*
+ *  stress_stream_method_exercise()
+ *	run the copy, scale, add and triad kernels of a stream method
+ */
+static void stress_stream_method_exercise(
+	const size_t method,
+	stress_stream_method_stats_t *const RESTRICT stats,
+	double *const RESTRICT dt,
+	double *const RESTRICT a,
+	double *const RESTRICT b,
+	double *const RESTRICT c,
+	double *const RESTRICT rd_bytes,
+	double *const RESTRICT wr_bytes,
+	double *const RESTRICT fp_ops,
+	const double q,
+	const uint64_t n)
+{
+	stress_stream_method_stats_t *const method_stats = &stats[method];
+	double rd = 0.0, wr = 0.0, t1, t2;
+
+	t1 = stress_time_now();
+	stream_methods[method].func(a, b, c, q, n, &rd, &wr, fp_ops);
+	t2 = stress_time_now();
+
+	method_stats->dt += (t2 - t1);
+	method_stats->rd_bytes += rd;
+	method_stats->wr_bytes += wr;
+	(*dt) += (t2 - t1);
+	(*rd_bytes) += rd;
+	(*wr_bytes) += wr;
+}
+
+#if defined(HAVE_STREAM_NUMA)
+/* Per pthread NUMA bandwidth measurement */
+typedef struct {
+	double *a;			/* pthread's chunk of buffer a */
+	double *b;			/* pthread's chunk of buffer b */
+	double *c;			/* pthread's chunk of buffer c */
+	uint64_t n;			/* number of doubles in each chunk */
+	uint32_t cpu;			/* cpu to run on */
+	double bytes;			/* bytes read and written */
+	double duration;		/* time spent exercising memory */
+	pthread_t pthread;		/* pthread handle */
+	int ret;			/* pthread_create return */
+} stress_stream_numa_pthread_t;
+
+/* Accumulated bandwidth of a cpu node, memory node and thread count */
+typedef struct {
+	double gb_rate;			/* sum of GB per second rates */
+	uint32_t count;			/* number of measurements */
+} stress_stream_numa_rate_t;
+
+static volatile bool stream_numa_start;
+static volatile bool stream_numa_stop;
+
+/*
+ *  stress_stream_numa_exercise()
+ *	run copy, scale, add and triad on a pinned cpu until told to stop
+ */
+static void *stress_stream_numa_exercise(void *arg)
+{
+	stress_stream_numa_pthread_t *pt = (stress_stream_numa_pthread_t *)arg;
+	/* q = sqrt(2) - 1 keeps the data stable across rounds */
+	const double q = 0.41421356237309504880;
+	double rd_bytes = 0.0, wr_bytes = 0.0, fp_ops = 0.0;
+	double t1, t2;
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET((int)pt->cpu, &set);
+	(void)sched_setaffinity(0, sizeof(set), &set);
+
+	while (!stream_numa_start && !stream_numa_stop)
+		(void)shim_sched_yield();
+
+	t1 = stress_time_now();
+	while (!stream_numa_stop) {
+		stress_stream_copy_index0(pt->c, pt->a, pt->n, &rd_bytes, &wr_bytes, &fp_ops);
+		stress_stream_scale_index0(pt->b, pt->c, q, pt->n, &rd_bytes, &wr_bytes, &fp_ops);
+		stress_stream_add_index0(pt->c, pt->b, pt->a, pt->n, &rd_bytes, &wr_bytes, &fp_ops);
+		stress_stream_triad_index0(pt->a, pt->b, pt->c, q, pt->n, &rd_bytes, &wr_bytes, &fp_ops);
+	}
+	t2 = stress_time_now();
+
+	pt->bytes = rd_bytes + wr_bytes;
+	pt->duration = t2 - t1;
+
+	return &g_nowt;
+}
+
+/*
+ *  stress_stream_numa_measure()
+ *	measure the memory bandwidth in GB per sec of n_pthreads
+ *	pthreads pinned to cpus, each exercising a chunk of a, b and c
+ */
+static double stress_stream_numa_measure(
+	stress_stream_numa_pthread_t *pthreads,
+	const uint32_t n_pthreads,
+	const uint32_t *cpus,
+	double *a,
+	double *b,
+	double *c,
+	const uint64_t n)
+{
+	const uint64_t chunk = (n / n_pthreads) & ~(uint64_t)7;
+	double gb_rate = 0.0;
+	uint32_t i;
+
+	stream_numa_start = false;
+	stream_numa_stop = false;
+
+	for (i = 0; i < n_pthreads; i++) {
+		stress_stream_numa_pthread_t *pt = &pthreads[i];
+
+		pt->a = a + (i * chunk);
+		pt->b = b + (i * chunk);
+		pt->c = c + (i * chunk);
+		pt->n = chunk;
+		pt->cpu = cpus[i];
+		pt->bytes = 0.0;
+		pt->duration = 0.0;
+		pt->ret = pthread_create(&pt->pthread, NULL, stress_stream_numa_exercise, (void *)pt);
+	}
+	stream_numa_start = true;
+	(void)shim_nanosleep_uint64(STREAM_NUMA_SLICE);
+	stream_numa_stop = true;
+
+	for (i = 0; i < n_pthreads; i++) {
+		stress_stream_numa_pthread_t *pt = &pthreads[i];
+
+		if (pt->ret)
+			continue;
+		VOID_RET(int, pthread_join(pt->pthread, NULL));
+		if (pt->duration > 0.0)
+			gb_rate += (pt->bytes / pt->duration) / (double)GB;
+	}
+	return gb_rate;
+}
+
+/*
+ *  stress_stream_numa_threads()
+ *	number of pthreads for step, 1, 2, 4.. and n_cpus for the last step,
+ *	returns 0 when there are no more steps
+ */
+static uint32_t stress_stream_numa_threads(const uint32_t step, const uint32_t n_cpus)
+{
+	uint32_t n_pthreads;
+
+	if (step >= STREAM_NUMA_STEPS)
+		return 0;
+	n_pthreads = 1U << step;
+	if (n_pthreads < n_cpus)
+		return n_pthreads;
+	/* last step is all the cpus */
+	if ((step == 0) || ((1U << (step - 1)) < n_cpus))
+		return n_cpus;
+	return 0;
+}
+
+/*
+ *  stress_stream_numa()
+ *	measure memory bandwidth from the cpus of each NUMA node to
+ *	the memory of each NUMA node, sweeping the number of pthreads
+ *	per cpu node to find the bandwidth saturation point
+ */
+static int stress_stream_numa(
+	stress_args_t *args,
+	double *a,
+	double *b,
+	double *c,
+	const uint64_t n,
+	const uint64_t sz)
+{
+	stress_numa_mask_t *numa_mask;
+	stress_numa_mask_t *numa_nodes;
+	stress_stream_numa_pthread_t *pthreads = NULL;
+	stress_stream_numa_rate_t *rates = NULL;
+	uint32_t **node_cpus = NULL;
+	uint32_t *node_n_cpus = NULL;
+	long int *cpu_node_ids = NULL;
+	long int *mem_node_ids = NULL;
+	bool *mem_node_ok = NULL;
+	long int node, max_nodes;
+	size_t n_cpu_nodes = 0, n_mem_nodes = 0, i, j;
+	uint32_t max_cpus = 1, step;
+	int rc = EXIT_NO_RESOURCE;
+	char buf[1024];
+
+	numa_mask = stress_numa_mask_alloc();
+	numa_nodes = stress_numa_mask_alloc();
+	if (numa_mask && numa_nodes && (stress_numa_mask_nodes_get(numa_nodes) > 0))
+		max_nodes = numa_nodes->max_nodes;
+	else
+		max_nodes = 1;
+
+	node_cpus = (uint32_t **)calloc((size_t)max_nodes, sizeof(*node_cpus));
+	node_n_cpus = (uint32_t *)calloc((size_t)max_nodes, sizeof(*node_n_cpus));
+	cpu_node_ids = (long int *)calloc((size_t)max_nodes, sizeof(*cpu_node_ids));
+	mem_node_ids = (long int *)calloc((size_t)max_nodes, sizeof(*mem_node_ids));
+	mem_node_ok = (bool *)calloc((size_t)max_nodes, sizeof(*mem_node_ok));
+	if (!node_cpus || !node_n_cpus || !cpu_node_ids || !mem_node_ids || !mem_node_ok) {
+		pr_inf_skip("%s: failed to allocate NUMA node information, skipping stressor\n", args->name);
+		goto free_nodes;
+	}
+
+	for (node = 0; node < max_nodes; node++) {
+		node_n_cpus[node] = stress_numa_node_cpus_get(node, &node_cpus[node]);
+		if (node_n_cpus[node] > 0)
+			cpu_node_ids[n_cpu_nodes++] = node;
+		if ((max_nodes == 1) || STRESS_GETBIT(numa_nodes->mask, node)) {
+			mem_node_ok[n_mem_nodes] = true;
+			mem_node_ids[n_mem_nodes++] = node;
+		}
+	}
+	/* no NUMA cpu information, assume all cpus are on node 0 */
+	if (n_cpu_nodes == 0) {
+		node_n_cpus[0] = stress_affinity_cpus_get(&node_cpus[0], true);
+		if (node_n_cpus[0] == 0) {
+			pr_inf_skip("%s: cannot determine usable cpus, skipping stressor\n", args->name);
+			goto free_nodes;
+		}
+		cpu_node_ids[n_cpu_nodes++] = 0;
+	}
+	for (i = 0; i < n_cpu_nodes; i++) {
+		if (max_cpus < node_n_cpus[cpu_node_ids[i]])
+			max_cpus = node_n_cpus[cpu_node_ids[i]];
+	}
+
+	pthreads = (stress_stream_numa_pthread_t *)calloc((size_t)max_cpus, sizeof(*pthreads));
+	rates = (stress_stream_numa_rate_t *)calloc(n_cpu_nodes * n_mem_nodes * STREAM_NUMA_STEPS, sizeof(*rates));
+	if (!pthreads || !rates) {
+		pr_inf_skip("%s: failed to allocate NUMA bandwidth measurements, skipping stressor\n", args->name);
+		goto free_nodes;
+	}
+
+	pr_inf("%s: measuring bandwidth of %zu cpu node%s to %zu memory node%s, up to %" PRIu32 " pthreads per node\n",
+		args->name, n_cpu_nodes, (n_cpu_nodes == 1) ? "" : "s",
+		n_mem_nodes, (n_mem_nodes == 1) ? "" : "s", max_cpus);
+
+	rc = EXIT_SUCCESS;
+	do {
+		for (j = 0; j < n_mem_nodes; j++) {
+			if (!mem_node_ok[j])
+				continue;
+			/* migrate the buffers to the memory node */
+			if (numa_mask && (n_mem_nodes > 1)) {
+				(void)shim_memset(numa_mask->mask, 0, numa_mask->mask_size);
+				STRESS_SETBIT(numa_mask->mask, mem_node_ids[j]);
+				if ((shim_mbind((void *)a, sz, MPOL_BIND, numa_mask->mask, numa_mask->max_nodes, MPOL_MF_MOVE) < 0) ||
+				    (shim_mbind((void *)b, sz, MPOL_BIND, numa_mask->mask, numa_mask->max_nodes, MPOL_MF_MOVE) < 0) ||
+				    (shim_mbind((void *)c, sz, MPOL_BIND, numa_mask->mask, numa_mask->max_nodes, MPOL_MF_MOVE) < 0)) {
+					pr_inf("%s: cannot move buffers to memory node %ld, errno=%d (%s), skipping memory node\n",
+						args->name, mem_node_ids[j], errno, strerror(errno));
+					mem_node_ok[j] = false;
+					continue;
+				}
+			}
+			stress_stream_init_data(a, b, c, n);
+
+			for (i = 0; i < n_cpu_nodes; i++) {
+				const long int cpu_node = cpu_node_ids[i];
+
+				for (step = 0; ; step++) {
+					const uint32_t n_pthreads = stress_stream_numa_threads(step, node_n_cpus[cpu_node]);
+					stress_stream_numa_rate_t *rate;
+
+					if (!n_pthreads)
+						break;
+					rate = &rates[((i * n_mem_nodes) + j) * STREAM_NUMA_STEPS + step];
+					rate->gb_rate += stress_stream_numa_measure(pthreads, n_pthreads,
+						node_cpus[cpu_node], a, b, c, n);
+					rate->count++;
+					stress_bogo_inc(args);
+					if (UNLIKELY(!stress_continue(args)))
+						goto report;
+				}
+			}
+		}
+	} while (stress_continue(args));
+
+report:
+	{
+		size_t len;
+
+		pr_block_begin();
+		pr_inf("%s: NUMA memory bandwidth in GB per sec, cpu node (rows) to memory node (columns):\n", args->name);
+		len = (size_t)snprintf(buf, sizeof(buf), "%10s", "");
+		for (j = 0; (j < n_mem_nodes) && (len < sizeof(buf)); j++)
+			len += (size_t)snprintf(buf + len, sizeof(buf) - len, " %9s%-3ld", "mem ", mem_node_ids[j]);
+		pr_inf("%s: %s\n", args->name, buf);
+	}
+	for (i = 0; i < n_cpu_nodes; i++) {
+		const long int cpu_node = cpu_node_ids[i];
+		size_t len = (size_t)snprintf(buf, sizeof(buf), "cpu %-6ld", cpu_node);
+		size_t local = 0;
+		double local_peak = 0.0, remote_worst = -1.0;
+		uint32_t saturated = 0;
+		char str[64];
+
+		for (j = 0; j < n_mem_nodes; j++) {
+			double peak = 0.0;
+
+			/* buffers could not be moved to the memory node */
+			if (!mem_node_ok[j]) {
+				if (len < sizeof(buf))
+					len += (size_t)snprintf(buf + len, sizeof(buf) - len, " %12s", "n/a");
+				continue;
+			}
+			/* cell is the peak bandwidth of all the pthread counts */
+			for (step = 0; step < STREAM_NUMA_STEPS; step++) {
+				const stress_stream_numa_rate_t *rate = &rates[((i * n_mem_nodes) + j) * STREAM_NUMA_STEPS + step];
+
+				if ((rate->count > 0) && (peak < rate->gb_rate / (double)rate->count))
+					peak = rate->gb_rate / (double)rate->count;
+			}
+			if (len < sizeof(buf))
+				len += (size_t)snprintf(buf + len, sizeof(buf) - len, " %12.2f", peak);
+			if ((mem_node_ids[j] != cpu_node) && ((remote_worst < 0.0) || (peak < remote_worst)))
+				remote_worst = peak;
+
+			/* local memory node, or the fastest if the cpu node has no memory */
+			if ((mem_node_ids[j] == cpu_node) ||
+			    (((mem_node_ids[local] != cpu_node) || !mem_node_ok[local]) && (peak > local_peak))) {
+				local = j;
+				local_peak = peak;
+			}
+		}
+		pr_inf("%s: %s\n", args->name, buf);
+
+		/* saturation point, fewest pthreads to reach 95% of local peak */
+		len = 0;
+		*buf = '\0';
+		for (step = 0; step < STREAM_NUMA_STEPS; step++) {
+			const stress_stream_numa_rate_t *rate = &rates[((i * n_mem_nodes) + local) * STREAM_NUMA_STEPS + step];
+			const uint32_t n_pthreads = stress_stream_numa_threads(step, node_n_cpus[cpu_node]);
+			double gb_rate;
+
+			if (!n_pthreads || (rate->count == 0))
+				break;
+			gb_rate = rate->gb_rate / (double)rate->count;
+			if ((saturated == 0) && (gb_rate >= local_peak * STREAM_NUMA_SATURATED))
+				saturated = n_pthreads;
+			if (len < sizeof(buf))
+				len += (size_t)snprintf(buf + len, sizeof(buf) - len, "%s%" PRIu32 ": %.2f",
+					len ? ", " : "", n_pthreads, gb_rate);
+		}
+		/*
+		 *  just the local and worst remote bandwidth and the saturation
+		 *  point of the first cpu nodes are metrics, the full matrix
+		 *  is in the table above
+		 */
+		if (i < STREAM_NUMA_METRIC_NODES) {
+			(void)snprintf(str, sizeof(str), "cpu node %ld local GB per sec", cpu_node);
+			stress_metrics_set(args, str, local_peak, STRESS_METRIC_HARMONIC_MEAN);
+			if (remote_worst > 0.0) {
+				(void)snprintf(str, sizeof(str), "cpu node %ld worst remote GB per sec", cpu_node);
+				stress_metrics_set(args, str, remote_worst, STRESS_METRIC_HARMONIC_MEAN);
+			}
+		}
+		if (saturated) {
+			pr_inf("%s: cpu node %ld to mem node %ld GB per sec by pthreads, %s\n",
+				args->name, cpu_node, mem_node_ids[local], buf);
+			pr_inf("%s: cpu node %ld saturates at %" PRIu32 " pthread%s, %.2f GB per sec\n",
+				args->name, cpu_node, saturated, (saturated == 1) ? "" : "s", local_peak);
+			if (i < STREAM_NUMA_METRIC_NODES) {
+				(void)snprintf(str, sizeof(str), "cpu node %ld saturation pthreads", cpu_node);
+				stress_metrics_set(args, str, (double)saturated, STRESS_METRIC_GEOMETRIC_MEAN);
+			}
+		}
+	}
+	pr_block_end();
+
+free_nodes:
+	free(rates);
+	free(pthreads);
+	if (node_cpus) {
+		for (node = 0; node < max_nodes; node++)
+			free(node_cpus[node]);
+	}
+	free(mem_node_ok);
+	free(mem_node_ids);
+	free(cpu_node_ids);
+	free(node_n_cpus);
+	free(node_cpus);
+	stress_numa_mask_nodes_free(numa_mask, numa_nodes);
+
+	return rc;
+}
+#endif
+
 /*
  *  stress_stream()
  *	stress cache/memory/CPU with stream stressors
@@ -1179,7 +1855,6 @@ static int stress_stream(stress_args_t *args)
 	size_t *idx2 = (size_t *)MAP_FAILED;
 	size_t *idx3 = (size_t *)MAP_FAILED;
 	const double q = 3.0;
-	double old_checksum = -1.0;
 	double fp_ops = 0.0;
 	double dt;
 	uint64_t L3;
@@ -1195,8 +1870,14 @@ static int stress_stream(stress_args_t *args)
 	bool guess = false;
 	bool stream_discontiguous = false;
 	bool stream_mlock = false;
+	bool stream_numa = false;
 	bool stream_prefetch = false;
 	bool stats_ok;
+	size_t stream_method = STREAM_METHOD_DEFAULT;
+	size_t method = STREAM_METHOD_DEFAULT;
+	stress_stream_method_stats_t method_stats[SIZEOF_ARRAY(stream_methods)];
+	/* per method checksums, methods may round differently, e.g. fma */
+	double old_checksum[SIZEOF_ARRAY(stream_methods)];
 #if defined(HAVE_NT_STORE_DOUBLE)
 	const bool has_sse2 = stress_cpu_x86_has_sse2();
 #else
@@ -1209,8 +1890,34 @@ static int stress_stream(stress_args_t *args)
 	stress_signal_catch_sigill();
 
 	(void)stress_setting_get("stream-discontiguous", &stream_discontiguous);
+	(void)stress_setting_get("stream-index", &stream_index);
 	(void)stress_setting_get("stream-mlock", &stream_mlock);
+	(void)stress_setting_get("stream-numa", &stream_numa);
 	(void)stress_setting_get("stream-prefetch", &stream_prefetch);
+	(void)stress_setting_get("stream-method", &stream_method);
+
+	(void)shim_memset(method_stats, 0, sizeof(method_stats));
+	for (method = 0; method < SIZEOF_ARRAY(old_checksum); method++)
+		old_checksum[method] = -1.0;
+	method = STREAM_METHOD_DEFAULT;
+	if (stream_method == STREAM_METHOD_ALL) {
+		method = stress_stream_method_next(STREAM_METHOD_ALL);
+	} else if (stream_method != STREAM_METHOD_DEFAULT) {
+		if (stress_stream_method_supported(stream_method)) {
+			method = stream_method;
+		} else {
+			if (stress_instance_zero(args))
+				pr_inf("%s: stream method '%s' not supported by this CPU, using default method\n",
+					args->name, stream_methods[stream_method].name);
+			stream_method = STREAM_METHOD_DEFAULT;
+		}
+	}
+	if ((stream_method != STREAM_METHOD_DEFAULT) && (stream_index || stream_prefetch)) {
+		if (stress_instance_zero(args))
+			pr_inf("%s: --stream-index and --stream-prefetch are ignored for stream method '%s'\n",
+				args->name, stream_methods[stream_method].name);
+		stream_index = 0;
+	}
 
 #if !defined(HAVE_PRAGMA_PREFETCH)
 	if (stream_prefetch) {
@@ -1224,8 +1931,6 @@ static int stress_stream(stress_args_t *args)
 	else
 		L3 = get_stream_L3_size(args);
 
-	(void)stress_setting_get("stream-index", &stream_index);
-
 	/* Have to take a hunch and badly guess size */
 	if (!L3) {
 		guess = true;
@@ -1247,8 +1952,35 @@ static int stress_stream(stress_args_t *args)
 			"to the STREAM benchmark results\n", args->name);
 	}
 
-	/* ..and shared amongst all the STREAM stressor instances */
-	L3 /= args->instances;
+#if defined(HAVE_STREAM_NUMA)
+	if (stream_numa) {
+		/*
+		 *  Other instances would load the memory nodes and skew
+		 *  the bandwidth matrix, so just instance 0 measures it
+		 */
+		if (!stress_instance_zero(args)) {
+			pr_dbg("%s: --stream-numa only runs on instance 0, instance %" PRIu32 " is idle\n",
+				args->name, args->instance);
+			stress_proc_state_set(args->name, STRESS_STATE_SYNC_WAIT);
+			stress_sync_start_wait(args);
+			stress_proc_state_set(args->name, STRESS_STATE_RUN);
+			/* Wait for termination */
+			while (stress_continue(args))
+				(void)shim_pause();
+			stress_proc_state_set(args->name, STRESS_STATE_DEINIT);
+			return EXIT_SUCCESS;
+		}
+		if (args->instances > 1)
+			pr_inf("%s: --stream-numa only runs on instance 0, the other instances are idle\n",
+				args->name);
+		/* each buffer is 4 times the cache size so it is not cached */
+		L3 *= 4;
+	} else
+#endif
+	{
+		/* ..and shared amongst all the STREAM stressor instances */
+		L3 /= args->instances;
+	}
 	if (L3 < args->page_size)
 		L3 = args->page_size;
 
@@ -1316,6 +2048,17 @@ case_stream_index_1:
 		stress_mmap_discontiguous(c, sz);
 	}
 
+	if (stream_numa) {
+#if defined(HAVE_STREAM_NUMA)
+		rc = stress_stream_numa(args, a, b, c, n, sz);
+		goto err_unmap;
+#else
+		if (stress_instance_zero(args))
+			pr_inf("%s: --stream-numa is not supported, using default stream operations\n",
+				args->name);
+#endif
+	}
+
 	rc = EXIT_SUCCESS;
 	dt = 0.0;
 	do {
@@ -1327,14 +2070,21 @@ case_stream_index_1:
 		if (init_counter >= init_counter_max)
 			init_counter = 0;
 
-		stress_stream_exercise(&dt, a, b, c, idx1, idx2, idx3,
-				       &rd_bytes, &wr_bytes, &fp_ops,
-				       q, n, stream_index, has_sse2, stream_prefetch);
+		if (method == STREAM_METHOD_DEFAULT) {
+			stress_stream_exercise(&dt, a, b, c, idx1, idx2, idx3,
+					       &rd_bytes, &wr_bytes, &fp_ops,
+					       q, n, stream_index, has_sse2, stream_prefetch);
+		} else {
+			stress_stream_method_exercise(method, method_stats, &dt, a, b, c,
+						      &rd_bytes, &wr_bytes, &fp_ops, q, n);
+		}
 		if (verify) {
-			rc = stress_stream_verify(args, &old_checksum, a, b, c, n);
+			rc = stress_stream_verify(args, &old_checksum[method], a, b, c, n);
 			if (rc != EXIT_SUCCESS)
 				break;
 		}
+		if (stream_method == STREAM_METHOD_ALL)
+			method = stress_stream_method_next(method);
 		stress_bogo_inc(args);
 	} while (stress_continue(args));
 
@@ -1357,6 +2107,24 @@ case_stream_index_1:
 			pr_inf("%s: run duration too short to reliably determine memory rate\n", args->name);
 	}
 
+	/* per method read + write rates */
+	for (method = 0; method < SIZEOF_ARRAY(stream_methods); method++) {
+		const stress_stream_method_stats_t *ms = &method_stats[method];
+		char str[64];
+		double mb_rate;
+
+		if (ms->dt <= 0.0)
+			continue;
+		mb_rate = ((ms->rd_bytes + ms->wr_bytes) / (double)MB) / ms->dt;
+		if (stress_instance_zero(args))
+			pr_inf("%s: %-8s memory rate: %.2f MB read/sec, %.2f MB write/sec\n",
+				args->name, stream_methods[method].name,
+				(ms->rd_bytes / (double)MB) / ms->dt,
+				(ms->wr_bytes / (double)MB) / ms->dt);
+		(void)snprintf(str, sizeof(str), "MB per sec %s read+write rate", stream_methods[method].name);
+		stress_metrics_set(args, str, mb_rate, STRESS_METRIC_HARMONIC_MEAN);
+	}
+
 	stats_ok = true;
 	stress_mmap_stats_clear(&stats_total);
 
@@ -1407,12 +2175,19 @@ static const char *stress_stream_madvise(const size_t i)
 	return (i < SIZEOF_ARRAY(stream_madvise_info)) ? stream_madvise_info[i].name : NULL;
 }
 
+static const char *stress_stream_method(const size_t i)
+{
+	return (i < SIZEOF_ARRAY(stream_methods)) ? stream_methods[i].name : NULL;
+}
+
 static const stress_opt_t opts[] = {
 	{ OPT_stream_discontiguous, "stream-discontiguous", TYPE_ID_BOOL, 0, 1, NULL },
 	{ OPT_stream_index,         "stream-index",         TYPE_ID_UINT32, 0, 3, NULL },
 	{ OPT_stream_l3_size,       "stream-l3-size",       TYPE_ID_UINT64_BYTES_VM, MIN_STREAM_L3_SIZE, MAX_STREAM_L3_SIZE, NULL },
 	{ OPT_stream_madvise,       "stream-madvise",       TYPE_ID_SIZE_T_METHOD, 0, 0, stress_stream_madvise },
+	{ OPT_stream_method,        "stream-method",        TYPE_ID_SIZE_T_METHOD, 0, 0, stress_stream_method },
 	{ OPT_stream_mlock,         "stream-mlock",         TYPE_ID_BOOL, 0, 1, NULL },
+	{ OPT_stream_numa,          "stream-numa",          TYPE_ID_BOOL, 0, 1, NULL },
 	{ OPT_stream_prefetch,      "stream-prefetch",      TYPE_ID_BOOL, 0, 1, NULL },
 	END_OPT,
 };
@@ -1437,5 +2212,6 @@ const stressor_info_t stress_stream_info = {
 	.opts = opts,
 	.verify = VERIFY_OPTIONAL,
 	.help = help,
+	.max_metrics_items = STRESS_MAXIMUM(3 + SIZEOF_ARRAY(stream_methods), STREAM_NUMA_METRICS),
 	.exercises = exercises,
 };
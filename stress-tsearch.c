@@ -83,7 +83,7 @@ static int stress_tsearch(stress_args_t *args)
 		double t;
 		void *root = NULL;
 
-		stress_sort_data_int32_shuffle(data, n);
+		stress_sort_data_int32(data, n, STRESS_SORT_DATA_UNIQUE);
 
 		/* Step #1, populate tree */
 		for (i = 0; i < n; i++) {
@@ -262,17 +262,9 @@ static void stress_rand_data_binary(
 	uint64_t *RESTRICT data,
 	uint64_t *RESTRICT data_end)
 {
-	register uint32_t *ptr = (uint32_t *)data;
-	register const uint32_t *end = (uint32_t *)data_end;
-
 	(void)args;
 
-	while (ptr < end) {
-		*(ptr++) = stress_mwc32();
-		*(ptr++) = stress_mwc32();
-		*(ptr++) = stress_mwc32();
-		*(ptr++) = stress_mwc32();
-	}
+	stress_mwc_fill(data, (size_t)((uintptr_t)data_end - (uintptr_t)data));
 }
 
 /*
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2021-2026 Colin Ian King
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include <stdint.h>
+#include <arm_acle.h>
+
+static uint32_t __attribute__((target("+crc"))) crc32c(uint32_t crc, const uint64_t *data)
+{
+	crc = __crc32cd(crc, data[0]);
+	crc = __crc32cd(crc, data[1]);
+	crc = __crc32cb(crc, (uint8_t)data[2]);
+
+	return crc;
+}
+
+int main(int argc, char **argv)
+{
+	uint64_t data[3] = { 0x123456789abcdefULL, 0xfedcba9876543210ULL, 0x55 };
+
+	(void)argc;
+	(void)argv;
+
+	return (int)crc32c(~0U, data);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 Colin Ian King
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__x86_64) || \
+    defined(__amd64__)  || defined(__amd64)
+
+static inline void repcopy(void *dst, const void *src, size_t n)
+{
+	__asm__ __volatile__(
+		"rep movsb\n"
+		: "+D" (dst),
+		  "+S" (src),
+		  "+c" (n)
+		:
+		: "memory");
+}
+
+int main(void)
+{
+	char src[1024], dst[1024];
+
+	(void)memset(src, 0, sizeof(src));
+	repcopy(dst, src, sizeof(dst));
+
+	return dst[0];
+}
+#else
+#error not an x86 so no rep movsb instruction
+#endif